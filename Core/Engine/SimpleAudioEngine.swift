@@ -8,6 +8,9 @@ import Speech
 @_silgen_name("whisper_bridge_init_context")
 func whisper_bridge_init_context(_ model_path: UnsafePointer<CChar>) -> OpaquePointer?
 
+@_silgen_name("whisper_bridge_init_context_with_hugepages")
+func whisper_bridge_init_context_with_hugepages(_ model_path: UnsafePointer<CChar>, _ hugepage_mode: Int32, _ out_advised_mb: UnsafeMutablePointer<Double>?, _ out_hugepage_mb: UnsafeMutablePointer<Double>?) -> OpaquePointer?
+
 @_silgen_name("whisper_bridge_free_context") 
 func whisper_bridge_free_context(_ ctx: OpaquePointer)
 
@@ -17,6 +20,60 @@ func whisper_bridge_transcribe(_ ctx: OpaquePointer, _ samples: UnsafePointer<Fl
 @_silgen_name("whisper_bridge_transcribe_with_language")
 func whisper_bridge_transcribe_with_language(_ ctx: OpaquePointer, _ samples: UnsafePointer<Float>, _ n_samples: Int32, _ language: UnsafePointer<CChar>) -> UnsafePointer<CChar>?
 
+@_silgen_name("whisper_bridge_get_model_ftype")
+func whisper_bridge_get_model_ftype(_ ctx: OpaquePointer) -> Int32
+
+@_silgen_name("whisper_bridge_detect_cpu_topology")
+func whisper_bridge_detect_cpu_topology(_ out_logical_cpus: UnsafeMutablePointer<Int32>, _ out_performance_cpus: UnsafeMutablePointer<Int32>, _ out_efficiency_cpus: UnsafeMutablePointer<Int32>, _ out_performance_mask: UnsafeMutablePointer<UInt64>) -> Int32
+
+@_silgen_name("whisper_bridge_configure_workers")
+func whisper_bridge_configure_workers(_ n_threads: Int32, _ core_mask: UInt64, _ nice_level: Int32, _ qos: Int32, _ reserved_core: Int32)
+
+@_silgen_name("whisper_bridge_pin_current_thread_to_core")
+func whisper_bridge_pin_current_thread_to_core(_ core: Int32) -> Int32
+
+@_silgen_name("whisper_bridge_chunk_controller_create")
+func whisper_bridge_chunk_controller_create(_ min_chunk_seconds: Float, _ max_chunk_seconds: Float, _ initial_chunk_seconds: Float, _ min_overlap_seconds: Float, _ max_overlap_seconds: Float, _ target_rtf: Float) -> OpaquePointer?
+
+@_silgen_name("whisper_bridge_chunk_controller_free")
+func whisper_bridge_chunk_controller_free(_ controller: OpaquePointer)
+
+@_silgen_name("whisper_bridge_chunk_controller_chunk_queued")
+func whisper_bridge_chunk_controller_chunk_queued(_ controller: OpaquePointer)
+
+@_silgen_name("whisper_bridge_chunk_controller_chunk_dropped")
+func whisper_bridge_chunk_controller_chunk_dropped(_ controller: OpaquePointer)
+
+@_silgen_name("whisper_bridge_chunk_controller_record")
+func whisper_bridge_chunk_controller_record(_ controller: OpaquePointer, _ audio_seconds: Float, _ decode_seconds: Float)
+
+@_silgen_name("whisper_bridge_chunk_controller_chunk_seconds")
+func whisper_bridge_chunk_controller_chunk_seconds(_ controller: OpaquePointer) -> Float
+
+@_silgen_name("whisper_bridge_stream_create")
+func whisper_bridge_stream_create(_ agreement_n: Int32, _ max_window_seconds: Float) -> OpaquePointer?
+
+@_silgen_name("whisper_bridge_stream_free")
+func whisper_bridge_stream_free(_ stream: OpaquePointer)
+
+@_silgen_name("whisper_bridge_stream_reset")
+func whisper_bridge_stream_reset(_ stream: OpaquePointer)
+
+@_silgen_name("whisper_bridge_stream_push_audio")
+func whisper_bridge_stream_push_audio(_ stream: OpaquePointer, _ samples: UnsafePointer<Float>, _ n_samples: Int32) -> Int32
+
+@_silgen_name("whisper_bridge_stream_decode")
+func whisper_bridge_stream_decode(_ ctx: OpaquePointer, _ stream: OpaquePointer, _ language: UnsafePointer<CChar>, _ out_committed_text: UnsafeMutablePointer<UnsafeMutablePointer<CChar>?>, _ out_tentative_text: UnsafeMutablePointer<UnsafeMutablePointer<CChar>?>) -> Int32
+
+@_silgen_name("whisper_bridge_stream_flush")
+func whisper_bridge_stream_flush(_ ctx: OpaquePointer, _ stream: OpaquePointer, _ out_committed_text: UnsafeMutablePointer<UnsafeMutablePointer<CChar>?>) -> Int32
+
+@_silgen_name("whisper_bridge_free_text")
+func whisper_bridge_free_text(_ text: UnsafeMutablePointer<CChar>?)
+
+@_silgen_name("whisper_bridge_calibrate_model")
+func whisper_bridge_calibrate_model(_ model_path: UnsafePointer<CChar>, _ samples: UnsafePointer<Float>, _ n_samples: Int32, _ language: UnsafePointer<CChar>, _ reference_text: UnsafePointer<CChar>?, _ hugepage_mode: Int32, _ out_rtf: UnsafeMutablePointer<Float>, _ out_peak_memory_mb: UnsafeMutablePointer<Double>, _ out_wer: UnsafeMutablePointer<Float>, _ out_ftype: UnsafeMutablePointer<Int32>, _ out_hugepage_mb: UnsafeMutablePointer<Double>) -> Int32
+
 /**
  * SimpleAudioEngine - Clean replacement for AudioEngine
  * 
@@ -37,6 +94,10 @@ actor SimpleAudioEngine {
     // Whisper Integration
     nonisolated(unsafe) private var context: OpaquePointer?
     
+    // v1.2.0 ENHANCEMENT: Core kept free of Whisper workers for the tap thread (-1 until Whisper is set up)
+    nonisolated(unsafe) private var captureCore: Int32 = -1
+    nonisolated(unsafe) private var pinnedCaptureThread: pthread_t?
+    
     // Apple Speech Integration  
     private var speechRecognizer: SFSpeechRecognizer?
     private var recognitionRequest: SFSpeechAudioBufferRecognitionRequest?
@@ -90,6 +151,20 @@ actor SimpleAudioEngine {
     // STEREO MODE: Buffer size for independent L/R processing
     private let stereoBufferSize = 56000  // ~3.5 seconds at 16kHz (FORCED TO 56000 - MUST NOT BE 32000!)
     
+    // v1.2.0 ENHANCEMENT: Per-stream chunk length adapted to measured real-time factor
+    // Chunks start at the fixed sizes above and shrink on fast machines / grow when decoding falls behind.
+    // Overlap stays at 0: every agreement stream re-decodes its uncommitted tail itself (see monoStream).
+    nonisolated(unsafe) private var monoChunkController = whisper_bridge_chunk_controller_create(1.5, 6.0, 3.0, 0.0, 0.0, 0.5)
+    nonisolated(unsafe) private var leftChunkController = whisper_bridge_chunk_controller_create(2.0, 7.0, 3.5, 0.0, 0.0, 0.5)
+    nonisolated(unsafe) private var rightChunkController = whisper_bridge_chunk_controller_create(2.0, 7.0, 3.5, 0.0, 0.0, 0.5)
+    
+    // v1.2.0 ENHANCEMENT: Mono stream stabilized with LocalAgreement-2 in the bridge
+    // Only tokens two consecutive decodes agree on are emitted; the tentative tail is re-decoded with new audio.
+    nonisolated(unsafe) private var monoStream = whisper_bridge_stream_create(2, 15.0)
+    // Stereo and goobero channels get their own streams; only one of the two modes is active at a time.
+    nonisolated(unsafe) private var leftStream = whisper_bridge_stream_create(2, 15.0)
+    nonisolated(unsafe) private var rightStream = whisper_bridge_stream_create(2, 15.0)
+    
     nonisolated(unsafe) private var passthroughVolume: Float = 1.0
     nonisolated(unsafe) private var passthroughMixer: AVAudioMixerNode? // Store goobero passthrough mixer for volume control
     
@@ -1025,6 +1100,11 @@ actor SimpleAudioEngine {
         if let context = self.context {
             await withCheckedContinuation { continuation in
                 whisperQueue.async {
+                    for stream in [self.monoStream, self.leftStream, self.rightStream] {
+                        if let stream = stream {
+                            whisper_bridge_stream_reset(stream)
+                        }
+                    }
                     whisper_bridge_free_context(context)
                     continuation.resume()
                 }
@@ -1041,6 +1121,17 @@ actor SimpleAudioEngine {
     // MARK: - Configuration Methods (UI Interface)
     
     func setAudioMode(_ mode: AudioMode) {
+        if mode != audioMode {
+            // Stereo and goobero share the channel streams: drop the other mode's uncommitted window
+            whisperQueue.async { [weak self] in
+                guard let self = self else { return }
+                for stream in [self.leftStream, self.rightStream] {
+                    if let stream = stream {
+                        whisper_bridge_stream_reset(stream)
+                    }
+                }
+            }
+        }
         audioMode = mode
         print("🎤 Audio mode: \(mode.rawValue)")
     }
@@ -1414,14 +1505,36 @@ actor SimpleAudioEngine {
             return
         }
         
-        debugPrint("🔧 Initializing Whisper context with model: \(modelPath)", source: "SimpleAudioEngine")
+        let hugePageMode = await modelManager.hugePageMode
+        debugPrint("🔧 Initializing Whisper context with model: \(modelPath) (huge page mode \(hugePageMode))", source: "SimpleAudioEngine")
+        
+        // v1.2.0 ENHANCEMENT: Keep inference workers on performance cores to stabilize chunk latency
+        var logicalCPUs: Int32 = 0
+        var performanceCPUs: Int32 = 0
+        var efficiencyCPUs: Int32 = 0
+        var performanceMask: UInt64 = 0
+        _ = whisper_bridge_detect_cpu_topology(&logicalCPUs, &performanceCPUs, &efficiencyCPUs, &performanceMask)
+        debugPrint("🧠 CPU topology: \(logicalCPUs) logical, \(performanceCPUs) performance, \(efficiencyCPUs) efficiency", source: "SimpleAudioEngine")
+        
+        // One performance core stays free for the audio capture thread: the last one in the
+        // detected mask (Linux), or just one fewer worker where cores cannot be addressed (macOS)
+        let reservedCore = performanceMask != 0 ? Int32(63 - performanceMask.leadingZeroBitCount) : max(0, performanceCPUs - 1)
+        let workerThreads = max(1, min(Int32(8), performanceCPUs - 1))
+        whisper_bridge_configure_workers(workerThreads, 0, 0, 1, reservedCore)
+        captureCore = reservedCore
         
         // CRITICAL FIX: Initialize Whisper context on the dedicated thread
         await withCheckedContinuation { continuation in
             whisperQueue.async { [weak self] in
-                self?.context = whisper_bridge_init_context(modelPath)
-                if self?.context != nil {
-                    debugPrint("✅ Whisper initialized successfully on dedicated thread", source: "SimpleAudioEngine")
+                var advisedMB: Double = 0
+                var hugePageMB: Double = 0
+                self?.context = whisper_bridge_init_context_with_hugepages(modelPath, hugePageMode, &advisedMB, &hugePageMB)
+                if let context = self?.context {
+                    let quantization = WhisperQuantization(ftype: whisper_bridge_get_model_ftype(context))
+                    debugPrint("✅ Whisper initialized successfully on dedicated thread (\(quantization.rawValue) weights)", source: "SimpleAudioEngine")
+                    if hugePageMode != 0 {
+                        debugPrint("📄 Huge pages: \(String(format: "%.0f", hugePageMB)) of \(String(format: "%.0f", advisedMB)) MB backed", source: "SimpleAudioEngine")
+                    }
                 } else {
                     debugPrint("❌ Whisper initialization failed", source: "SimpleAudioEngine")
                 }
@@ -1541,28 +1654,29 @@ actor SimpleAudioEngine {
             bufferQueue.sync {
             // Add new samples to post-context buffer (future audio)
             postContextBuffer.append(contentsOf: samples)
+            let monoChunkSize = chunkSamples(monoChunkController, fallback: contextWindowSize)
             
             // Debug: Log buffer accumulation
             let totalSamples = preContextBuffer.count + actualBuffer.count + postContextBuffer.count
-            if totalSamples % (contextWindowSize / 4) == 0 { // Every 0.75s
+            if totalSamples % (monoChunkSize / 4) == 0 { // Every quarter chunk
                 Task {
                     await DebugLogger.audio("🔄 Rolling buffers: pre(\(preContextBuffer.count)) + actual(\(actualBuffer.count)) + post(\(postContextBuffer.count)) = \(totalSamples)", source: "SimpleAudioEngine")
                 }
             }
             
-            // v1.0.8 ENHANCEMENT: Process when post-context buffer reaches 3 seconds
+            // v1.0.8 ENHANCEMENT: Process when post-context buffer holds a full chunk
             let currentTime = Date()
             
-            if postContextBuffer.count >= contextWindowSize {
-                // v1.0.8 ENHANCEMENT: Always process exactly 3 seconds for consistency
-                let samplesForProcessing = Array(postContextBuffer.prefix(contextWindowSize))
+            if postContextBuffer.count >= monoChunkSize {
+                // v1.0.8 ENHANCEMENT: Process exactly one chunk; its size follows the chunk controller
+                let samplesForProcessing = Array(postContextBuffer.prefix(monoChunkSize))
                 
-                // Perform VAD analysis on the 3-second block
+                // Perform VAD analysis on the chunk
                 let vadDecision = self.performAdvancedVAD(samples: samplesForProcessing)
                 let speechBoundaryDetected = self.detectSpeechBoundary(vadDecision: vadDecision, currentTime: currentTime)
                 
                 // v1.0.8 ENHANCEMENT: Simplified quality check for rolling window
-                let hasMinimumDuration = samplesForProcessing.count >= contextWindowSize // Always true for 3s blocks
+                let hasMinimumDuration = samplesForProcessing.count >= monoChunkSize // Always true for full chunks
                 let rateLimitOk = lastProcessingTime.map { 
                     currentTime.timeIntervalSince($0) >= minimumProcessingInterval 
                 } ?? true
@@ -1576,7 +1690,7 @@ actor SimpleAudioEngine {
                 
                 if shouldProcess {
                     // v1.0.8 ENHANCEMENT: Create 9-second context window for transcription
-                    // Simple processing for now - use the 3.5s buffer as-is
+                    // Simple processing for now - use the chunk as-is
                     let fullContextSamples = samplesForProcessing
                     
                     // Simple buffer processing (placeholder)
@@ -1585,11 +1699,18 @@ actor SimpleAudioEngine {
                     lastProcessedTimestamp = currentTime
                     lastProcessingTime = currentTime
                     
+                    // Consume the chunk so the next one starts with fresh audio
+                    postContextBuffer.removeFirst(monoChunkSize)
+                    if let controller = monoChunkController {
+                        whisper_bridge_chunk_controller_chunk_queued(controller)
+                    }
+                    
                     // FIXED: Complete Whisper processing implementation
                     whisperQueue.async { [weak self] in
-                        guard let self = self,
-                              let context = self.context else {
+                        guard let self = self else { return }
+                        guard let context = self.context else {
                             debugPrint("❌ Whisper context not available", source: "SimpleAudioEngine")
+                            self.dropChunk(self.monoChunkController)
                             return
                         }
                         
@@ -1599,40 +1720,50 @@ actor SimpleAudioEngine {
                         let processedSamples = self.applyAudioModeProcessing(to: fullContextSamples)
                         
                         // Call Whisper API with language
-                        let result = whisper_bridge_transcribe_with_language(
-                            context,
-                            processedSamples,
-                            Int32(processedSamples.count),
-                            self.monoLanguage
+                        let committedText = self.decodeWithStream(
+                            self.monoStream,
+                            context: context,
+                            samples: processedSamples,
+                            language: self.monoLanguage,
+                            controller: self.monoChunkController
                         )
                         
                         // Process result and callback
-                        if let result = result,
-                           let text = String(cString: result, encoding: .utf8),
-                           !text.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines).isEmpty {
-                            
-                            debugPrint("✅ Whisper result: \(text)", source: "SimpleAudioEngine")
-                            
-                            // Call transcription callback on MainActor
-                            Task { @MainActor in
-                                self.transcriptionCallback?(text)
-                            }
-                        } else {
-                            debugPrint("⚠️ Whisper returned empty result", source: "SimpleAudioEngine")
-                        }
+                        self.emitMonoText(committedText)
                     }
                 } else {
                     // v1.0.8 CRITICAL: Always consume the buffer to prevent infinite loops
                     // Even if we don't process, we need to shift the buffer to prevent repetition
-                    if postContextBuffer.count >= contextWindowSize {
-                        let consumedSamples = Array(postContextBuffer.prefix(contextWindowSize))
+                    if postContextBuffer.count >= monoChunkSize {
+                        let consumedSamples = Array(postContextBuffer.prefix(monoChunkSize))
                         // CRITICAL FIX: Actually remove consumed samples from buffer
-                        postContextBuffer.removeFirst(contextWindowSize)
+                        postContextBuffer.removeFirst(monoChunkSize)
                         debugPrint("🔄 Buffer consumed: \(consumedSamples.count) samples, remaining: \(postContextBuffer.count)", source: "SimpleAudioEngine")
                         
                         Task {
                             await DebugLogger.audio("🚫 Skipped processing but consumed \(consumedSamples.count) samples to prevent repetition", source: "SimpleAudioEngine")
                         }
+                        
+                        if !vadDecision {
+                            // Speech ended: finalize whatever the stream still holds as tentative
+                            whisperQueue.async { [weak self] in
+                                guard let self = self,
+                                      let context = self.context,
+                                      let stream = self.monoStream else { return }
+                                var committed: UnsafeMutablePointer<CChar>? = nil
+                                if whisper_bridge_stream_flush(context, stream, &committed) > 0 {
+                                    self.emitMonoText(committed.map { String(cString: $0) })
+                                }
+                                whisper_bridge_free_text(committed)
+                            }
+                        } else {
+                            // Speech dropped by the rate limit: the next chunk is not adjacent to the window
+                            whisperQueue.async { [weak self] in
+                                guard let self = self,
+                                      let stream = self.monoStream else { return }
+                                whisper_bridge_stream_reset(stream)
+                            }
+                        }
                     }
                 }
             }
@@ -1645,6 +1776,118 @@ actor SimpleAudioEngine {
         }
     }
     
+    nonisolated private func emitMonoText(_ text: String?) {
+        guard let text = text,
+              !text.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines).isEmpty else {
+            debugPrint("⚠️ Whisper returned empty result", source: "SimpleAudioEngine")
+            return
+        }
+        
+        debugPrint("✅ Whisper result: \(text)", source: "SimpleAudioEngine")
+        
+        // Call transcription callback on MainActor
+        Task { @MainActor in
+            self.transcriptionCallback?(text)
+        }
+    }
+    
+    // MARK: - Adaptive Chunk Length
+    
+    nonisolated private func chunkSamples(_ controller: OpaquePointer?, fallback: Int) -> Int {
+        guard let controller = controller else { return fallback }
+        return Int(whisper_bridge_chunk_controller_chunk_seconds(controller) * 16000)
+    }
+    
+    /// A queued chunk that will not be decoded: give its slot back so the queue depth stays honest.
+    nonisolated private func dropChunk(_ controller: OpaquePointer?) {
+        guard let controller = controller else { return }
+        whisper_bridge_chunk_controller_chunk_dropped(controller)
+    }
+    
+    nonisolated private func recordChunk(_ controller: OpaquePointer?, samples: Int, since decodeStart: Date) {
+        guard let controller = controller else { return }
+        let decodeSeconds = Float(Date().timeIntervalSince(decodeStart))
+        whisper_bridge_chunk_controller_record(controller, Float(samples) / 16000, decodeSeconds)
+    }
+    
+    // MARK: - LocalAgreement Streams
+    
+    /// Pushes a chunk into an agreement stream and decodes its window (must run on whisperQueue).
+    /// Returns the newly committed text. Without a stream the chunk is transcribed on its own.
+    nonisolated private func decodeWithStream(_ stream: OpaquePointer?, context: OpaquePointer, samples: [Float],
+                                              language: String, controller: OpaquePointer?) -> String? {
+        guard let stream = stream else {
+            let decodeStart = Date()
+            let result = whisper_bridge_transcribe_with_language(context, samples, Int32(samples.count), language)
+            recordChunk(controller, samples: samples.count, since: decodeStart)
+            return result.flatMap { String(cString: $0, encoding: .utf8) }
+        }
+        
+        _ = whisper_bridge_stream_push_audio(stream, samples, Int32(samples.count))
+        let decodeStart = Date()
+        var committed: UnsafeMutablePointer<CChar>? = nil
+        var tentative: UnsafeMutablePointer<CChar>? = nil
+        _ = whisper_bridge_stream_decode(context, stream, language, &committed, &tentative)
+        // The decode re-reads the whole uncommitted window, but only this chunk is new audio: measured
+        // against it, the RTF is the load per second of input the controller (overlap 0) has to keep up with
+        recordChunk(controller, samples: samples.count, since: decodeStart)
+        
+        let committedText = committed.map { String(cString: $0) }
+        if let tentative = tentative {
+            debugPrint("⏳ Tentative: \(String(cString: tentative))", source: "SimpleAudioEngine")
+        }
+        whisper_bridge_free_text(committed)
+        whisper_bridge_free_text(tentative)
+        return committedText
+    }
+    
+    nonisolated private func channelStream(_ channel: String) -> OpaquePointer? {
+        return channel == "left" ? leftStream : rightStream
+    }
+    
+    /// Speech was dropped on a channel: start its stream over rather than joining non-adjacent audio.
+    nonisolated private func resetChannelStream(_ channel: String) {
+        whisperQueue.async { [weak self] in
+            guard let self = self,
+                  let stream = self.channelStream(channel) else { return }
+            whisper_bridge_stream_reset(stream)
+        }
+    }
+    
+    /// Speech ended on a channel: finalize whatever its stream still holds as tentative.
+    nonisolated private func flushChannelStream(_ channel: String) {
+        whisperQueue.async { [weak self] in
+            guard let self = self,
+                  let context = self.context,
+                  let stream = self.channelStream(channel) else { return }
+            var committed: UnsafeMutablePointer<CChar>? = nil
+            if whisper_bridge_stream_flush(context, stream, &committed) > 0 {
+                self.emitChannelText(committed.map { String(cString: $0) }, channel: channel)
+            }
+            whisper_bridge_free_text(committed)
+        }
+    }
+    
+    nonisolated private func emitChannelText(_ text: String?, channel: String) {
+        guard let text = text?.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines),
+              !text.isEmpty else {
+            debugPrint("⚠️ \(channel.capitalized) channel returned empty result", source: "SimpleAudioEngine")
+            return
+        }
+        
+        let speakerName = channel == "left" ? leftSpeakerName : rightSpeakerName
+        let taggedText = "[\(speakerName)]: \(text)"
+        debugPrint("✅ \(channel.capitalized) channel result: \(taggedText)", source: "SimpleAudioEngine")
+        
+        Task { @MainActor in
+            if channel == "left" {
+                leftChannelCallback?(taggedText)
+            } else {
+                rightChannelCallback?(taggedText)
+            }
+        }
+    }
+    
     // MARK: - Goobero Channel Processing (Clean Implementation)
     
     private func processGooberoChannels(buffer: AVAudioPCMBuffer, targetFormat: AVAudioFormat) async {
@@ -1671,6 +1914,9 @@ actor SimpleAudioEngine {
         
         // PHASE 1 FIX: Use buffer accumulation like stereo mode (3.5 seconds)
         bufferQueue.sync {
+            let leftChunkSize = chunkSamples(leftChunkController, fallback: stereoBufferSize)
+            let rightChunkSize = chunkSamples(rightChunkController, fallback: stereoBufferSize)
+            
             // Accumulate left channel samples
             leftChannelBuffer.append(contentsOf: leftSamples)
             
@@ -1681,11 +1927,11 @@ actor SimpleAudioEngine {
             let totalLeft = leftChannelBuffer.count
             let totalRight = rightChannelBuffer.count
             
-            debugPrint("🎧 GOOBERO: Buffer accumulation L(\(totalLeft)) R(\(totalRight)) / \(stereoBufferSize)", source: "SimpleAudioEngine")
+            debugPrint("🎧 GOOBERO: Buffer accumulation L(\(totalLeft)) R(\(totalRight)) / \(leftChunkSize)", source: "SimpleAudioEngine")
             
             // Process left channel when buffer reaches 3.5 seconds
-            if leftChannelBuffer.count >= stereoBufferSize {
-                let leftSamplesForProcessing = Array(leftChannelBuffer.prefix(stereoBufferSize))
+            if leftChannelBuffer.count >= leftChunkSize {
+                let leftSamplesForProcessing = Array(leftChannelBuffer.prefix(leftChunkSize))
                 
                 debugPrint("🎧 GOOBERO LEFT: Buffer full (\(leftChannelBuffer.count) samples), starting VAD analysis", source: "SimpleAudioEngine")
                 
@@ -1703,8 +1949,11 @@ actor SimpleAudioEngine {
                 debugPrint("🎧 GOOBERO LEFT: VAD=\(vadDecision ? "SPEECH" : "SILENCE"), Boundary=\(speechBoundaryDetected), RateLimit=\(rateLimitOk), ShouldProcess=\(shouldProcess)", source: "SimpleAudioEngine")
                 
                 if shouldProcess {
-                    leftChannelBuffer.removeFirst(stereoBufferSize)
+                    leftChannelBuffer.removeFirst(leftChunkSize)
                     lastLeftChannelProcessingTime = currentTime
+                    if let controller = leftChunkController {
+                        whisper_bridge_chunk_controller_chunk_queued(controller)
+                    }
                     
                     // PHASE 4 FIX: Sequential processing to avoid conflicts
                     Task {
@@ -1712,14 +1961,19 @@ actor SimpleAudioEngine {
                     }
                 } else {
                     // Consume buffer to prevent infinite loops but don't process
-                    leftChannelBuffer.removeFirst(stereoBufferSize)
+                    leftChannelBuffer.removeFirst(leftChunkSize)
                     debugPrint("🔇 GOOBERO LEFT: Skipped due to VAD/rate limiting", source: "SimpleAudioEngine")
+                    if !vadDecision {
+                        flushChannelStream("left")
+                    } else {
+                        resetChannelStream("left")
+                    }
                 }
             }
             
             // Process right channel when buffer reaches 3.5 seconds
-            if rightChannelBuffer.count >= stereoBufferSize {
-                let rightSamplesForProcessing = Array(rightChannelBuffer.prefix(stereoBufferSize))
+            if rightChannelBuffer.count >= rightChunkSize {
+                let rightSamplesForProcessing = Array(rightChannelBuffer.prefix(rightChunkSize))
                 
                 debugPrint("🎧 GOOBERO RIGHT: Buffer full (\(rightChannelBuffer.count) samples), starting VAD analysis", source: "SimpleAudioEngine")
                 
@@ -1737,8 +1991,11 @@ actor SimpleAudioEngine {
                 debugPrint("🎧 GOOBERO RIGHT: VAD=\(vadDecision ? "SPEECH" : "SILENCE"), Boundary=\(speechBoundaryDetected), RateLimit=\(rateLimitOk), ShouldProcess=\(shouldProcess)", source: "SimpleAudioEngine")
                 
                 if shouldProcess {
-                    rightChannelBuffer.removeFirst(stereoBufferSize)
+                    rightChannelBuffer.removeFirst(rightChunkSize)
                     lastRightChannelProcessingTime = currentTime
+                    if let controller = rightChunkController {
+                        whisper_bridge_chunk_controller_chunk_queued(controller)
+                    }
                     
                     // PHASE 4 FIX: Sequential processing to avoid conflicts
                     Task {
@@ -1746,8 +2003,13 @@ actor SimpleAudioEngine {
                     }
                 } else {
                     // Consume buffer to prevent infinite loops but don't process
-                    rightChannelBuffer.removeFirst(stereoBufferSize)
+                    rightChannelBuffer.removeFirst(rightChunkSize)
                     debugPrint("🔇 GOOBERO RIGHT: Skipped due to VAD/rate limiting", source: "SimpleAudioEngine")
+                    if !vadDecision {
+                        flushChannelStream("right")
+                    } else {
+                        resetChannelStream("right")
+                    }
                 }
             }
         }
@@ -1772,41 +2034,23 @@ actor SimpleAudioEngine {
                     whisperQueue.async {
                         debugPrint("🎧 Goobero mode: processing clean dual channel audio", source: "SimpleAudioEngine")
                         
-                        let whisperResult = whisper_bridge_transcribe_with_language(
-                            context,
-                            processedSamples,
-                            Int32(processedSamples.count),
-                            language
+                        let committedText = self.decodeWithStream(
+                            self.channelStream(channel),
+                            context: context,
+                            samples: processedSamples,
+                            language: language,
+                            controller: channel == "left" ? self.leftChunkController : self.rightChunkController
                         )
-                        continuation.resume(returning: whisperResult)
+                        continuation.resume(returning: committedText)
                     }
                 }
                 
-                if let result = result,
-                   let transcription = String(cString: result, encoding: .utf8) {
-                    
-                    // Clean up the transcription
-                    let cleanedText = transcription.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines)
-                    
-                    if !cleanedText.isEmpty {
-                        // Format with speaker name
-                        let formattedText = "[\(speaker)]: \(cleanedText)"
-                        debugPrint("✅ GOOBERO \(channel.uppercased()): \(formattedText)", source: "SimpleAudioEngine")
-                        
-                        // Route to appropriate callback
-                        Task { @MainActor in
-                            if channel == "left" {
-                                leftChannelCallback?(formattedText)
-                            } else {
-                                rightChannelCallback?(formattedText)
-                            }
-                        }
-                    }
-                } else {
-                    debugPrint("⚠️ GOOBERO \(channel.uppercased()): Whisper transcription failed", source: "SimpleAudioEngine")
-                }
+                // Format with speaker name and route to the channel callback
+                emitChannelText(result, channel: channel)
+                return
             }
         }
+        dropChunk(channel == "left" ? leftChunkController : rightChunkController)
     }
     
     // MARK: - Stereo Channel Processing
@@ -1834,6 +2078,9 @@ actor SimpleAudioEngine {
         
         // Buffer-based processing for both channels
         bufferQueue.sync {
+            let leftChunkSize = chunkSamples(leftChunkController, fallback: stereoBufferSize)
+            let rightChunkSize = chunkSamples(rightChunkController, fallback: stereoBufferSize)
+            
             // Accumulate left channel samples
             leftChannelBuffer.append(contentsOf: leftSamples)
             
@@ -1847,19 +2094,19 @@ actor SimpleAudioEngine {
             // CRITICAL DEBUG: Log every buffer accumulation to understand the rate
             debugPrint("🎧 BUFFER ACCUMULATION: L(\(totalLeft)) R(\(totalRight)), added L(\(leftSamples.count)) R(\(rightSamples.count))", source: "SimpleAudioEngine")
             
-            if totalLeft % (stereoBufferSize / 4) == 0 { // Every ~0.875s
+            if totalLeft % (leftChunkSize / 4) == 0 { // Every ~0.875s
                 Task {
                     await DebugLogger.audio("🎧 Stereo buffers: L(\(totalLeft)) R(\(totalRight))", source: "SimpleAudioEngine")
                 }
             }
             
             // Process left channel when buffer is full
-            if leftChannelBuffer.count >= stereoBufferSize {
-                let leftSamplesForProcessing = Array(leftChannelBuffer.prefix(stereoBufferSize))
+            if leftChannelBuffer.count >= leftChunkSize {
+                let leftSamplesForProcessing = Array(leftChannelBuffer.prefix(leftChunkSize))
                 
                 // CRITICAL DEBUG: Log stereo processing attempt
                 debugPrint("🎧 STEREO LEFT: Buffer full (\(leftChannelBuffer.count) samples), starting VAD analysis", source: "SimpleAudioEngine")
-                debugPrint("🎧 STEREO LEFT: Buffer threshold reached! stereoBufferSize=\(stereoBufferSize)", source: "SimpleAudioEngine")
+                debugPrint("🎧 STEREO LEFT: Buffer threshold reached! chunkSize=\(leftChunkSize)", source: "SimpleAudioEngine")
                 
                 // CRITICAL: Apply VAD logic like mono mode (prevent hallucinations)
                 let currentTime = Date()
@@ -1875,7 +2122,10 @@ actor SimpleAudioEngine {
                 debugPrint("🎧 STEREO LEFT: VAD=\(vadDecision ? "SPEECH" : "SILENCE"), Boundary=\(speechBoundaryDetected), RateLimit=\(rateLimitOk), ShouldProcess=\(shouldProcess)", source: "SimpleAudioEngine")
                 
                 if shouldProcess {
-                    leftChannelBuffer.removeFirst(stereoBufferSize)
+                    leftChannelBuffer.removeFirst(leftChunkSize)
+                    if let controller = leftChunkController {
+                        whisper_bridge_chunk_controller_chunk_queued(controller)
+                    }
                     
                     // Process left channel asynchronously
                     whisperQueue.async { [weak self] in
@@ -1889,14 +2139,19 @@ actor SimpleAudioEngine {
                     debugPrint("✅ Left channel: VAD detected speech, processing", source: "SimpleAudioEngine")
                 } else {
                     // Consume buffer to prevent infinite loops but don't process
-                    leftChannelBuffer.removeFirst(stereoBufferSize)
+                    leftChannelBuffer.removeFirst(leftChunkSize)
                     debugPrint("🔇 Left channel: No speech detected, skipping transcription", source: "SimpleAudioEngine")
+                    if !vadDecision {
+                        flushChannelStream("left")
+                    } else {
+                        resetChannelStream("left")
+                    }
                 }
             }
             
             // Process right channel when buffer is full
-            if rightChannelBuffer.count >= stereoBufferSize {
-                let rightSamplesForProcessing = Array(rightChannelBuffer.prefix(stereoBufferSize))
+            if rightChannelBuffer.count >= rightChunkSize {
+                let rightSamplesForProcessing = Array(rightChannelBuffer.prefix(rightChunkSize))
                 
                 // CRITICAL DEBUG: Log stereo processing attempt
                 debugPrint("🎧 STEREO RIGHT: Buffer full (\(rightChannelBuffer.count) samples), starting VAD analysis", source: "SimpleAudioEngine")
@@ -1915,7 +2170,10 @@ actor SimpleAudioEngine {
                 debugPrint("🎧 STEREO RIGHT: VAD=\(vadDecision ? "SPEECH" : "SILENCE"), Boundary=\(speechBoundaryDetected), RateLimit=\(rateLimitOk), ShouldProcess=\(shouldProcess)", source: "SimpleAudioEngine")
                 
                 if shouldProcess {
-                    rightChannelBuffer.removeFirst(stereoBufferSize)
+                    rightChannelBuffer.removeFirst(rightChunkSize)
+                    if let controller = rightChunkController {
+                        whisper_bridge_chunk_controller_chunk_queued(controller)
+                    }
                     
                     // Process right channel asynchronously
                     whisperQueue.async { [weak self] in
@@ -1929,8 +2187,13 @@ actor SimpleAudioEngine {
                     debugPrint("✅ Right channel: VAD detected speech, processing", source: "SimpleAudioEngine")
                 } else {
                     // Consume buffer to prevent infinite loops but don't process
-                    rightChannelBuffer.removeFirst(stereoBufferSize)
+                    rightChannelBuffer.removeFirst(rightChunkSize)
                     debugPrint("🔇 Right channel: No speech detected, skipping transcription", source: "SimpleAudioEngine")
+                    if !vadDecision {
+                        flushChannelStream("right")
+                    } else {
+                        resetChannelStream("right")
+                    }
                 }
             }
         }
@@ -1954,38 +2217,22 @@ actor SimpleAudioEngine {
                 // Apply audio mode processing
                 let processedSamples = applyAudioModeProcessing(to: samples)
                 
-                let result = whisper_bridge_transcribe_with_language(
-                    context,
-                    processedSamples,
-                    Int32(processedSamples.count),
-                    language
+                let committedText = decodeWithStream(
+                    channelStream(channel),
+                    context: context,
+                    samples: processedSamples,
+                    language: language,
+                    controller: channel == "left" ? leftChunkController : rightChunkController
                 )
                 
-                if let result = result,
-                   let text = String(cString: result, encoding: .utf8),
-                   !text.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines).isEmpty {
-                    
-                    // Create speaker-tagged text with dynamic names
-                    let speakerName = channel == "left" ? leftSpeakerName : rightSpeakerName
-                    let taggedText = "[\(speakerName)]: \(text)"
-                    
-                    debugPrint("✅ \(channel.capitalized) channel result: \(taggedText)", source: "SimpleAudioEngine")
-                    
-                    // Send to appropriate callback
-                    Task { @MainActor in
-                        if channel == "left" {
-                            leftChannelCallback?(taggedText)
-                        } else {
-                            rightChannelCallback?(taggedText)
-                        }
-                    }
-                } else {
-                    debugPrint("❌ \(channel.capitalized) channel returned empty result", source: "SimpleAudioEngine")
-                }
+                // Create speaker-tagged text and send it to the channel callback
+                emitChannelText(committedText, channel: channel)
+                return
             } else {
                 debugPrint("❌ Whisper context is nil for \(channel) channel", source: "SimpleAudioEngine")
             }
         }
+        dropChunk(channel == "left" ? leftChunkController : rightChunkController)
     }
     
     nonisolated private func processTranscription(samples: [Float]) {
@@ -2164,6 +2411,7 @@ actor SimpleAudioEngine {
                 }
                 
                 inputNode.installTap(onBus: 0, bufferSize: 1024, format: tapFormat) { [weak self] buffer, _ in
+                    self?.pinCaptureThreadIfNeeded()
                     Task {
                         await self?.processAudioBuffer(buffer, targetFormat: whisperFormat)
                     }
@@ -2188,6 +2436,20 @@ actor SimpleAudioEngine {
         return false
     }
     
+    // v1.2.0 ENHANCEMENT: Move the tap thread onto the core reserved in initializeWhisper (once per thread)
+    nonisolated private func pinCaptureThreadIfNeeded() {
+        let thread = pthread_self()
+        guard captureCore >= 0, pinnedCaptureThread != thread else {
+            return
+        }
+        pinnedCaptureThread = thread
+        if whisper_bridge_pin_current_thread_to_core(captureCore) == 0 {
+            debugPrint("📌 Audio capture thread pinned to core \(captureCore)", source: "SimpleAudioEngine")
+        } else {
+            debugPrint("⚠️ Could not pin audio capture thread to core \(captureCore)", source: "SimpleAudioEngine")
+        }
+    }
+    
     private func validateAudioSessionForTapInstallation() async -> Bool {
         guard let audioEngine = audioEngine,
               let inputNode = inputNode else {
@@ -2299,6 +2561,18 @@ actor SimpleAudioEngine {
             }
         }
         
+        for controller in [monoChunkController, leftChunkController, rightChunkController] {
+            if let controller = controller {
+                whisper_bridge_chunk_controller_free(controller)
+            }
+        }
+        
+        for stream in [monoStream, leftStream, rightStream] {
+            if let stream = stream {
+                whisper_bridge_stream_free(stream)
+            }
+        }
+        
         // Clean up audio engine synchronously
         if let inputNode = inputNode {
             inputNode.removeTap(onBus: 0)
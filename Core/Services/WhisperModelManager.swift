@@ -1,10 +1,50 @@
 import Foundation
+import AVFoundation
+
+// v1.2.0 ENHANCEMENT: Quantized ggml weight formats understood by the bridge
+enum WhisperQuantization: String, Codable {
+    case f32 = "f32"
+    case f16 = "f16"
+    case q5_0 = "q5_0"
+    case q5_1 = "q5_1"
+    case q8_0 = "q8_0"
+    case unknown = "unknown"
+    
+    init(ftype: Int32) {
+        switch ftype {
+        case 0: self = .f32
+        case 1: self = .f16
+        case 7: self = .q8_0
+        case 8: self = .q5_0
+        case 9: self = .q5_1
+        default: self = .unknown
+        }
+    }
+}
 
 enum WhisperModel: String, CaseIterable, Codable {
     case base = "base"
+    case baseQ5_1 = "base-q5_1"
+    case baseQ8_0 = "base-q8_0"
+    case medium = "medium"
+    case mediumQ5_0 = "medium-q5_0"
+    case mediumQ8_0 = "medium-q8_0"
     
     var displayName: String {
-        return "base (Multilingual) - Good balance, supports 100+ languages"
+        switch self {
+        case .base:
+            return "base (Multilingual) - Good balance, supports 100+ languages"
+        case .baseQ5_1:
+            return "base q5_1 (Multilingual) - Smallest footprint, fastest"
+        case .baseQ8_0:
+            return "base q8_0 (Multilingual) - Near full-precision accuracy, smaller"
+        case .medium:
+            return "medium (Multilingual) - Best accuracy, needs 16 GB"
+        case .mediumQ5_0:
+            return "medium q5_0 (Multilingual) - High accuracy on 8 GB machines"
+        case .mediumQ8_0:
+            return "medium q8_0 (Multilingual) - Near full-precision medium"
+        }
     }
     
     var fileName: String {
@@ -16,7 +56,23 @@ enum WhisperModel: String, CaseIterable, Codable {
     }
     
     var sizeInMB: Int {
-        return 142
+        switch self {
+        case .base: return 142
+        case .baseQ5_1: return 57
+        case .baseQ8_0: return 78
+        case .medium: return 1533
+        case .mediumQ5_0: return 514
+        case .mediumQ8_0: return 785
+        }
+    }
+    
+    var quantization: WhisperQuantization {
+        switch self {
+        case .base, .medium: return .f16
+        case .baseQ5_1: return .q5_1
+        case .baseQ8_0, .mediumQ8_0: return .q8_0
+        case .mediumQ5_0: return .q5_0
+        }
     }
     
     var isMultilingual: Bool {
@@ -24,11 +80,42 @@ enum WhisperModel: String, CaseIterable, Codable {
     }
     
     var speedRating: Int {
-        return 4
+        switch self {
+        case .base: return 4
+        case .baseQ5_1, .baseQ8_0: return 5
+        case .medium: return 1
+        case .mediumQ5_0, .mediumQ8_0: return 2
+        }
     }
     
     var qualityRating: Int {
-        return 2
+        switch self {
+        case .base, .baseQ5_1, .baseQ8_0: return 2
+        case .medium, .mediumQ5_0, .mediumQ8_0: return 4
+        }
+    }
+}
+
+// v1.2.0 ENHANCEMENT: Calibration runs are kept per model and allocation mode,
+// so a huge-page replay sits next to the baseline run instead of replacing it
+struct CalibrationKey: Hashable, Codable {
+    let model: WhisperModel
+    let hugePageMode: Int32    // whisper_bridge_hugepage_mode
+}
+
+// v1.2.0 ENHANCEMENT: Result of one on-device calibration run
+struct ModelCalibrationResult: Codable {
+    let model: WhisperModel
+    let hugePageMode: Int32
+    let quantization: WhisperQuantization
+    let realTimeFactor: Float      // decode time / audio time (lower is faster)
+    let peakMemoryMB: Double       // resident memory added by the model while decoding
+    let wordErrorRate: Float?      // nil when no reference transcript was available
+    let hugePageMB: Double?        // model/KV/compute memory backed by huge pages during the run
+    let date: Date
+    
+    var key: CalibrationKey {
+        return CalibrationKey(model: model, hugePageMode: hugePageMode)
     }
 }
 
@@ -64,10 +151,20 @@ class WhisperModelManager: ObservableObject {
     @Published var downloadProgress: Double = 0.0
     @Published var downloadingModel: WhisperModel?
     @Published var downloadError: ModelDownloadError?
+    @Published var calibrationResults: [CalibrationKey: ModelCalibrationResult] = [:]
+    @Published var isCalibrating = false
+    
+    // v1.2.0 ENHANCEMENT: Allocation mode the engine initializes Whisper with (whisper_bridge_hugepage_mode)
+    @Published var hugePageMode: Int32 = 0 {
+        didSet { userDefaults.set(Int(hugePageMode), forKey: hugePageModeKey) }
+    }
     
     private let modelsDirectory: URL
     private let userDefaults = UserDefaults.standard
     private let currentModelKey = "SelectedWhisperModel"
+    private let calibrationResultsKey = "WhisperCalibrationResults"
+    private let hugePageModeKey = "WhisperHugePageMode"
+    private let calibrationQueue = DispatchQueue(label: "com.prezefren.calibration", qos: .utility)
     
     init() {
         // Create models directory in app support
@@ -83,6 +180,9 @@ class WhisperModelManager: ObservableObject {
             currentModel = savedModel
         }
         
+        hugePageMode = Int32(userDefaults.integer(forKey: hugePageModeKey))
+        
+        loadCalibrationResults()
         scanDownloadedModels()
     }
     
@@ -270,7 +370,168 @@ class WhisperModelManager: ObservableObject {
     }
     
     func getModelRecommendation(for useCase: String) -> WhisperModel {
-        return .base
+        return recommendModel() ?? .base
+    }
+    
+    // MARK: - Calibration
+    
+    /// Runs the bundled calibration clip through every downloaded variant and stores RTF, peak memory and WER.
+    /// Pass a non-zero hugePageMode (see whisper_bridge_hugepage_mode) to replay the clip with huge-page backed buffers;
+    /// results are stored per mode, so runs with and without huge pages can be compared.
+    func runCalibration(language: String = "en", hugePageMode: Int32 = 0) async {
+        guard !isCalibrating else {
+            print("⚠️ Calibration already in progress")
+            return
+        }
+        
+        guard let clip = loadCalibrationClip() else {
+            print("❌ Calibration clip not found in bundle")
+            return
+        }
+        
+        isCalibrating = true
+        defer { isCalibrating = false }
+        
+        let models = downloadedModels.compactMap { model in getModelPath(model).map { (model, $0) } }
+        
+        for (model, path) in models {
+            print("📊 Calibrating \(model.rawValue)...")
+            
+            let result: ModelCalibrationResult? = await withCheckedContinuation { continuation in
+                calibrationQueue.async {
+                    var rtf: Float = 0
+                    var peakMemoryMB: Double = 0
+                    var wer: Float = -1
+                    var ftype: Int32 = -1
+                    var hugePageMB: Double = 0
+                    
+                    let status = whisper_bridge_calibrate_model(
+                        path,
+                        clip.samples,
+                        Int32(clip.samples.count),
+                        language,
+                        clip.reference,
+                        hugePageMode,
+                        &rtf,
+                        &peakMemoryMB,
+                        &wer,
+                        &ftype,
+                        &hugePageMB
+                    )
+                    
+                    guard status == 0 else {
+                        continuation.resume(returning: nil)
+                        return
+                    }
+                    
+                    continuation.resume(returning: ModelCalibrationResult(
+                        model: model,
+                        hugePageMode: hugePageMode,
+                        quantization: WhisperQuantization(ftype: ftype),
+                        realTimeFactor: rtf,
+                        peakMemoryMB: peakMemoryMB,
+                        wordErrorRate: wer >= 0 ? wer : nil,
+                        hugePageMB: hugePageMode != 0 ? hugePageMB : nil,
+                        date: Date()
+                    ))
+                }
+            }
+            
+            if let result = result {
+                calibrationResults[result.key] = result
+            } else {
+                print("❌ Calibration failed for \(model.rawValue)")
+            }
+        }
+        
+        saveCalibrationResults()
+    }
+    
+    /// Fastest calibrated model that stays within the accuracy, speed and memory targets, judged by the runs
+    /// made with the allocation mode the engine uses. Runs without a reference transcript have no measured
+    /// accuracy and are never recommended.
+    func recommendModel(maxWordErrorRate: Float = 0.25, maxRealTimeFactor: Float = 0.5, maxMemoryMB: Double? = nil) -> WhisperModel? {
+        let memoryBudget = maxMemoryMB ?? Double(ProcessInfo.processInfo.physicalMemory) / (1024 * 1024) / 4
+        
+        return calibrationResults.values
+            .filter { downloadedModels.contains($0.model) && $0.hugePageMode == hugePageMode }
+            .filter { result in result.wordErrorRate.map { $0 <= maxWordErrorRate } ?? false }
+            .filter { $0.realTimeFactor <= maxRealTimeFactor && $0.peakMemoryMB <= memoryBudget }
+            .min { $0.realTimeFactor < $1.realTimeFactor }?
+            .model
+    }
+    
+    /// Decode-time change of a huge-page run relative to the baseline run of the same model (negative = faster).
+    func hugePageDecodeTimeChange(for model: WhisperModel, mode: Int32) -> Float? {
+        guard mode != 0,
+              let baseline = calibrationResults[CalibrationKey(model: model, hugePageMode: 0)],
+              let replay = calibrationResults[CalibrationKey(model: model, hugePageMode: mode)],
+              baseline.realTimeFactor > 0 else {
+            return nil
+        }
+        return replay.realTimeFactor / baseline.realTimeFactor - 1
+    }
+    
+    private func loadCalibrationClip() -> (samples: [Float], reference: String?)? {
+        guard let clipURL = Bundle.main.url(forResource: "calibration_clip", withExtension: "wav") else {
+            return nil
+        }
+        
+        let reference = Bundle.main.url(forResource: "calibration_clip", withExtension: "txt")
+            .flatMap { try? String(contentsOf: $0, encoding: .utf8) }
+        
+        guard let file = try? AVAudioFile(forReading: clipURL),
+              let targetFormat = AVAudioFormat(commonFormat: .pcmFormatFloat32, sampleRate: 16000, channels: 1, interleaved: false),
+              let converter = AVAudioConverter(from: file.processingFormat, to: targetFormat),
+              let inputBuffer = AVAudioPCMBuffer(pcmFormat: file.processingFormat, frameCapacity: AVAudioFrameCount(file.length)) else {
+            return nil
+        }
+        
+        do {
+            try file.read(into: inputBuffer)
+        } catch {
+            print("❌ Failed to read calibration clip: \(error)")
+            return nil
+        }
+        
+        let ratio = targetFormat.sampleRate / file.processingFormat.sampleRate
+        let outputCapacity = AVAudioFrameCount(Double(inputBuffer.frameLength) * ratio) + 1024
+        guard let outputBuffer = AVAudioPCMBuffer(pcmFormat: targetFormat, frameCapacity: outputCapacity) else {
+            return nil
+        }
+        
+        var consumed = false
+        var conversionError: NSError?
+        converter.convert(to: outputBuffer, error: &conversionError) { _, outStatus in
+            if consumed {
+                outStatus.pointee = .endOfStream
+                return nil
+            }
+            consumed = true
+            outStatus.pointee = .haveData
+            return inputBuffer
+        }
+        
+        guard conversionError == nil, let channelData = outputBuffer.floatChannelData else {
+            return nil
+        }
+        
+        let samples = Array(UnsafeBufferPointer(start: channelData[0], count: Int(outputBuffer.frameLength)))
+        return (samples, reference)
+    }
+    
+    private func loadCalibrationResults() {
+        guard let data = userDefaults.data(forKey: calibrationResultsKey),
+              let results = try? JSONDecoder().decode([ModelCalibrationResult].self, from: data) else {
+            return
+        }
+        calibrationResults = Dictionary(results.map { ($0.key, $0) }, uniquingKeysWith: { $1 })
+    }
+    
+    private func saveCalibrationResults() {
+        if let data = try? JSONEncoder().encode(Array(calibrationResults.values)) {
+            userDefaults.set(data, forKey: calibrationResultsKey)
+        }
     }
     
     func getStorageInfo() -> (usedMB: Int, totalDownloaded: Int) {
@@ -6,6 +6,7 @@ struct ModelsView: View {
     @State private var downloadStatus = "Ready to download"
     @State private var downloadProgress = 0
     @State private var totalPairs = 12
+    @StateObject private var modelManager = WhisperModelManager()
     @EnvironmentObject var appState: AppState
     
     var body: some View {
@@ -22,6 +23,9 @@ struct ModelsView: View {
                 // Current Whisper Model (simplified)
                 currentWhisperModelCard
                 
+                // v1.2.0 ENHANCEMENT: Speed/accuracy calibration of the installed variants
+                calibrationCard
+                
                 Spacer()
             }
             .padding()
@@ -211,6 +215,112 @@ struct ModelsView: View {
         }
     }
     
+    private var calibrationCard: some View {
+        ModernCard {
+            VStack(alignment: .leading, spacing: 16) {
+                HStack {
+                    Image(systemName: "speedometer")
+                        .foregroundColor(.orange)
+                        .font(.title2)
+                    
+                    Text("Model Calibration")
+                        .font(.headline)
+                        .fontWeight(.semibold)
+                    
+                    Spacer()
+                    
+                    if modelManager.isCalibrating {
+                        ProgressView()
+                            .controlSize(.small)
+                    }
+                }
+                
+                Text("Runs a short reference clip through every installed Whisper variant and measures speed (RTF), memory and word error rate on this Mac.")
+                    .font(.caption)
+                    .foregroundColor(.secondary)
+                
+                Picker("Huge pages", selection: $modelManager.hugePageMode) {
+                    Text("Off").tag(Int32(0))
+                    Text("Transparent").tag(Int32(1))
+                    Text("Collapse at load").tag(Int32(2))
+                }
+                .pickerStyle(.segmented)
+                .frame(maxWidth: 420)
+                
+                HStack {
+                    Button(action: {
+                        Task {
+                            await modelManager.runCalibration()
+                        }
+                    }) {
+                        HStack {
+                            Image(systemName: "play.circle.fill")
+                            Text(modelManager.isCalibrating ? "Calibrating..." : "Calibrate Installed Models")
+                        }
+                    }
+                    .buttonStyle(.borderedProminent)
+                    .disabled(modelManager.isCalibrating || modelManager.downloadedModels.isEmpty)
+                    
+                    // Replays the clip with the selected mode; results sit next to the baseline run
+                    if modelManager.hugePageMode != 0 {
+                        Button(action: {
+                            Task {
+                                await modelManager.runCalibration(hugePageMode: modelManager.hugePageMode)
+                            }
+                        }) {
+                            HStack {
+                                Image(systemName: "arrow.triangle.2.circlepath")
+                                Text("Replay with Huge Pages")
+                            }
+                        }
+                        .buttonStyle(.bordered)
+                        .disabled(modelManager.isCalibrating || modelManager.downloadedModels.isEmpty)
+                    }
+                    
+                    Spacer()
+                }
+                
+                ForEach(modelManager.calibrationResults.values.sorted { $0.realTimeFactor < $1.realTimeFactor }, id: \.key) { result in
+                    HStack(spacing: 16) {
+                        Text(result.hugePageMode == 0 ? result.model.rawValue : "\(result.model.rawValue) (huge \(result.hugePageMode))")
+                            .font(.caption)
+                            .fontWeight(.medium)
+                            .frame(width: 140, alignment: .leading)
+                        MetricView(title: "Weights", value: result.quantization.rawValue)
+                        MetricView(title: "RTF", value: String(format: "%.2f", result.realTimeFactor))
+                        MetricView(title: "Memory", value: String(format: "%.0f MB", result.peakMemoryMB))
+                        MetricView(title: "WER", value: result.wordErrorRate.map { String(format: "%.0f%%", $0 * 100) } ?? "n/a")
+                        if let change = modelManager.hugePageDecodeTimeChange(for: result.model, mode: result.hugePageMode) {
+                            MetricView(title: "vs. off", value: String(format: "%+.0f%% time", change * 100))
+                        }
+                    }
+                }
+                
+                if let recommended = modelManager.recommendModel() {
+                    HStack {
+                        Text("💡 Recommended: \(recommended.rawValue)")
+                            .font(.caption)
+                            .foregroundColor(.blue)
+                        
+                        if recommended != modelManager.currentModel {
+                            Button("Use") {
+                                modelManager.setCurrentModel(recommended)
+                            }
+                            .buttonStyle(.bordered)
+                            .controlSize(.small)
+                        }
+                        
+                        Spacer()
+                    }
+                    
+                    Text("Model and huge page changes take effect after restarting Prezefren.")
+                        .font(.caption2)
+                        .foregroundColor(.secondary)
+                }
+            }
+        }
+    }
+    
     @available(macOS 15.0, *)
     private func downloadWithProgress(service: AppleTranslationService) async {
         // DISABLED: Download functionality needs proper Apple Translation API integration
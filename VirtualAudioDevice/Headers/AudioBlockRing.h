@@ -0,0 +1,92 @@
+#pragma once
+
+#include <CoreAudio/CoreAudioTypes.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of audio blocks
+ *
+ * Each slot holds one AudioBufferList (up to maxBuffers buffers of maxBytesPerBuffer
+ * bytes) plus its AudioTimeStamp. The producer is the real-time audio thread: Push()
+ * only copies into preallocated slots and updates atomics. Larger inputs are split
+ * across several slots by frame.
+ *
+ * When the ring is full, the overflow policy decides what is lost: DropNewest rejects
+ * the incoming block, OverwriteOldest advances the consumer past its oldest block. In
+ * overwrite mode a block the consumer was copying can be reclaimed underneath it; Pop()
+ * detects that through the read index and retries with the next block.
+ */
+class AudioBlockRing {
+public:
+    enum class OverflowPolicy {
+        DropNewest,
+        OverwriteOldest
+    };
+
+    AudioBlockRing();
+
+    /**
+     * @brief Allocate slots (not real-time safe)
+     * @param capacityBlocks Number of slots
+     * @param maxBuffers Largest mNumberBuffers accepted
+     * @param maxBytesPerBuffer Slot size per buffer
+     * @param bytesPerSample Sample size, used to split oversized inputs on frame boundaries
+     * @param policy What to lose when full
+     */
+    bool Configure(uint32_t capacityBlocks, uint32_t maxBuffers, uint32_t maxBytesPerBuffer,
+                   uint32_t bytesPerSample, OverflowPolicy policy);
+
+    /**
+     * @brief Copy a block into the ring (producer thread only)
+     * @return false if any part of the block was dropped
+     */
+    bool Push(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp);
+
+    /**
+     * @brief Copy the oldest block out of the ring (consumer thread only)
+     * @param bufferList Consumer-owned list with at least maxBuffers buffers whose mData
+     *        points to maxBytesPerBuffer bytes each; sizes and counts are filled in
+     * @param timeStamp Receives the block's timestamp
+     * @return false if the ring is empty
+     */
+    bool Pop(AudioBufferList& bufferList, AudioTimeStamp& timeStamp);
+
+    uint32_t GetQueuedBlocks() const;
+    uint64_t GetOverflowCount() const { return overflowCount_.load(std::memory_order_relaxed); }
+    uint64_t GetOverwriteCount() const { return overwriteCount_.load(std::memory_order_relaxed); }
+    uint32_t GetMaxBuffers() const { return maxBuffers_; }
+    uint32_t GetMaxBytesPerBuffer() const { return maxBytesPerBuffer_; }
+
+private:
+    struct SlotHeader {
+        AudioTimeStamp timeStamp;
+        uint32_t numberBuffers;
+    };
+
+    uint32_t capacity_;
+    uint32_t maxBuffers_;
+    uint32_t maxBytesPerBuffer_;
+    uint32_t bytesPerSample_;
+    OverflowPolicy policy_;
+
+    std::vector<SlotHeader> headers_;
+    std::vector<uint32_t> bufferChannels_;  // capacity_ x maxBuffers_
+    std::vector<uint32_t> bufferBytes_;     // capacity_ x maxBuffers_
+    std::vector<uint8_t> data_;             // capacity_ x maxBuffers_ x maxBytesPerBuffer_
+
+    // Monotonic block counters; slot = index % capacity_
+    alignas(64) std::atomic<uint64_t> writeIndex_;
+    alignas(64) std::atomic<uint64_t> readIndex_;
+
+    std::atomic<uint64_t> overflowCount_;
+    std::atomic<uint64_t> overwriteCount_;
+
+    bool PushSlice(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp,
+                   uint32_t frameOffset, uint32_t frames);
+};
+
+} // namespace Prezefren
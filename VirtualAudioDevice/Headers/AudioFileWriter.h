@@ -0,0 +1,111 @@
+#pragma once
+
+#include "SampleKernels.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Streams interleaved PCM to a WAV, CAF or raw file with large sequential writes
+ *
+ * Meant for a background thread that drains a ring: Write() only copies into a
+ * staging buffer, which goes to disk in kStagingBytes writes. File space is
+ * preallocated ahead of the write position in kPreallocateBytes extents where the
+ * file system supports it, so the file does not fragment and appends rarely touch
+ * allocation metadata. Every syncInterval seconds of audio the header is rewritten
+ * with the sizes so far and the data is synced, which bounds what a crash can lose
+ * and keeps the file playable up to that point. Close() writes the final header,
+ * trims the preallocated tail and syncs.
+ *
+ * Write errors (disk full, device gone) are counted and the failing data dropped;
+ * the writer never blocks on anything but the file itself. Write() and Close() may
+ * be called from different threads; a mutex serializes them.
+ *
+ * Plain POSIX with no Apple framework dependencies.
+ */
+class AudioFileWriter {
+public:
+    enum class Container {
+        Wav,        // RIFF WAVE: PCM int16 or IEEE float, 4 GB maximum
+        Caf,        // Core Audio Format: no size limit, valid even if never closed
+        Raw         // Headerless samples
+    };
+
+    struct Statistics {
+        uint64_t framesWritten;
+        uint64_t bytesWritten;          // Audio data only, header excluded
+        uint64_t writeErrors;           // Failed writes; their data was dropped
+        uint64_t syncs;
+        double longestWriteSeconds;     // Slowest single write() or sync
+        int lastError;                  // errno of the most recent failure, 0 = none
+    };
+
+    static constexpr size_t kStagingBytes = 256 * 1024;
+    static constexpr uint64_t kPreallocateBytes = 8 * 1024 * 1024;
+
+    AudioFileWriter();
+    ~AudioFileWriter();
+
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+    /**
+     * @brief Create (or truncate) the file and write a provisional header
+     * @param layout Sample type and channel count; the data must be interleaved
+     * @param syncIntervalSeconds Audio between header updates and syncs, 0 = only at Close()
+     */
+    bool Open(const std::string& path, Container container, const SampleLayout& layout,
+              double sampleRate, double syncIntervalSeconds);
+
+    /**
+     * @brief Append whole interleaved frames
+     */
+    void Write(const void* data, uint32_t bytes);
+
+    /**
+     * @brief Flush, finalize the header, trim and sync
+     * @return false if anything failed along the way (the file is closed regardless)
+     */
+    bool Close();
+
+    bool IsOpen() const;
+    Statistics GetStatistics() const;
+
+private:
+    mutable std::mutex mutex_;
+    int fd_;
+    Container container_;
+    SampleLayout layout_;
+    double sampleRate_;
+    uint32_t headerBytes_;
+    uint64_t dataBytes_;            // Audio on disk after the header, staging excluded
+    uint64_t syncIntervalBytes_;
+    uint64_t nextSyncBytes_;
+    uint64_t allocatedBytes_;       // File offset preallocated up to
+    bool preallocate_;
+    bool finalized_;                // Close() is writing the final header
+    std::vector<uint8_t> staging_;
+    size_t stagedBytes_;
+
+    std::atomic<uint64_t> framesWritten_;
+    std::atomic<uint64_t> writeErrors_;
+    std::atomic<uint64_t> syncs_;
+    std::atomic<int64_t> longestWriteNs_;
+    std::atomic<int> lastError_;
+
+    bool Flush();
+    bool Sync();
+    bool WriteHeader();
+    void Preallocate(uint64_t endOffset);
+    bool WriteAll(const uint8_t* data, size_t bytes, int64_t offset);
+    void RecordError(int error);
+    void RecordDuration(int64_t nanoseconds);
+    std::vector<uint8_t> BuildHeader() const;
+};
+
+} // namespace Prezefren
@@ -2,9 +2,25 @@
 
 #include <CoreAudio/CoreAudio.h>
 #include <AVFoundation/AVFoundation.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <thread>
 #include <vector>
 #include <functional>
+#include <dispatch/dispatch.h>
+#include "AudioBlockRing.h"
+#include "AudioFileWriter.h"
+#include "DriftEstimator.h"
+#include "DspChain.h"
+#include "PolyphaseResampler.h"
+#include "RcuPointer.h"
+#include "Reblocker.h"
+#include "RoutingMatrix.h"
+#include "SampleKernels.h"
 
 namespace Prezefren {
 
@@ -17,20 +33,63 @@ namespace Prezefren {
  */
 class AudioSplitter {
 public:
+    /**
+     * @brief How a destination's callback is invoked
+     *
+     * Synchronous destinations run inline on the audio thread. Asynchronous ones get a
+     * lock-free SPSC ring filled by the audio thread and drained by a dedicated consumer
+     * thread, so a slow callback only delays itself.
+     *
+     * With blockFrames set, the callback always receives exactly that many frames
+     * (at the destination's rate), stamped with the sample time of the first frame.
+     * Asynchronous destinations reblock on their consumer thread.
+     *
+     * With compensateDrift set, the destination gets its own adaptive-rate conversion
+     * that follows the consumer's clock instead of the capture clock. The drift is
+     * estimated from fillLevel (frames queued at the consumer, polled on the audio
+     * thread) when given, otherwise from the input timestamps against a consumer
+     * that drains at its nominal rate on the host clock.
+     *
+     * With drainOnStop set, an asynchronous destination's consumer delivers whatever
+     * is still queued when the destination goes away instead of discarding it.
+     */
+    struct DeliveryOptions {
+        bool asynchronous = false;
+        AudioBlockRing::OverflowPolicy overflowPolicy = AudioBlockRing::OverflowPolicy::DropNewest;
+        UInt32 ringCapacityBlocks = 32;
+        UInt32 blockFrames = 0;         // 0 = deliver blocks in whatever size they arrive
+        bool compensateDrift = false;
+        std::function<double()> fillLevel;      // Must be real-time safe; empty = timestamp estimate
+        double targetFillFrames = 0.0;          // Fill level held in fill-level mode
+        bool drainOnStop = false;               // Async only: deliver queued blocks on removal
+
+        DeliveryOptions() {}    // Lets it default an argument inside AudioSplitter
+    };
+
+    /**
+     * @brief Frames in a block of the given duration, e.g. 20 ms at 16 kHz = 320
+     */
+    static UInt32 FramesForDuration(double sampleRate, double milliseconds);
+
     /**
      * @brief Output destination for split audio streams
      */
     struct OutputDestination {
+        int id;                 // Assigned by AddOutputDestination, stable for the destination's lifetime
         std::string name;
         std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback;
         AVAudioFormat* format;
         bool enabled;
+        DeliveryOptions delivery;
+        std::vector<float> routing;     // format.channelCount x input channels gains, row-major; empty = default mapping
+        std::vector<DspChain::Stage> effects;   // Run in order on the audio thread before delivery
         
         OutputDestination(
             const std::string& n,
             std::function<void(const AudioBufferList&, const AudioTimeStamp&)> cb,
-            AVAudioFormat* fmt
-        ) : name(n), callback(std::move(cb)), format(fmt), enabled(true) {}
+            AVAudioFormat* fmt,
+            const DeliveryOptions& opts = DeliveryOptions()
+        ) : id(-1), name(n), callback(std::move(cb)), format(fmt), enabled(true), delivery(opts) {}
     };
 
     AudioSplitter();
@@ -38,10 +97,39 @@ public:
 
     /**
      * @brief Initialize the audio splitter
-     * @param inputFormat The format of incoming audio
+     * @param inputFormat The format of incoming audio: float32 or int16, interleaved or not
+     * @param maxFramesPerBuffer Largest expected IO buffer; sizes the preallocated conversion buffers
      * @return true if initialization successful
+     *
+     * Does nothing once initialized; use Reconfigure() to follow a new input format.
+     */
+    bool Initialize(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer = kDefaultMaxFramesPerBuffer);
+
+    /**
+     * @brief Switch to a new input format while audio runs
+     * @param inputFormat The format buffers will arrive in from now on, or nullptr to keep
+     *        the current one and only change the buffer size
+     * @param maxFramesPerBuffer Largest expected IO buffer, or 0 to keep the current size.
+     *        Larger buffers are converted in slices of this size.
+     * @return false (with the previous configuration left in place) if the format is
+     *         unsupported or a destination cannot be converted from it
+     *
+     * Rebuilds every conversion for the new input on the calling thread and publishes
+     * them in one table swap, so each buffer is processed entirely with the old or the
+     * new graph. Destination IDs and callbacks stay as they are. Delivery state that
+     * does not depend on the input (async rings, fixed-size blocks and DSP chains of
+     * converted destinations) is kept, so queued audio and filter state survive; the
+     * new resamplers start from silence and fade in over kReconfigureFadeMs.
+     * Passthrough destinations follow the input; explicit routing matrices are
+     * adapted to the new channel count with RoutingMatrix::Adapt().
+     *
+     * Behaves like Initialize() if the splitter was not initialized yet.
      */
-    bool Initialize(AVAudioFormat* inputFormat);
+    bool Reconfigure(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer = 0);
+
+    static constexpr UInt32 kDefaultMaxFramesPerBuffer = 4096;
+    static constexpr UInt32 kMaxChannels = 64;
+    static constexpr double kReconfigureFadeMs = 5.0;
 
     /**
      * @brief Add an output destination for split audio
@@ -53,49 +141,128 @@ public:
     /**
      * @brief Remove an output destination
      * @param destinationId The ID of the destination to remove
+     * @return false if no destination has this ID
      */
-    void RemoveOutputDestination(int destinationId);
+    bool RemoveOutputDestination(int destinationId);
 
     /**
      * @brief Enable/disable a specific output destination
      * @param destinationId The destination ID
      * @param enabled Whether to enable or disable
+     * @return false if no destination has this ID
+     */
+    bool SetDestinationEnabled(int destinationId, bool enabled);
+
+    /**
+     * @brief Replace a destination's DSP chain while audio runs
+     * @param destinationId The destination ID
+     * @param stages Stages in processing order; empty bypasses the chain
+     * @return false if no destination has this ID, a stage is invalid, or the destination
+     *         receives interleaved passthrough audio
+     *
+     * The chain runs fused and in place on the destination's own copy of its audio, so
+     * destinations sharing a conversion are unaffected. Stage changes never block the
+     * audio thread.
      */
-    void SetDestinationEnabled(int destinationId, bool enabled);
+    bool SetDestinationEffects(int destinationId, const std::vector<DspChain::Stage>& stages);
 
     /**
      * @brief Process incoming audio and split to all destinations
      * @param bufferList The audio data to split
      * @param timeStamp Timing information
+     *
+     * Real-time safe with respect to configuration: reads an immutable destination
+     * table published by the configuration methods and never takes a lock.
      */
     void ProcessAudioBuffer(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp);
 
     /**
      * @brief Create a transcription-optimized output destination
      * @param callback Function to receive processed audio
+     * @param delivery Inline or asynchronous delivery
      * @return Destination ID
      */
-    int CreateTranscriptionDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback);
+    int CreateTranscriptionDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                       const DeliveryOptions& delivery = DeliveryOptions());
 
     /**
-     * @brief Create a passthrough destination (maintains original quality)
+     * @brief Create a passthrough destination (maintains original quality, follows
+     *        the input format across Reconfigure())
      * @param callback Function to receive original audio
+     * @param delivery Inline or asynchronous delivery
      * @return Destination ID
      */
-    int CreatePassthroughDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback);
+    int CreatePassthroughDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                     const DeliveryOptions& delivery = DeliveryOptions());
 
     /**
      * @brief Create a channel-specific destination for stereo processing
      * @param channel The channel to extract (0 = left, 1 = right)
      * @param callback Function to receive channel audio
+     * @param delivery Inline or asynchronous delivery
      * @return Destination ID
      */
-    int CreateChannelDestination(int channel, std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback);
+    int CreateChannelDestination(int channel, std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                 const DeliveryOptions& delivery = DeliveryOptions());
+
+    /**
+     * @brief Create a routing-matrix destination (M input channels to N output channels)
+     * @param name Destination name for logging
+     * @param outputChannels Number of output channels (N)
+     * @param gains N x M gains, row-major by output channel (gains[out * M + in])
+     * @param sampleRate Output sample rate, or 0 to keep the input rate
+     * @param callback Function to receive the mixed audio
+     * @param delivery Inline or asynchronous delivery
+     * @return Destination ID, or -1 if the matrix does not match the input channel count
+     */
+    int CreateMatrixDestination(const std::string& name, UInt32 outputChannels, const std::vector<float>& gains,
+                                double sampleRate,
+                                std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                const DeliveryOptions& delivery = DeliveryOptions());
+
+    /**
+     * @brief File format and buffering of a recording destination
+     */
+    struct RecordingOptions {
+        AudioFileWriter::Container container = AudioFileWriter::Container::Wav;
+        SampleLayout::Type sampleType = SampleLayout::Type::Int16;
+        double sampleRate = 0.0;            // 0 = input rate
+        UInt32 channels = 0;                // 0 = input channel count
+        double bufferSeconds = 10.0;        // Ring size: audio the disk may fall behind by
+        double syncIntervalSeconds = 5.0;   // Audio between header updates and syncs
+
+        RecordingOptions() {}   // Lets it default an argument inside AudioSplitter
+    };
+
+    /**
+     * @brief Create a destination that records to disk
+     * @param path File to create (truncated if it exists)
+     * @param options Container, sample format and buffering
+     * @return Destination ID, or -1 if the file cannot be created
+     *
+     * The audio thread only copies each converted block into a ring holding about
+     * options.bufferSeconds of audio (at full-size input buffers); the destination's
+     * consumer thread is the file writer and does all disk IO with AudioFileWriter.
+     * A slow disk fills the ring and drops audio from the recording only (counted
+     * as overflows); capture and the other destinations are unaffected. Always
+     * converted through the graph with its own fixed format, so the file format
+     * stays put across Reconfigure() and the recording continues without a gap.
+     *
+     * Removing the destination writes out what is still queued, finalizes the header
+     * and closes the file, on the thread that removes it.
+     */
+    int CreateRecordingDestination(const std::string& path, const RecordingOptions& options = RecordingOptions());
+
+    /**
+     * @brief Get file statistics for a recording destination
+     * @return false if no recording destination has this ID
+     */
+    bool GetRecordingStatistics(int destinationId, AudioFileWriter::Statistics& stats) const;
 
     /**
      * @brief Check if splitter is currently active
      */
-    bool IsActive() const { return isInitialized_ && !destinations_.empty(); }
+    bool IsActive() const;
 
     /**
      * @brief Get statistics about processed audio
@@ -106,41 +273,305 @@ public:
         double averageProcessingTime;
         double inputSampleRate;
         uint32_t inputChannels;
+        uint64_t asyncOverflows;        // Blocks rejected by full rings (DropNewest)
+        uint64_t asyncOverwrites;       // Unread blocks discarded by full rings (OverwriteOldest)
+        uint64_t formatMismatches;      // Buffers dropped because they did not match the input layout
+        uint32_t reconfigurations;      // Successful Reconfigure() calls that changed the input
     };
     
     Statistics GetStatistics() const;
 
+    /**
+     * @brief Per-destination delivery statistics
+     */
+    struct DestinationStatistics {
+        bool asynchronous;
+        uint64_t deliveredBlocks;       // Async only: blocks handed to the callback
+        uint32_t queuedBlocks;
+        uint64_t overflows;
+        uint64_t overwrites;
+        double conversionLatency;       // Seconds of resampler group delay in the delivered timestamps
+        bool driftCompensated;
+        double driftPpm;                // Estimated capture clock drift against the consumer
+        double ratioAdjustment;         // Current correction applied to the conversion ratio
+    };
+
+    /**
+     * @brief Get delivery statistics for one destination
+     * @return false if no destination has this ID
+     */
+    bool GetDestinationStatistics(int destinationId, DestinationStatistics& stats) const;
+
 private:
-    bool isInitialized_;
+    /**
+     * @brief Conversion graph stage 1: channel routing through a gain matrix
+     *
+     * Shared by every destination with the same matrix. Output channels that merely
+     * select an input channel at unity gain point at the (planar) input directly;
+     * only real mixes run a kernel into mixStorage.
+     */
+    struct ChannelNode {
+        RoutingMatrix matrix;
+        SampleKernels::ReadKernel readKernel;       // null for planar float input, read in place
+        std::vector<float> inputStorage;            // inputChannels x maxFramesPerBuffer_, kernel output
+        std::vector<float*> inputStoragePointers;
+        std::vector<const void*> inputBuffers;      // valid for the current slice
+        std::vector<float> silence;                 // maxFramesPerBuffer_ zeros for missing input buffers
+        std::vector<float> mixStorage;              // outputChannels x maxFramesPerBuffer_
+        std::vector<const float*> inputPointers;    // valid for the current slice
+        std::vector<float*> mixPointers;
+        std::vector<const float*> outputPointers;   // valid for the current slice
+    };
+
+    /**
+     * @brief Conversion graph stage 2: resampling of one channel node to one rate
+     *
+     * Shared by every destination with the same (channels, rate). Its output buffer
+     * list is handed to all of them by reference, stamped on the output timeline:
+     * mSampleTime counts output frames (input sample time scaled by the rate ratio)
+     * and both it and mHostTime refer to the first output frame, resampler group
+     * delay and phase included.
+     *
+     * Drift-compensated nodes belong to a single destination and are never shared:
+     * the estimator steers their ratio toward that destination's clock.
+     */
+    struct RateNode {
+        std::shared_ptr<ChannelNode> source;
+        double sampleRate;
+        PolyphaseResampler resampler;
+        double rateRatio;                           // output rate / input rate
+        double hostTicksPerInputFrame;
+        UInt32 outputCapacity;
+        UInt32 producedFrames;                      // valid for the current slice
+        AudioTimeStamp outputTimeStamp;             // valid for the current slice
+        std::vector<float> outputStorage;           // channels x outputCapacity
+        std::vector<float*> outputPointers;
+        std::vector<uint8_t> outputListStorage;     // AudioBufferList with one buffer per channel
+        AudioBufferList* outputList;
+        std::unique_ptr<DriftEstimator> drift;      // null unless drift-compensated
+        std::function<double()> fillLevel;          // drift-compensated fill-level mode only
+        UInt32 fadeFrames;                          // Fade-in length after Reconfigure(), 0 = none
+        UInt32 fadePosition;                        // Output frames faded in so far
+    };
+
+    /**
+     * @brief Writes planar float into a destination's own sample layout
+     *
+     * Only for converted destinations whose format is not planar float32. The kernel
+     * is specialized on sample type, channel count and interleaving and picked when
+     * the destination is added. Runs right before the callback, on whichever thread
+     * invokes it.
+     */
+    struct Formatter {
+        SampleLayout layout;
+        SampleKernels::WriteKernel kernel;
+        UInt32 maxFrames;
+        std::vector<uint8_t> storage;               // layout.BufferCount() x maxFrames x BytesPerFrame()
+        std::vector<void*> bufferPointers;
+        std::vector<uint8_t> listStorage;
+        AudioBufferList* list;
+    };
+
+    /**
+     * @brief Asynchronous delivery for one destination: ring plus consumer thread
+     *
+     * The audio thread only pushes into the ring and signals the semaphore. The
+     * consumer copies blocks out into its own buffers and runs the callback.
+     * Destroyed (thread joined) on a configuration thread once no table refers to it.
+     */
+    struct AsyncDelivery {
+        AudioBlockRing ring;
+        std::shared_ptr<OutputDestination> destination;
+        dispatch_semaphore_t wakeup;
+        std::atomic<bool> running;
+        std::atomic<uint64_t> deliveredBlocks;
+        std::vector<uint8_t> consumerStorage;
+        std::vector<uint8_t> consumerListStorage;
+        AudioBufferList* consumerList;
+        std::shared_ptr<Reblocker> reblocker;      // null unless fixed-size blocks were requested
+        std::shared_ptr<Formatter> formatter;      // null for planar float destinations
+        std::thread worker;
+        
+        AsyncDelivery();
+        ~AsyncDelivery();
+        void Run();
+        void DeliverQueued();
+    };
+
+    /**
+     * @brief Per-destination DSP: the chain plus the buffers it writes into
+     *
+     * Reads the delivered audio (shared with other destinations) and writes the
+     * processed copy into its own planar storage, in slices of at most maxFrames.
+     */
+    struct Effects {
+        DspChain chain;
+        UInt32 maxFrames;
+        double hostTicksPerFrame;
+        std::vector<float> storage;                 // channels x maxFrames
+        std::vector<const float*> inputPointers;
+        std::vector<float*> outputPointers;
+        std::vector<uint8_t> listStorage;
+        AudioBufferList* list;
+    };
+
+    /**
+     * @brief Immutable snapshot of the enabled destinations read by the audio thread
+     *
+     * Lists only the graph nodes some enabled destination consumes, each once, so
+     * per-callback cost scales with the number of distinct formats. Holds its own
+     * references so a snapshot stays valid after the registry drops them, until RCU
+     * reclamation frees it. Carries the input description the nodes were built for,
+     * so the audio thread never reads configuration that Reconfigure() rewrites.
+     */
+    struct DestinationTable {
+        struct Entry {
+            std::shared_ptr<OutputDestination> destination;
+            const RateNode* node;                   // null for passthrough; owned via rateNodes
+            std::shared_ptr<AsyncDelivery> async;   // null for inline delivery
+            std::shared_ptr<Reblocker> reblocker;   // inline fixed-size delivery only
+            std::shared_ptr<Effects> effects;       // null without a DSP chain
+            std::shared_ptr<Formatter> formatter;   // inline delivery only; null for planar float
+        };
+        SampleLayout inputLayout;
+        UInt32 maxFrames;                           // Slice size the nodes were allocated for
+        std::vector<std::shared_ptr<ChannelNode>> channelNodes;
+        std::vector<std::shared_ptr<RateNode>> rateNodes;
+        std::vector<Entry> entries;
+    };
+
+    /**
+     * @brief Registry record: a destination bound to the conversion it asked for
+     */
+    struct Registration {
+        std::shared_ptr<OutputDestination> destination;
+        std::shared_ptr<RateNode> conversion;      // null for passthrough
+        std::shared_ptr<AsyncDelivery> async;      // null for inline delivery
+        std::shared_ptr<Reblocker> reblocker;      // null unless delivery.blockFrames is set
+        std::shared_ptr<Effects> effects;          // null until the destination gets a DSP chain
+        std::shared_ptr<Formatter> formatter;      // null unless the destination wants another layout
+        std::shared_ptr<AudioFileWriter> recorder; // recording destinations only; also held by the callback
+    };
+
+    std::atomic<bool> isInitialized_;
     AVAudioFormat* inputFormat_;
+    SampleLayout inputLayout_;
+    UInt32 maxFramesPerBuffer_;
     
-    // Output destinations
-    std::vector<std::unique_ptr<OutputDestination>> destinations_;
+    // Destination registry (guarded by destinationsMutex_): O(1) lookup by ID,
+    // fan-out in insertion order
+    std::unordered_map<int, Registration> registry_;
+    std::vector<int> destinationOrder_;
     int nextDestinationId_;
     
-    // Audio format converters for different output formats
-    std::map<int, AVAudioConverter*> formatConverters_;
+    // Conversion graph nodes by format, shared while any registration holds them
+    std::map<std::vector<float>, std::weak_ptr<ChannelNode>> channelNodes_;
+    std::map<std::pair<const ChannelNode*, double>, std::weak_ptr<RateNode>> rateNodes_;
+    
+    // Published snapshot for ProcessAudioBuffer
+    RcuPointer<DestinationTable> destinationTable_;
     
-    // Performance monitoring
-    mutable std::mutex statsMutex_;
-    uint64_t totalFramesProcessed_;
-    std::chrono::high_resolution_clock::time_point lastProcessTime_;
-    double totalProcessingTime_;
+    // Performance monitoring (written by the audio thread only)
+    std::atomic<uint64_t> totalFramesProcessed_;
+    std::atomic<int64_t> lastProcessTimeNs_;
+    std::atomic<uint64_t> totalProcessingTimeNs_;
+    std::atomic<uint64_t> formatMismatches_;
+    uint32_t reconfigurations_;             // Guarded by destinationsMutex_
     
-    // Thread safety
+    // Thread safety: serializes configuration changes, never taken by the audio thread
     mutable std::mutex destinationsMutex_;
     
     // Helper methods
-    AVAudioFormat* CreateTranscriptionFormat() const;
-    AVAudioFormat* CreateChannelFormat(int channelCount) const;
-    void ConvertAndSendToDestination(
-        const OutputDestination& dest,
+    void PublishDestinationTable();
+    int RegisterDestination(std::unique_ptr<OutputDestination> destination);
+    void SetInputFormat(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer);
+    bool IsSupportedFormat(AVAudioFormat* format) const;
+    bool NeedsConversion(const OutputDestination& destination) const;
+    bool BuildDelivery(Registration& registration, const Registration* previous);
+    bool RebindDestination(
+        Registration& registration,
+        const Registration& previous,
+        AVAudioFormat* previousFormat,
+        UInt32 previousChannels
+    );
+    std::shared_ptr<RateNode> AcquireConversion(
+        AVAudioFormat* outputFormat,
+        const std::vector<float>& routing,
+        const DeliveryOptions& delivery
+    );
+    std::shared_ptr<ChannelNode> AcquireChannelNode(UInt32 outputChannels, const std::vector<float>& gains);
+    void RunChannelNode(
+        ChannelNode& node,
+        const SampleLayout& inputLayout,
+        const AudioBufferList& bufferList,
+        UInt32 offset,
+        UInt32 frames
+    ) const;
+    std::shared_ptr<AsyncDelivery> StartAsyncDelivery(
+        const std::shared_ptr<OutputDestination>& destination,
+        const RateNode* conversion,
+        std::shared_ptr<Reblocker> reblocker,
+        std::shared_ptr<Formatter> formatter
+    ) const;
+    std::shared_ptr<Formatter> CreateFormatter(
+        const OutputDestination& destination,
+        const RateNode* conversion
+    ) const;
+    static SampleLayout LayoutOf(AVAudioFormat* format);
+    std::shared_ptr<Reblocker> CreateReblocker(
+        const OutputDestination& destination,
+        const RateNode* conversion
+    ) const;
+    void UpdateDrift(RateNode& node, UInt32 inputFrames) const;
+    static void ApplyFadeIn(RateNode& node);
+    void StampRateNode(
+        RateNode& node,
+        const AudioTimeStamp& timeStamp,
+        UInt32 offset,
+        double outputPosition
+    ) const;
+    std::shared_ptr<Effects> CreateEffects(
+        const OutputDestination& destination,
+        const RateNode* conversion
+    ) const;
+    static void Deliver(
+        const DestinationTable::Entry& entry,
         const AudioBufferList& bufferList,
         const AudioTimeStamp& timeStamp
     );
+    static void DeliverWithEffects(
+        const DestinationTable::Entry& entry,
+        const AudioBufferList& bufferList,
+        const AudioTimeStamp& timeStamp
+    );
+    static void HandOff(
+        const DestinationTable::Entry& entry,
+        const AudioBufferList& bufferList,
+        const AudioTimeStamp& timeStamp
+    );
+    static void DeliverReblocked(
+        Reblocker& reblocker,
+        const OutputDestination& destination,
+        Formatter* formatter,
+        const AudioBufferList& bufferList,
+        const AudioTimeStamp& timeStamp
+    );
+    static void InvokeCallback(
+        const OutputDestination& destination,
+        Formatter* formatter,
+        const AudioBufferList& bufferList,
+        const AudioTimeStamp& timeStamp
+    );
+    void RunConversionGraph(
+        const DestinationTable& table,
+        const AudioBufferList& bufferList,
+        const AudioTimeStamp& timeStamp
+    ) const;
+    AVAudioFormat* CreateTranscriptionFormat() const;
+    AVAudioFormat* CreateChannelFormat(int channelCount, double sampleRate = 0.0) const;
     
     // Cleanup
     void CleanupConverters();
 };
 
-} // namespace Prezefren
\ No newline at end of file
+} // namespace Prezefren
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "SeqLock.h"
+#include <cstdint>
+
+namespace Prezefren {
+
+/**
+ * @brief Sample clock of a virtual device, anchored to host time
+ *
+ * The device has no hardware behind it, so its clock is derived from the audio fed
+ * to it: a second-order delay-locked loop follows the feed's timestamps (sample
+ * time against host time, i.e. the capture clock carried onto the device's rate)
+ * and smooths their jitter into a rate in host ticks per frame. The published
+ * timeline is a straight line through an anchor with that slope. Each update
+ * re-anchors at the current position, so the timeline stays continuous while its
+ * rate follows the loop, and keeps running at the last rate while the feed is
+ * stalled.
+ *
+ * Zero timestamps fall on multiples of the period along that timeline. Update()
+ * is for one thread (the feed) and wait-free; the readers may run on any thread
+ * and never block it.
+ */
+class DeviceClock {
+public:
+    static constexpr double kDefaultBandwidthHz = 0.1;
+    static constexpr double kMaxDeviationPpm = 1000.0;  // Clamp on the measured rate
+
+    struct Timeline {
+        double anchorSampleTime;
+        double anchorHostTime;
+        double hostTicksPerFrame;
+        uint64_t seed;
+    };
+
+    DeviceClock();
+
+    /**
+     * @brief Set the nominal rate and period (not real-time safe)
+     * @param periodFrames Frames between zero timestamps
+     * @param bandwidthHz Loop bandwidth: lower is smoother, higher follows faster
+     */
+    void Configure(double sampleRate, uint32_t periodFrames, double hostTicksPerSecond,
+                   double bandwidthHz = kDefaultBandwidthHz);
+
+    /**
+     * @brief Start a new timeline at sample time 0 (before the feed runs)
+     *
+     * Changes the seed, telling clients that earlier timestamps no longer apply.
+     */
+    void Start(uint64_t hostTime);
+
+    /**
+     * @brief Observe fed audio: its first frame's sample time and host time (feed thread)
+     *
+     * Gaps, backward jumps and outliers reset the loop's reference without moving
+     * the timeline.
+     */
+    void Update(double sampleTime, uint64_t hostTime);
+
+    /**
+     * @brief Most recent zero timestamp at or before now
+     */
+    void GetZeroTimeStamp(uint64_t now, double& sampleTime, uint64_t& hostTime, uint64_t& seed) const;
+
+    /**
+     * @brief Device sample time at the given host time
+     */
+    double GetSampleTime(uint64_t hostTime) const;
+
+    /**
+     * @brief Measured rate over nominal, e.g. 1.0001 for a feed 100 ppm fast
+     */
+    double GetRateScalar() const;
+
+    uint32_t GetPeriod() const { return periodFrames_; }
+
+private:
+    double sampleRate_;
+    uint32_t periodFrames_;
+    double nominalTicksPerFrame_;
+    double bandwidthHz_;
+    uint64_t seed_;
+
+    // Loop state (feed thread only)
+    bool hasReference_;
+    double referenceSampleTime_;
+    double referenceHostTime_;          // Filtered host time of referenceSampleTime_
+    double ticksPerFrame_;
+
+    SeqLock<Timeline> timeline_;
+
+    static double PositionAt(const Timeline& timeline, double hostTime);
+};
+
+} // namespace Prezefren
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Declarative description of one virtual device
+ *
+ * The Driver instantiates a list of these, one VirtualDevice each, fed from the
+ * splitter through its own routing and rate conversion. A panel with eight
+ * microphones is eight specs selecting input channels 0..7, not eight device types.
+ *
+ * The uid identifies a device across topology updates: a spec whose uid, name,
+ * rate and channel count are unchanged keeps its device (and its clients) even if
+ * its routing changes.
+ */
+struct DeviceSpec {
+    enum class Source {
+        Channels,       // Device channel c carries input channel channelMap[c]
+        Downmix         // Every device channel carries the equal mix of all inputs
+    };
+
+    /**
+     * @brief In-process callback that also receives the device's audio
+     */
+    enum class Consumer {
+        None,
+        Transcription,  // Driver::SetTranscriptionCallback()
+        Passthrough     // Driver::SetPassthroughCallback()
+    };
+
+    static constexpr uint32_t kMaxChannels = 64;
+
+    std::string uid;                    // Stable and unique, e.g. "com.prezefren.virtualaudio.mic3"
+    std::string name;                   // Shown to apps
+    double sampleRate = 48000.0;
+    uint32_t channels = 1;
+    Source source = Source::Channels;
+    std::vector<int> channelMap;        // Channels only: input per device channel, -1 = silent; empty = in order
+    Consumer consumer = Consumer::None;
+
+    /**
+     * @brief Routing matrix from an input with this many channels
+     *
+     * Mapped inputs the input does not have are silent until it does. An empty map
+     * takes the inputs in order and repeats the last one, and a mono device of a
+     * multichannel input gets the downmix.
+     */
+    std::vector<float> RoutingFor(uint32_t inputChannels) const;
+
+    /**
+     * @brief True if a device built for one spec can serve the other unchanged
+     */
+    bool SameDevice(const DeviceSpec& other) const;
+
+    /**
+     * @brief True if the splitter feed for one spec can serve the other unchanged
+     */
+    bool SameRouting(const DeviceSpec& other) const;
+};
+
+/**
+ * @brief What it takes to turn one topology into another, by uid
+ */
+struct TopologyChanges {
+    std::vector<std::string> removed;       // Devices to tear down
+    std::vector<DeviceSpec> added;          // Devices to create, including recreated ones
+    std::vector<DeviceSpec> rerouted;       // Devices that stay, with a new feed
+};
+
+/**
+ * @brief Check a topology before applying it
+ * @return false with a reason if a uid is empty or repeated, or a spec's rate,
+ *         channel count or channel map is invalid
+ */
+bool ValidateTopology(const std::vector<DeviceSpec>& specs, std::string& error);
+
+/**
+ * @brief Changes between two valid topologies
+ *
+ * A spec whose device properties changed is removed and added again; one whose
+ * routing or consumer changed is rerouted. Additions keep the order of the new list.
+ */
+TopologyChanges DiffTopology(const std::vector<DeviceSpec>& from, const std::vector<DeviceSpec>& to);
+
+} // namespace Prezefren
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Prezefren {
+
+/**
+ * @brief Tracks the drift between a producer and a consumer clock
+ *
+ * The capture device and the virtual devices tick on different clocks, so over a long
+ * session one side slowly gains on the other. The estimator watches the consumer's
+ * fill level (frames produced but not yet consumed) and steers it back to a target
+ * with a critically damped PI loop. The integral term converges on the clock drift
+ * itself; the output is a ratio adjustment for PolyphaseResampler::SetRatioAdjustment().
+ *
+ * The fill level comes either from the consumer (UpdateFillLevel) or, when the consumer
+ * runs on the host clock at its nominal rate, from timestamps (UpdateTimeStamp): frames
+ * produced so far minus the frames the consumer has asked for since the first update.
+ *
+ * Updates come from one thread (the audio thread) and never allocate or lock. The
+ * published estimate may be read from any thread.
+ */
+class DriftEstimator {
+public:
+    DriftEstimator();
+
+    /**
+     * @brief Set the consumer rate, host timebase and fill target, and reset the loop
+     * @param outputRate Consumer sample rate
+     * @param hostTicksPerSecond Host clock ticks per second (timestamp mode)
+     * @param targetFrames Fill level to hold (fill-level mode); timestamp mode holds 0
+     * @param maxAdjustment Largest correction, as a fraction of the nominal ratio
+     */
+    void Configure(double outputRate, double hostTicksPerSecond, double targetFrames, double maxAdjustment);
+
+    /**
+     * @brief Forget the anchor and the loop state (e.g. after the stream restarts)
+     */
+    void Reset();
+
+    /**
+     * @brief Timestamp mode: account for produced frames at a host time
+     * @param hostTime Host time of the first of the frames just produced
+     * @param producedFrames Frames produced at that instant
+     */
+    void UpdateTimeStamp(uint64_t hostTime, uint32_t producedFrames);
+
+    /**
+     * @brief Fill-level mode: observe the consumer's backlog
+     * @param queuedFrames Frames produced but not yet consumed
+     * @param elapsedSeconds Time covered since the previous update
+     */
+    void UpdateFillLevel(double queuedFrames, double elapsedSeconds);
+
+    /**
+     * @brief Input consumed per output frame relative to nominal; above 1 when the producer runs fast
+     */
+    double GetRatioAdjustment() const { return adjustment_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Estimated producer clock drift relative to the consumer, in parts per million
+     */
+    double GetDriftPpm() const { return driftPpm_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Smoothed deviation from the target fill level, in seconds
+     */
+    double GetFillError() const { return fillError_.load(std::memory_order_relaxed); }
+
+    // Loop time constants: proportional correction over kProportionalSeconds, integral
+    // at twice that for critical damping. Long enough to average away callback jitter.
+    static constexpr double kProportionalSeconds = 10.0;
+    static constexpr double kSmoothingSeconds = 1.0;
+    static constexpr double kMaxUpdateGapSeconds = 0.5;     // Longer gaps re-anchor
+
+private:
+    double outputRate_;
+    double hostTicksPerSecond_;
+    double targetFrames_;
+    double maxAdjustment_;
+
+    // Timestamp mode anchor
+    bool anchored_;
+    uint64_t anchorHostTime_;
+    uint64_t lastHostTime_;
+    double producedFrames_;
+
+    // Loop state (audio thread only)
+    double smoothedError_;      // Seconds
+    double drift_;              // Integral term, fraction of nominal ratio
+
+    std::atomic<double> adjustment_;
+    std::atomic<double> driftPpm_;
+    std::atomic<double> fillError_;
+
+    void Step(double errorSeconds, double elapsedSeconds);
+};
+
+} // namespace Prezefren
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "RcuPointer.h"
+
+namespace Prezefren {
+
+/**
+ * @brief Ordered chain of DSP stages run fused over planar float audio
+ *
+ * Stages (gain, high-pass, pre-emphasis, noise gate, AGC, limiter) run in order over
+ * short tiles of kTileFrames frames, so each sample is read from and written to main
+ * memory once however long the chain is: the first stage reads the input, the rest
+ * work in place on a tile that stays in L1.
+ *
+ * SetStages() compiles parameters into coefficients off the audio thread and publishes
+ * them through an RcuPointer, so the chain can be changed while audio runs without a
+ * lock. Filter and envelope state survives a change as long as the stage at that
+ * position keeps its type.
+ *
+ * Configure() and SetStages() allocate; Process() never allocates or locks and must
+ * only be called from one thread. Plain C++ with no Apple dependencies.
+ */
+class DspChain {
+public:
+    enum class StageType {
+        Gain,           // Linear gain
+        HighPass,       // Second-order Butterworth high-pass
+        Emphasis,       // x + amount * (x - x[-1]), restores codec-dulled highs
+        NoiseGate,      // Attenuates while the envelope stays below threshold
+        Agc,            // Steers the envelope toward level, gain capped at maxGain
+        Limiter         // Hard clip at +-ceiling
+    };
+
+    /**
+     * @brief One stage; only the fields its type uses are read
+     */
+    struct Stage {
+        StageType type = StageType::Gain;
+        float gain = 1.0f;              // Gain
+        float frequency = 80.0f;        // HighPass cutoff in Hz
+        float amount = 0.0f;            // Emphasis
+        float threshold = 0.002f;       // NoiseGate open level; Agc floor below which gain holds
+        float attenuation = 0.5f;       // NoiseGate gain while closed
+        float level = 0.1f;             // Agc target envelope
+        float maxGain = 2.0f;           // Agc
+        float attackMs = 5.0f;          // NoiseGate/Agc envelope
+        float releaseMs = 200.0f;       // NoiseGate/Agc envelope and Agc gain
+        float ceiling = 1.0f;           // Limiter
+
+        static Stage MakeGain(float gain);
+        static Stage MakeHighPass(float frequency);
+        static Stage MakeEmphasis(float amount);
+        static Stage MakeNoiseGate(float threshold, float attenuation);
+        static Stage MakeAgc(float level, float maxGain, float floor);
+        static Stage MakeLimiter(float ceiling);
+    };
+
+    static constexpr uint32_t kMaxStages = 16;
+    static constexpr uint32_t kTileFrames = 64;
+
+    DspChain();
+
+    /**
+     * @brief Allocate state for a channel count and rate (not real-time safe)
+     * @return false if channels or sampleRate is zero
+     */
+    bool Configure(uint32_t channels, double sampleRate);
+
+    /**
+     * @brief Replace the stage list; takes effect at the next Process() call
+     * @return false if not configured, too many stages, or a parameter is out of range
+     */
+    bool SetStages(const std::vector<Stage>& stages);
+
+    /**
+     * @brief Run the chain
+     * @param input One pointer per channel
+     * @param output One pointer per channel; may equal input for in-place processing
+     */
+    void Process(const float* const* input, float* const* output, uint32_t frames);
+
+    /**
+     * @brief Clear filter and envelope state (processing thread only)
+     */
+    void Reset();
+
+    /**
+     * @brief The single-earbud / Bluetooth conditioning the Swift engine applies
+     *
+     * Same order and strengths as applySingleEarbudOptimizations, with its per-sample
+     * thresholding replaced by envelope-driven gate and AGC stages.
+     */
+    static std::vector<Stage> SingleEarbudPreset(bool bluetooth);
+
+    bool IsConfigured() const { return channels_ > 0; }
+    uint32_t GetChannelCount() const { return channels_; }
+    size_t GetStageCount() const;
+
+private:
+    /**
+     * @brief A stage with its parameters turned into per-sample coefficients
+     */
+    struct CompiledStage {
+        StageType type;
+        float gain;             // Gain, NoiseGate closed gain, Agc max gain, Limiter ceiling
+        float b0, b1, b2, a1, a2;
+        float threshold;
+        float level;            // Agc target, Emphasis amount
+        float attack;           // One-pole coefficients
+        float release;
+        float smoothing;
+    };
+
+    struct Program {
+        std::vector<CompiledStage> stages;
+    };
+
+    /**
+     * @brief Per stage and channel, owned by the processing thread
+     */
+    struct StageState {
+        StageType type;
+        bool valid;
+        float x1, x2, y1, y2;
+        float envelope;
+        float gain;
+    };
+
+    uint32_t channels_;
+    double sampleRate_;
+    std::vector<StageState> state_;     // kMaxStages x channels_
+    RcuPointer<Program> program_;
+    mutable std::mutex writerMutex_;    // Serializes SetStages; never taken by Process
+
+    bool Compile(const Stage& stage, CompiledStage& compiled) const;
+    float OnePole(float milliseconds) const;
+    static void ResetState(StageState& state, StageType type);
+    static void RunStage(const CompiledStage& stage, StageState& state, float* samples, uint32_t frames);
+};
+
+} // namespace Prezefren
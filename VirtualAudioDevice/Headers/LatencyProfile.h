@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Prezefren {
+
+/**
+ * @brief Buffer sizes along the capture-to-device path, chosen together
+ *
+ * One profile sets every size that adds latency between a captured frame and the
+ * moment a device client reads it: the capture tap's buffer, the splitter's
+ * conversion slices, the device rings and their backlog, and the blocks client
+ * callbacks receive. The Driver hands it to the splitter and to every VirtualDevice
+ * it creates, so the sizes cannot disagree with one another.
+ *
+ * Frame counts are at whichever rate the stage runs at: the tap and converter
+ * slices at the capture rate, the device buffers at each device's rate.
+ */
+struct LatencyProfile {
+    const char* name;
+    uint32_t ioBufferFrames;            // Capture tap buffer and device IO buffer
+    uint32_t converterBlockFrames;      // Largest slice the splitter converts at once
+    uint32_t deviceRingBuffers;         // Device stream ring capacity, in IO buffers
+    uint32_t deviceLatencyBuffers;      // Backlog device clients keep behind the feed, in IO buffers
+    double clientBlockMilliseconds;     // Fixed block size for client callbacks, 0 = as converted
+    uint32_t clientRingBlocks;          // Queue depth of asynchronous client callbacks
+
+    /**
+     * @brief Smallest buffers the path runs reliably with: 256-frame IO, one buffer of backlog
+     */
+    static LatencyProfile LowLatency();
+
+    /**
+     * @brief Headroom for busy systems: 512-frame IO, two buffers of backlog, 20 ms client blocks
+     */
+    static LatencyProfile Balanced();
+
+    uint32_t DeviceRingFrames() const { return ioBufferFrames * deviceRingBuffers; }
+    uint32_t DeviceLatencyFrames() const { return ioBufferFrames * deviceLatencyBuffers; }
+
+    /**
+     * @brief Upper bound on capture-to-client latency, conversion delay excluded
+     *
+     * A tap buffer is complete before it is fed, and a client reads up to the backlog
+     * plus one IO buffer behind the newest frame. Where a read falls between feeds
+     * decides how much of that a given frame sees.
+     */
+    double MaximumLatencySeconds(double captureRate, double deviceRate) const;
+
+    bool operator==(const LatencyProfile& other) const;
+    bool operator!=(const LatencyProfile& other) const { return !(*this == other); }
+};
+
+} // namespace Prezefren
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Stateful polyphase FIR resampler for planar float audio
+ *
+ * Converts between any two sample rates whose ratio reduces to L/M with L <= kMaxPhases
+ * (e.g. 48000 -> 16000 is 1/3, 44100 -> 16000 is 160/441). Filter history and phase are
+ * carried across calls, so splitting a stream into buffers of any size yields the same
+ * output as processing it in one piece.
+ *
+ * ConfigureAdaptive() instead sets up a variable-ratio mode for clock-drift compensation:
+ * a dense bank of kAdaptivePhases phases, interpolated linearly between neighbours, so the
+ * nominal ratio can be trimmed by SetRatioAdjustment() at any time without a discontinuity.
+ *
+ * Configure() allocates everything; Process() and Reset() never allocate or lock and are
+ * safe to call from the audio thread. The inner dot product uses AVX, SSE or NEON when
+ * the target supports it and falls back to scalar code otherwise.
+ *
+ * Plain C++ with no Apple dependencies so it can be built, tested and profiled anywhere.
+ */
+class PolyphaseResampler {
+public:
+    /**
+     * @brief Filter length per phase: trades CPU for stopband rejection
+     */
+    enum class Quality {
+        Low,        // 16 taps per phase
+        Medium,     // 32 taps per phase
+        High        // 64 taps per phase
+    };
+
+    static constexpr uint32_t kMaxPhases = 4096;
+    static constexpr uint32_t kAdaptivePhases = 256;
+    static constexpr double kMaxRatioAdjustment = 0.005;    // +-5000 ppm
+
+    PolyphaseResampler();
+
+    /**
+     * @brief Design the filter bank and allocate state
+     * @param inputRate Input sample rate in Hz (integral)
+     * @param outputRate Output sample rate in Hz (integral)
+     * @param channels Number of planar channels processed together
+     * @param maxInputFrames Largest input block handled in one internal pass
+     * @param quality Filter length
+     * @return false if the rates are invalid or the reduced ratio needs too many phases
+     */
+    bool Configure(double inputRate, double outputRate, uint32_t channels,
+                   uint32_t maxInputFrames, Quality quality = Quality::Medium);
+
+    /**
+     * @brief Design a variable-ratio resampler (any positive rates, including equal ones)
+     * @return false if the rates or sizes are invalid
+     */
+    bool ConfigureAdaptive(double inputRate, double outputRate, uint32_t channels,
+                           uint32_t maxInputFrames, Quality quality = Quality::Medium);
+
+    /**
+     * @brief Trim the conversion ratio (adaptive mode only)
+     * @param adjustment Factor on the input consumed per output frame; above 1 when the
+     *        source clock runs fast. Clamped to 1 +- kMaxRatioAdjustment. Takes effect
+     *        from the next output frame.
+     */
+    void SetRatioAdjustment(double adjustment);
+    double GetRatioAdjustment() const { return ratioAdjustment_; }
+
+    /**
+     * @brief Resample one block
+     * @param input One pointer per channel, inputFrames samples each
+     * @param inputFrames Number of input frames (any size; large blocks are processed in passes)
+     * @param output One pointer per channel with room for MaxOutputFrames(inputFrames) samples
+     * @param outputCapacity Capacity of each output channel in frames
+     * @return Number of frames written per channel
+     */
+    uint32_t Process(const float* const* input, uint32_t inputFrames,
+                     float* const* output, uint32_t outputCapacity);
+
+    /**
+     * @brief Clear filter history and phase (e.g. after a discontinuity)
+     */
+    void Reset();
+
+    /**
+     * @brief Upper bound of frames Process() can produce for a given input size
+     */
+    uint32_t MaxOutputFrames(uint32_t inputFrames) const;
+
+    /**
+     * @brief Group delay of the filter, in input frames
+     */
+    double GetDelayInputFrames() const;
+
+    /**
+     * @brief Where the next output frame lands on the input timeline
+     * @return Position in input frames relative to the first frame of the next Process()
+     *         input, group delay included (typically negative). Successive outputs follow
+     *         at GetInputStep() input frames apart.
+     */
+    double GetNextOutputPosition() const;
+
+    /**
+     * @brief Input frames consumed per output frame, adjustment included
+     */
+    double GetInputStep() const;
+
+    bool IsConfigured() const { return configured_; }
+    bool IsAdaptive() const { return adaptive_; }
+    bool IsPassthrough() const { return configured_ && !adaptive_ && upFactor_ == 1 && downFactor_ == 1; }
+    uint32_t GetUpFactor() const { return upFactor_; }
+    uint32_t GetDownFactor() const { return downFactor_; }
+    uint32_t GetChannelCount() const { return channels_; }
+    uint32_t GetTapsPerPhase() const { return tapsPerPhase_; }
+
+private:
+    bool configured_;
+    bool adaptive_;
+    uint32_t channels_;
+    uint32_t maxInputFrames_;
+    uint32_t upFactor_;      // L
+    uint32_t downFactor_;    // M
+    uint32_t tapsPerPhase_;  // K, multiple of 8 for the SIMD kernels
+
+    // Phase-major filter bank, each phase reversed so a phase dots contiguous history
+    std::vector<float> bank_;
+
+    // Per channel: K-1 samples of history followed by up to maxInputFrames_ new samples
+    std::vector<float> history_;
+    uint32_t historyStride_;
+
+    // Position of the next output sample: input index (relative to the current block) and phase
+    int64_t inputIndex_;
+    uint32_t phase_;
+
+    // Adaptive mode: fractional position of the next output and the step between outputs
+    double nominalStep_;
+    double ratioAdjustment_;
+    double position_;
+
+    uint32_t ProcessPass(const float* const* input, uint32_t inputOffset, uint32_t inputFrames,
+                         float* const* output, uint32_t outputOffset, uint32_t outputCapacity);
+    uint32_t ProcessAdaptivePass(const float* const* input, uint32_t inputOffset, uint32_t inputFrames,
+                                 float* const* output, uint32_t outputOffset, uint32_t outputCapacity);
+    void AllocateHistory(uint32_t channels, uint32_t maxInputFrames);
+    void DesignFilter(double cutoff, double kaiserBeta, uint32_t bankPhases);
+};
+
+} // namespace Prezefren
@@ -3,7 +3,12 @@
 #include <aspl/aspl.hpp>
 #include "PrezefrenVirtualDevice.h"
 #include "AudioSplitter.h"
+#include "DeviceTopology.h"
+#include "SharedAudioRing.h"
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace Prezefren {
@@ -14,6 +19,15 @@ namespace Prezefren {
  * This driver manages virtual audio devices and provides an alternative
  * audio architecture that can coexist with the current AudioEngine approach.
  * It's designed to be opt-in and non-disruptive to existing functionality.
+ *
+ * The devices are a declarative topology: a list of DeviceSpec, each instantiated
+ * as a VirtualDevice with its own splitter feed. UpdateTopology() applies a new
+ * list incrementally, leaving devices whose spec did not change untouched.
+ *
+ * The HAL loads the plugin into coreaudiod while capture runs in the app, so the
+ * two halves can run as separate drivers joined by a SharedAudioRing per device
+ * (see Configuration::transport): the app's driver splits and converts, the
+ * plugin's driver publishes the devices and feeds each from its ring.
  */
 class Driver : public aspl::Driver {
 public:
@@ -21,19 +35,33 @@ public:
      * @brief Configuration for virtual audio system
      */
     struct Configuration {
+        /**
+         * @brief Where the devices live relative to the capture
+         */
+        enum class Transport {
+            InProcess,              // Splitter feeds devices in this process
+            SharedMemoryProducer,   // App: splitter feeds go to each device's shared ring; no devices here
+            SharedMemoryConsumer    // Plugin: devices are fed from their shared rings; no splitter here
+        };
+        
         bool enableVirtualAudio = false;           // Master switch for virtual audio
+        Transport transport = Transport::InProcess;   // Fixed for the driver's lifetime
+        
+        // Device topology: explicit specs, or (when empty) the standard set below
+        std::vector<DeviceSpec> devices;
         bool enableTranscriptionDevice = true;    // Create transcription-optimized device
         bool enablePassthroughDevice = true;      // Create passthrough mirror device
         bool enableStereoSeparation = false;      // Create separate L/R devices
         Float64 transcriptionSampleRate = 16000;  // Optimal for speech recognition
         Float64 passthroughSampleRate = 48000;    // High quality for passthrough
         
-        // Device naming
+        // Device naming (standard set)
         std::string devicePrefix = "Prezefren";
         
         // Performance settings
-        UInt32 bufferFrameSize = 512;             // Balance latency vs performance
+        LatencyProfile latencyProfile = LatencyProfile::Balanced();   // Buffer sizes from tap to device clients
         bool enableStatistics = true;             // Performance monitoring
+        bool enableDriftCompensation = true;      // Follow each device's clock with adaptive resampling
     };
 
     Driver(const Configuration& config = Configuration{});
@@ -66,15 +94,51 @@ public:
      */
     void SetAudioSplitter(std::shared_ptr<AudioSplitter> splitter);
 
+    /**
+     * @brief Follow a change of capture format (e.g. the user switched input device)
+     * @param inputFormat Format the captured buffers arrive in from now on
+     * @param maxFramesPerBuffer Largest expected buffer, or 0 to keep the current size
+     * @return false if the splitter cannot convert from this format; it keeps the old one
+     *
+     * Renegotiates the splitter in place (see AudioSplitter::Reconfigure): devices,
+     * destinations and client callbacks stay connected.
+     * Takes the driver lock and allocates: call it from a control thread, not
+     * from the tap or IO thread.
+     */
+    bool SetInputFormat(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer = 0);
+
     /**
      * @brief Get available virtual devices
      */
     std::vector<std::shared_ptr<VirtualDevice>> GetVirtualDevices() const;
 
     /**
-     * @brief Get device by type
+     * @brief Get a device by the uid of its spec
+     */
+    std::shared_ptr<VirtualDevice> GetDevice(const std::string& uid) const;
+
+    /**
+     * @brief Replace the device topology
+     * @return false (with nothing changed) if the specs are invalid
+     *
+     * Removed devices are stopped and unpublished; added ones are created, fed and,
+     * while virtual audio is enabled, started. Devices whose name, rate or channel
+     * count changed are recreated; those with only new routing keep running and get
+     * a new feed. Everything else is left alone. An empty list restores the
+     * standard set.
+     */
+    bool UpdateTopology(const std::vector<DeviceSpec>& devices);
+
+    /**
+     * @brief Specs of the devices currently instantiated
      */
-    std::shared_ptr<VirtualDevice> GetDeviceByType(VirtualDevice::DeviceType type) const;
+    std::vector<DeviceSpec> GetTopology() const;
+
+    /**
+     * @brief The standard set from the configuration flags: transcription,
+     *        passthrough and, with stereo separation, left and right
+     */
+    static std::vector<DeviceSpec> StandardTopology(const Configuration& config);
 
     /**
      * @brief Set callback for transcription audio data
@@ -93,7 +157,12 @@ public:
         bool virtualAudioActive;
         size_t activeDevices;
         AudioSplitter::Statistics splitterStats;
-        std::vector<std::pair<VirtualDevice::DeviceType, bool>> deviceStatus;
+        // Per device, by uid
+        std::vector<std::pair<std::string, bool>> deviceStatus;
+        std::vector<std::pair<std::string, double>> deviceDriftPpm;  // Capture clock vs each device
+        LatencyProfile latencyProfile;
+        std::vector<std::pair<std::string, VirtualDevice::LatencyStatistics>> deviceLatency;   // Measured capture-to-client
+        std::vector<std::pair<std::string, double>> maximumLatency;  // Seconds the profile allows, conversion included
     };
     
     DriverStatistics GetStatistics() const;
@@ -120,33 +189,70 @@ private:
     bool isInitialized_;
     bool virtualAudioEnabled_;
     
-    // Virtual devices
-    std::vector<std::shared_ptr<VirtualDevice>> virtualDevices_;
-    std::shared_ptr<VirtualDevice> transcriptionDevice_;
-    std::shared_ptr<VirtualDevice> passthroughDevice_;
-    std::shared_ptr<VirtualDevice> leftChannelDevice_;
-    std::shared_ptr<VirtualDevice> rightChannelDevice_;
+    /**
+     * @brief Plugin side of the shared-memory transport for one device
+     *
+     * The worker waits on the device's ring and hands each readable region to the
+     * device as an interleaved buffer list pointing into the segment, so frames go
+     * from shared memory into the device ring with no copy in between. It opens the
+     * ring by name and reopens it whenever the app closes or replaces it.
+     */
+    struct SharedFeed {
+        std::string ringName;
+        DeviceSpec spec;
+        std::shared_ptr<VirtualDevice> device;
+        std::unique_ptr<SharedAudioRing> ring;     // Worker thread only
+        std::atomic<bool> running;
+        std::thread worker;
+        
+        SharedFeed(const DeviceSpec& deviceSpec, std::shared_ptr<VirtualDevice> virtualDevice);
+        ~SharedFeed();
+        void Run();
+        bool Attach();
+        void Drain();
+    };
+    
+    // Virtual devices, one per spec of the topology, in its order
+    struct DeviceEntry {
+        DeviceSpec spec;
+        std::shared_ptr<VirtualDevice> device;     // null for SharedMemoryProducer
+        std::shared_ptr<SharedAudioRing> ring;     // SharedMemoryProducer: where the device feed goes
+        std::shared_ptr<SharedFeed> sharedFeed;    // SharedMemoryConsumer: what feeds the device
+        int feedId = -1;            // Splitter destination feeding the device
+        int consumerFeedId = -1;    // Splitter destination feeding spec.consumer's callback
+    };
+    std::vector<DeviceEntry> devices_;
     
     // Audio processing
     std::shared_ptr<AudioSplitter> audioSplitter_;
     
-    // Callbacks for integration with existing system
+    // Callbacks for integration with existing system (driverMutex_; delivery threads get copies)
     std::function<void(const AudioBufferList&, const AudioTimeStamp&)> transcriptionCallback_;
     std::function<void(const AudioBufferList&, const AudioTimeStamp&)> passthroughCallback_;
     
     // Thread safety
     mutable std::mutex driverMutex_;
     
-    // Helper methods
+    // Helper methods (callers hold driverMutex_)
+    std::vector<DeviceSpec> ResolveTopology(const Configuration& config) const;
     void CreateVirtualDevices();
     void DestroyVirtualDevices();
     void SetupAudioSplitter();
     void ConnectDeviceCallbacks();
+    void UpdateDeviceLatencies();
+    void ApplyLatencyProfile();
+    bool ApplyTopology(const std::vector<DeviceSpec>& specs);
+    void FollowInputChannels(UInt32 previousChannels);
     
-    // Device factory methods
-    std::shared_ptr<VirtualDevice> CreateTranscriptionDevice();
-    std::shared_ptr<VirtualDevice> CreatePassthroughDevice();
-    std::shared_ptr<VirtualDevice> CreateChannelDevice(VirtualDevice::DeviceType type);
+    // Per-device steps
+    bool AddDeviceEntry(const DeviceSpec& spec);
+    void RemoveDeviceEntry(size_t index);
+    void ConnectDeviceEntry(DeviceEntry& entry);
+    void DisconnectDeviceEntry(DeviceEntry& entry);
+    void ConnectConsumerFeed(DeviceEntry& entry);
+    void ReconnectConsumerFeeds(DeviceSpec::Consumer consumer);
+    DeviceEntry* FindDeviceEntry(const std::string& uid);
+    std::function<void(const AudioBufferList&, const AudioTimeStamp&)> ConsumerCallback(DeviceSpec::Consumer consumer) const;
 };
 
 // C interface for plugin factory
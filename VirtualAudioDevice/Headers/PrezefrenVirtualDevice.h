@@ -2,8 +2,14 @@
 
 #include <aspl/aspl.hpp>
 #include <CoreAudio/CoreAudio.h>
+#include "DeviceClock.h"
+#include "LatencyProfile.h"
+#include "RcuPointer.h"
+#include "SeqLock.h"
+#include "StreamRingBuffer.h"
 #include <memory>
 #include <atomic>
+#include <string>
 
 namespace Prezefren {
 
@@ -12,32 +18,33 @@ namespace Prezefren {
  * 
  * Creates virtual input devices that can receive duplicated audio streams
  * for transcription processing while maintaining native passthrough quality.
+ *
+ * Audio fed to the device lands in a StreamRingBuffer that the HAL clients of the
+ * device read from, each with its own cursor, the latency profile's backlog behind
+ * the feed.
+ * The device's clock (zero timestamps, current time) is a DeviceClock locked to the
+ * feed's timestamps, so clients see the capture device's real rate rather than a
+ * nominal one.
  */
 class VirtualDevice : public aspl::Device {
 public:
-    /**
-     * @brief Device types supported by Prezefren
-     */
-    enum class DeviceType {
-        TranscriptionInput,  // Virtual input optimized for transcription (16kHz mono)
-        PassthroughMirror,   // Mirror device for native passthrough
-        StereoLeft,          // Left channel for dual-language processing
-        StereoRight          // Right channel for dual-language processing
-    };
-
     /**
      * @brief Construct a new Virtual Device
      * 
      * @param context The ASPL context
-     * @param type The type of virtual device to create
+     * @param name Name shown to apps
+     * @param uid Unique, stable identifier (also the base of the serial number)
      * @param sampleRate Sample rate for the device
      * @param channelCount Number of audio channels
+     * @param latencyProfile IO buffer size, ring size and the backlog clients read behind the feed
      */
     VirtualDevice(
         std::shared_ptr<aspl::Context> context,
-        DeviceType type,
+        const std::string& name,
+        const std::string& uid,
         Float64 sampleRate = 48000.0,
-        UInt32 channelCount = 2
+        UInt32 channelCount = 2,
+        const LatencyProfile& latencyProfile = LatencyProfile::Balanced()
     );
 
     virtual ~VirtualDevice() = default;
@@ -52,6 +59,9 @@ public:
     OSStatus GetZeroTimeStampPeriod(UInt32* outPeriod) const override;
     OSStatus GetIsRunning(Boolean* outIsRunning) const override;
     OSStatus GetLatency(UInt32 inDirection, UInt32* outLatency) const override;
+    OSStatus GetSafetyOffset(UInt32 inDirection, UInt32* outOffset) const override;
+    OSStatus GetBufferFrameSize(UInt32* outFrames) const override;
+    OSStatus GetBufferFrameSizeRange(AudioValueRange* outRange) const override;
 
     // Stream management
     OSStatus GetStreamConfiguration(UInt32 inDirection, AudioBufferList** outBufferList) const override;
@@ -60,25 +70,87 @@ public:
     OSStatus StartIO() override;
     OSStatus StopIO() override;
     OSStatus GetCurrentTime(AudioTimeStamp* outTime) const override;
+    OSStatus GetZeroTimeStamp(Float64* outSampleTime, UInt64* outHostTime, UInt64* outSeed) const override;
 
     // Custom methods for Prezefren
     /**
      * @brief Set the callback for receiving processed audio data
      * @param callback Function to call with audio data
+     *
+     * The swap is published atomically; a feed in progress finishes with the old
+     * callback, which is freed here on a later swap, never on the IO thread.
      */
     void SetAudioCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback);
 
     /**
      * @brief Feed audio data to this virtual device
-     * @param bufferList Audio data to process
+     * @param bufferList Float32 audio, planar or interleaved, at the device's rate
      * @param timeStamp Timing information
+     *
+     * Appends to the ring the device's clients read from and passes the buffer on to
+     * the audio callback. Wait-free apart from the callback itself: no locks, no
+     * allocation, no logging. Malformed buffers are dropped and counted (see
+     * GetIOErrorCount()). Must be called from one thread at a time, the audio thread.
      */
     void FeedAudioData(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp);
 
     /**
-     * @brief Get the device type
+     * @brief Frames buffered ahead of the slowest client (real-time safe)
+     *
+     * Returns the target latency while no client is reading, so a drift-compensated
+     * feed using it as its fill level holds its ratio.
+     */
+    double GetBufferedFrames() const;
+
+    /**
+     * @brief Backlog each client keeps behind the feed, in frames
+     */
+    UInt32 GetTargetLatencyFrames() const { return streamRing_->GetTargetLatency(); }
+
+    /**
+     * @brief Set the feed's conversion delay, reported as the device latency
+     * @param seconds Resampler group delay of the splitter destination feeding it
+     */
+    void SetConversionLatency(Float64 seconds);
+
+    /**
+     * @brief Feed rate measured by the device clock over the nominal rate
+     */
+    Float64 GetClockRateScalar() const { return clock_.GetRateScalar(); }
+
+    /**
+     * @brief Ring statistics: frames fed, client underruns and overruns
      */
-    DeviceType GetDeviceType() const { return deviceType_; }
+    StreamRingBuffer::Statistics GetStreamStatistics() const { return streamRing_->GetStatistics(); }
+
+    /**
+     * @brief Measured capture-to-client latency since StartIO()
+     *
+     * Each client read is timed from the capture host time of its first frame (the
+     * feed's timestamps, carried through the splitter) to the moment the client
+     * receives it. Reads of silence and feeds without host times are not counted.
+     */
+    struct LatencyStatistics {
+        double averageSeconds;
+        double minimumSeconds;
+        double maximumSeconds;
+        UInt64 measurements;
+    };
+    
+    LatencyStatistics GetCaptureLatency() const;
+
+    const LatencyProfile& GetLatencyProfile() const { return latencyProfile_; }
+
+    /**
+     * @brief Buffers the IO path rejected since creation, and the last reason
+     */
+    UInt64 GetIOErrorCount() const { return ioErrors_.load(std::memory_order_relaxed); }
+    OSStatus GetLastIOError() const { return lastIOError_.load(std::memory_order_relaxed); }
+
+    const std::string& GetDeviceName() const { return name_; }
+    const std::string& GetDeviceUID() const { return uid_; }
+
+    Float64 GetSampleRate() const { return sampleRate_; }
 
     /**
      * @brief Check if device is currently active
@@ -86,26 +158,53 @@ public:
     bool IsActive() const { return isRunning_.load(); }
 
 private:
-    DeviceType deviceType_;
+    std::string name_;
+    std::string uid_;
     Float64 sampleRate_;
     UInt32 channelCount_;
+    LatencyProfile latencyProfile_;
+    Float64 hostTicksPerFrame_;
     std::atomic<bool> isRunning_{false};
     
-    // Audio processing
-    std::function<void(const AudioBufferList&, const AudioTimeStamp&)> audioCallback_;
+    // Audio processing: read on the IO thread through RCU, replaced by SetAudioCallback
+    using AudioCallback = std::function<void(const AudioBufferList&, const AudioTimeStamp&)>;
+    RcuPointer<AudioCallback> audioCallback_;
+    
+    // Client IO: the feed writes the ring, the HAL IO thread reads it per client
+    class StreamIO;
+    std::shared_ptr<StreamRingBuffer> streamRing_;
+    std::shared_ptr<StreamIO> streamIO_;
     
-    // Thread safety
+    // Thread safety: serializes control calls (start/stop, callback swaps); never
+    // taken on the IO path
     mutable std::mutex deviceMutex_;
     
-    // Performance monitoring
+    // Device clock: updated by the feed, read by the HAL for timestamps
+    DeviceClock clock_;
+    std::atomic<UInt32> conversionLatencyFrames_{0};
+    
+    // Capture-to-client latency: the feed marks the capture host time just past the
+    // newest frame at its ring position, client reads measure against it
+    struct FeedMark {
+        UInt64 position;            // Ring write position after the feed
+        UInt64 captureEndHostTime;  // 0 = the feed had no host time
+    };
+    SeqLock<FeedMark> feedMark_;
+    UInt64 framesFed_ = 0;          // Feed thread only; matches the ring's write position
+    std::atomic<UInt64> latencyTicksTotal_{0};
+    std::atomic<UInt64> latencyTicksMinimum_{UINT64_MAX};
+    std::atomic<UInt64> latencyTicksMaximum_{0};
+    std::atomic<UInt64> latencyMeasurements_{0};
+    
+    // Performance monitoring, written by the IO path
     std::atomic<UInt64> frameCounter_{0};
-    AudioTimeStamp lastProcessedTime_{};
+    std::atomic<UInt64> ioErrors_{0};
+    std::atomic<OSStatus> lastIOError_{noErr};
 
     // Helper methods
     void InitializeStreams();
+    void RecordReadLatency(UInt64 position);
     OSStatus ProcessAudioBuffer(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp);
-    std::string GetDeviceName() const;
-    std::string GetDeviceUID() const;
 };
 
 } // namespace Prezefren
\ No newline at end of file
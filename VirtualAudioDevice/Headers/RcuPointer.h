@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Read-copy-update pointer for state shared with the real-time audio thread
+ *
+ * A writer builds a new immutable object and publishes it with a single atomic
+ * exchange. The reader (exactly one thread, the audio IO thread) brackets each use
+ * with ReadLock/ReadUnlock, which are two atomic increments: it never blocks,
+ * never allocates and never frees. Replaced objects are retired together with the
+ * reader epoch observed at publish time and freed by the writer once the reader
+ * is provably no longer looking at them.
+ *
+ * Writers must be serialized by the caller (e.g. a configuration mutex).
+ */
+template <typename T>
+class RcuPointer {
+public:
+    RcuPointer() : current_(nullptr), readerEpoch_(0) {}
+
+    ~RcuPointer() {
+        delete current_.load(std::memory_order_acquire);
+        for (auto& retired : retired_) {
+            delete retired.object;
+        }
+    }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Enter a read-side critical section (reader thread only)
+     * @return The current object, valid until ReadUnlock; may be null
+     */
+    const T* ReadLock() {
+        // Odd epoch = reader active. seq_cst orders this before the pointer load
+        // against the writer's exchange-then-epoch-load.
+        readerEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        return current_.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Leave the read-side critical section (reader thread only)
+     */
+    void ReadUnlock() {
+        readerEpoch_.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Scoped read-side critical section
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(RcuPointer& rcu) : rcu_(rcu), object_(rcu.ReadLock()) {}
+        ~ReadGuard() { rcu_.ReadUnlock(); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T* get() const { return object_; }
+        const T* operator->() const { return object_; }
+        explicit operator bool() const { return object_ != nullptr; }
+
+    private:
+        RcuPointer& rcu_;
+        const T* object_;
+    };
+
+    /**
+     * @brief Publish a new object and retire the previous one (writer only)
+     */
+    void Publish(std::unique_ptr<T> next) {
+        Reclaim();
+
+        T* previous = current_.exchange(next.release(), std::memory_order_seq_cst);
+        if (previous) {
+            retired_.push_back({previous, readerEpoch_.load(std::memory_order_seq_cst)});
+        }
+    }
+
+    /**
+     * @brief Current object as seen by the writer (writer only)
+     */
+    const T* WriterGet() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Free retired objects the reader can no longer reference (writer only)
+     */
+    void Reclaim() {
+        uint64_t epoch = readerEpoch_.load(std::memory_order_acquire);
+        size_t kept = 0;
+        for (size_t i = 0; i < retired_.size(); ++i) {
+            // Safe if the reader was idle at publish time, or has since left that section
+            bool readerIdleAtPublish = (retired_[i].epoch & 1) == 0;
+            if (readerIdleAtPublish || epoch != retired_[i].epoch) {
+                delete retired_[i].object;
+            } else {
+                retired_[kept++] = retired_[i];
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    /**
+     * @brief Number of retired objects awaiting reclamation (writer only)
+     */
+    size_t PendingReclamation() const { return retired_.size(); }
+
+private:
+    struct Retired {
+        T* object;
+        uint64_t epoch;
+    };
+
+    std::atomic<T*> current_;
+    std::atomic<uint64_t> readerEpoch_;
+    std::vector<Retired> retired_;
+};
+
+} // namespace Prezefren
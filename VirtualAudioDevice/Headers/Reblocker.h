@@ -0,0 +1,86 @@
+#pragma once
+
+#include <CoreAudio/CoreAudioTypes.h>
+#include <cstdint>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Regroups variable-size audio into blocks of exactly N frames
+ *
+ * Capture callbacks arrive in whatever size the device delivers; consumers such as
+ * VAD (10/20/30 ms frames) or an encoder with a fixed hop want a constant size.
+ * Write() appends into an internal ring and Read() hands out one full block at a
+ * time, so the caller alternates the two until the input is consumed.
+ *
+ * Each block is stamped with the sample time of its first frame, derived from the
+ * input timestamps on the same timeline, and a host time extrapolated from the most
+ * recent input anchor. Not thread safe: one thread writes and reads. Write() and
+ * Read() never allocate.
+ */
+class Reblocker {
+public:
+    Reblocker();
+
+    /**
+     * @brief Allocate the ring and block buffers (not real-time safe)
+     * @param numberBuffers Buffers per AudioBufferList (channels for planar audio, 1 for interleaved)
+     * @param channelsPerBuffer Interleaved channels in each buffer
+     * @param blockFrames Frames per emitted block
+     * @param maxInputFrames Typical largest input; sizes the ring so one Write() usually fits
+     * @param hostTicksPerFrame Host clock ticks per frame, used to extrapolate mHostTime
+     */
+    bool Configure(uint32_t numberBuffers, uint32_t channelsPerBuffer, uint32_t blockFrames,
+                   uint32_t maxInputFrames, double hostTicksPerFrame);
+
+    /**
+     * @brief Append input frames starting at frameOffset, as many as fit
+     * @return Number of frames consumed; drain with Read() and call again for the rest
+     */
+    uint32_t Write(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp, uint32_t frameOffset = 0);
+
+    /**
+     * @brief Take the next full block out of the ring into GetBlock()
+     * @param timeStamp Receives the timestamp of the block's first frame
+     * @return false if fewer than blockFrames frames are queued
+     */
+    bool Read(AudioTimeStamp& timeStamp);
+
+    /**
+     * @brief The block filled by the last successful Read()
+     */
+    const AudioBufferList& GetBlock() const { return *blockList_; }
+
+    /**
+     * @brief Drop queued frames and forget the timeline
+     */
+    void Reset();
+
+    uint32_t GetBlockFrames() const { return blockFrames_; }
+    uint32_t GetQueuedFrames() const { return queuedFrames_; }
+
+private:
+    uint32_t numberBuffers_;
+    uint32_t channelsPerBuffer_;
+    uint32_t blockFrames_;
+    uint32_t capacityFrames_;
+    double hostTicksPerFrame_;
+
+    std::vector<float> ring_;               // numberBuffers_ x capacityFrames_ x channelsPerBuffer_
+    std::vector<float> blockStorage_;       // numberBuffers_ x blockFrames_ x channelsPerBuffer_
+    std::vector<uint8_t> blockListStorage_;
+    AudioBufferList* blockList_;
+
+    uint32_t readFrame_;                    // ring position of the oldest queued frame
+    uint32_t queuedFrames_;
+
+    // Timeline: sample time of the oldest queued frame plus the latest host anchor
+    AudioTimeStamp lastTimeStamp_;
+    double headSampleTime_;
+    double anchorSampleTime_;
+    uint64_t anchorHostTime_;
+    bool hasHostAnchor_;
+};
+
+} // namespace Prezefren
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief M-input to N-output channel routing with a gain per cell
+ *
+ * Gains are stored row-major, one row per output channel: gains[out * inputs + in].
+ * Configure() picks a kernel once: compile-time specialized SIMD kernels for the
+ * common 2->1, 2->2 and 1->2 shapes, a generic kernel for everything else. A matrix
+ * that only selects channels at unity gain needs no arithmetic at all; callers can
+ * detect that with GetSelectedInput() and pass the input buffers through.
+ *
+ * Plain C++ with no Apple dependencies. Process() never allocates.
+ */
+class RoutingMatrix {
+public:
+    RoutingMatrix();
+
+    /**
+     * @brief Set the matrix
+     * @param inputs Number of input channels (M)
+     * @param outputs Number of output channels (N)
+     * @param gains N x M gains, row-major by output
+     * @return false if the dimensions are zero or gains has the wrong size
+     */
+    bool Configure(uint32_t inputs, uint32_t outputs, const std::vector<float>& gains);
+
+    /**
+     * @brief Equal-weight downmix of all inputs to one output
+     */
+    static std::vector<float> Downmix(uint32_t inputs);
+
+    /**
+     * @brief One output carrying a single input channel
+     */
+    static std::vector<float> Extract(uint32_t inputs, uint32_t channel);
+
+    /**
+     * @brief Output c carries input min(c, inputs - 1): identity when counts match,
+     *        drops extra inputs, repeats the last input for extra outputs
+     */
+    static std::vector<float> Map(uint32_t inputs, uint32_t outputs);
+
+    /**
+     * @brief Re-target a matrix built for one input count at another
+     *
+     * Gains of inputs that no longer exist fold into the last remaining input, so a
+     * stereo extract or downmix still carries signal from a mono source; inputs that
+     * are new get zero gain.
+     */
+    static std::vector<float> Adapt(const std::vector<float>& gains, uint32_t outputs,
+                                    uint32_t fromInputs, uint32_t toInputs);
+
+    /**
+     * @brief Mix planar input into planar output
+     * @param input One pointer per input channel
+     * @param output One pointer per output channel, must not alias the input
+     * @param frames Number of frames
+     */
+    void Process(const float* const* input, float* const* output, uint32_t frames) const;
+
+    /**
+     * @brief For pure selections (each output copies one input at unity gain)
+     * @return The input feeding this output, or -1 if the output needs mixing
+     */
+    int GetSelectedInput(uint32_t output) const;
+
+    /**
+     * @brief True if every output is a unity-gain copy of one input
+     */
+    bool IsSelection() const { return isSelection_; }
+
+    uint32_t GetInputCount() const { return inputs_; }
+    uint32_t GetOutputCount() const { return outputs_; }
+    const std::vector<float>& GetGains() const { return gains_; }
+
+private:
+    using Kernel = void (*)(const RoutingMatrix& matrix, const float* const* input, float* const* output, uint32_t frames);
+
+    uint32_t inputs_;
+    uint32_t outputs_;
+    std::vector<float> gains_;
+    std::vector<int> selectedInputs_;
+    bool isSelection_;
+    Kernel kernel_;
+
+    template <uint32_t Inputs, uint32_t Outputs>
+    static void FixedKernel(const RoutingMatrix& matrix, const float* const* input, float* const* output, uint32_t frames);
+    static void GenericKernel(const RoutingMatrix& matrix, const float* const* input, float* const* output, uint32_t frames);
+};
+
+} // namespace Prezefren
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Prezefren {
+
+/**
+ * @brief Sample type, channel count and interleaving of one side of a conversion
+ */
+struct SampleLayout {
+    enum class Type {
+        Float32,
+        Int16
+    };
+
+    Type type = Type::Float32;
+    uint32_t channels = 1;
+    bool interleaved = false;
+
+    uint32_t BytesPerSample() const { return type == Type::Int16 ? 2 : 4; }
+    uint32_t BufferCount() const { return interleaved ? 1 : channels; }
+    uint32_t ChannelsPerBuffer() const { return interleaved ? channels : 1; }
+    uint32_t BytesPerFrame() const { return BytesPerSample() * ChannelsPerBuffer(); }
+
+    /**
+     * @brief Frames in a buffer of this layout (mDataByteSize of the first buffer)
+     */
+    uint32_t FramesIn(uint32_t byteSize) const { return byteSize / BytesPerFrame(); }
+
+    /**
+     * @brief True for the splitter's native layout, which needs no kernel at all
+     */
+    bool IsPlanarFloat() const { return type == Type::Float32 && (!interleaved || channels == 1); }
+
+    bool operator==(const SampleLayout& other) const {
+        return type == other.type && channels == other.channels && interleaved == other.interleaved;
+    }
+};
+
+/**
+ * @brief Layout conversion between buffers of any SampleLayout and planar float
+ *
+ * Kernels are templates specialized on sample type (float32/int16), channel count
+ * (1, 2 or any) and interleaving, so the common shapes compile to straight loops the
+ * compiler can vectorize. Select*() picks one once, at configuration time; the audio
+ * thread calls it through a plain function pointer with no per-sample branching on
+ * the layout. The Generic*() variants do the same work with the layout decided at
+ * runtime and exist as the reference (and fallback) for the specialized ones.
+ *
+ * Plain C++ with no Apple dependencies. Kernels never allocate.
+ */
+class SampleKernels {
+public:
+    /**
+     * @brief Read frames [offset, offset + frames) into planar float
+     * @param buffers One pointer per buffer of the source layout (mData)
+     * @param channels Channel count of the source layout
+     */
+    using ReadKernel = void (*)(const void* const* buffers, uint32_t channels, uint32_t offset,
+                                uint32_t frames, float* const* planar);
+
+    /**
+     * @brief Write planar float into frames [0, frames) of the target layout
+     * @param buffers One pointer per buffer of the target layout (mData)
+     * @param channels Channel count of the target layout
+     */
+    using WriteKernel = void (*)(const float* const* planar, uint32_t channels, uint32_t frames,
+                                 void* const* buffers);
+
+    static ReadKernel SelectRead(const SampleLayout& layout);
+    static WriteKernel SelectWrite(const SampleLayout& layout);
+
+    /**
+     * @brief Runtime-dispatched reference versions of the kernels above
+     */
+    static void GenericRead(const SampleLayout& layout, const void* const* buffers, uint32_t offset,
+                            uint32_t frames, float* const* planar);
+    static void GenericWrite(const SampleLayout& layout, const float* const* planar, uint32_t frames,
+                             void* const* buffers);
+};
+
+} // namespace Prezefren
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Prezefren {
+
+/**
+ * @brief Sequence lock for small plain values written by the real-time thread
+ *
+ * The writer (exactly one thread at a time) bumps the sequence to odd, stores the
+ * value and bumps it back to even: a handful of relaxed stores and two fences, never
+ * blocking. Readers copy the value and retry if the sequence was odd or changed
+ * underneath them, so they may spin briefly but never hold the writer up.
+ *
+ * The value is kept as atomic words, so torn reads are detected rather than being
+ * undefined behaviour. T must be trivially copyable.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    SeqLock() : sequence_(0) {
+        Store(T{});
+    }
+
+    explicit SeqLock(const T& value) : sequence_(0) {
+        Store(T{});
+        Store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a new value (single writer; wait-free)
+     */
+    void Store(const T& value) {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent copy (any thread; retries while a store is in progress)
+     */
+    T Load() const {
+        uint64_t words[kWords];
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_;
+    std::atomic<uint64_t> words_[kWords];
+};
+
+} // namespace Prezefren
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+namespace Prezefren {
+
+/**
+ * @brief Single-producer/single-consumer frame ring in POSIX shared memory
+ *
+ * Carries one device's audio across processes: the app, where capture and the
+ * splitter run, writes it; the HAL plugin inside coreaudiod reads it. The segment
+ * is a fixed header (format, the producer's write index, the consumer's read
+ * index, the latest timestamps and a wake word) followed by capacity x channels
+ * interleaved float32 frames. Both indices are monotonic frame counts, so each
+ * side sees exactly how far the other has got.
+ *
+ * Neither side ever waits for the other. A full ring drops the newest frames,
+ * which means the producer never touches frames the consumer has not released:
+ * Peek() hands out pointers straight into the segment and the consumer reads them
+ * in place. A consumer thread may Wait() for frames; the producer wakes it through
+ * a futex on the wake word (os_sync_wait_on_address on macOS 14.4+, a short poll
+ * before that), and only makes that system call while a waiter is parked.
+ *
+ * The segment is mode 0660: the producer's user owns it and its group is the
+ * consumer's (ConsumerGroup(), coreaudiod's on macOS), so no other local user can
+ * read the audio or corrupt the indices. The consumer only opens a segment owned by
+ * the user it expects the producer to run as. Create(), Open() and destruction are
+ * not real-time safe; Write(), Peek() and Consume() never allocate, lock or block.
+ */
+class SharedAudioRing {
+public:
+    static constexpr uint32_t kMaxChannels = 64;
+
+    /**
+     * @brief Readable frames, in place (at most two runs around the wrap)
+     */
+    struct Region {
+        const float* data[2];       // Interleaved frames
+        uint32_t frames[2];
+        uint64_t position;          // Ring frame count of data[0][0]
+        double sampleTime;          // Producer sample time of that frame, NaN = unknown
+        uint64_t hostTime;          // Producer host time of that frame, 0 = unknown
+    };
+
+    struct Statistics {
+        uint64_t framesWritten;
+        uint64_t framesRead;
+        uint64_t droppedFrames;     // Rejected by the producer because the ring was full
+        uint32_t bufferedFrames;
+    };
+
+    ~SharedAudioRing();
+
+    SharedAudioRing(const SharedAudioRing&) = delete;
+    SharedAudioRing& operator=(const SharedAudioRing&) = delete;
+
+    /**
+     * @brief Shared-memory name for a device uid (short enough for macOS' 31 characters)
+     */
+    static std::string NameFor(const std::string& uid);
+
+    /**
+     * @brief Group the segment is shared with: coreaudiod's on macOS, the caller's elsewhere
+     * @return (gid_t)-1 if that group does not exist
+     */
+    static gid_t ConsumerGroup();
+
+    /**
+     * @brief User the consumer expects to own the segment: the console user on macOS,
+     *        the caller elsewhere
+     *
+     * Looked up on every call, so a consumer follows fast user switching.
+     */
+    static uid_t ExpectedProducer();
+
+    /**
+     * @brief Create the segment (producer)
+     * @param capacityFrames Ring size, rounded up to a power of two
+     * @param hostTicksPerSecond Rate of the host clock timestamps are given in
+     * @return nullptr if the segment cannot be created, or cannot be given to
+     *         ConsumerGroup() (the producer must be allowed to chown to it)
+     *
+     * A segment left under the same name by an earlier producer is marked closed,
+     * so a consumer still reading it moves over, and replaced. Destroying the
+     * producer marks the segment closed and unlinks it.
+     */
+    static std::unique_ptr<SharedAudioRing> Create(const std::string& name, uint32_t channels, uint32_t capacityFrames,
+                                                   double sampleRate, double hostTicksPerSecond);
+
+    /**
+     * @brief Attach to a producer's segment (consumer)
+     * @param producer User the segment must belong to (see ExpectedProducer())
+     * @return nullptr if there is none yet, it is closed, its header is not valid, or
+     *         it belongs to another user or is accessible to other users
+     *
+     * Starts at the producer's current write index; audio written before is skipped.
+     */
+    static std::unique_ptr<SharedAudioRing> Open(const std::string& name, uid_t producer);
+
+    /**
+     * @brief Append planar frames (producer thread only)
+     * @param planar One pointer per channel; missing channels repeat the last one
+     * @param sampleTime Producer sample time of the first frame, NaN = unknown
+     * @param hostTime Host time of the first frame, 0 = unknown
+     * @return Frames appended; fewer than given if the ring was full
+     */
+    uint32_t Write(const float* const* planar, uint32_t planarChannels, uint32_t frames,
+                   double sampleTime, uint64_t hostTime);
+
+    /**
+     * @brief Everything readable, in place (consumer thread only)
+     * @return Frames in the region, 0 if none
+     *
+     * The frames stay valid and unchanged until Consume() releases them.
+     */
+    uint32_t Peek(Region& region) const;
+
+    /**
+     * @brief Release frames read from the last Peek() (consumer thread only)
+     */
+    void Consume(uint32_t frames);
+
+    /**
+     * @brief Block until frames are readable, the producer closes or the timeout passes
+     * @return true if frames are readable
+     */
+    bool Wait(uint32_t timeoutMilliseconds);
+
+    /**
+     * @brief True once the producer has gone away or replaced the segment
+     */
+    bool IsClosed() const;
+
+    /**
+     * @brief Frames the consumer holds downstream of the ring (consumer), e.g. its device's backlog
+     */
+    void SetConsumerBacklog(double frames);
+
+    /**
+     * @brief Frames buffered in the ring plus the consumer's backlog, or -1 before a
+     *        consumer has reported one (producer; real-time safe)
+     */
+    double GetFillLevel() const;
+
+    /**
+     * @brief Resampler delay ahead of the ring (producer), for the consumer to report
+     */
+    void SetConversionLatency(double seconds);
+    double GetConversionLatency() const;
+
+    const std::string& GetName() const { return name_; }
+    uint32_t GetChannels() const { return channels_; }
+    uint32_t GetCapacity() const { return capacity_; }
+    double GetSampleRate() const { return sampleRate_; }
+    Statistics GetStatistics() const;
+
+private:
+    struct Header;
+
+    SharedAudioRing(const std::string& name, void* mapping, size_t mappingBytes, bool producer);
+
+    std::string name_;
+    void* mapping_;
+    size_t mappingBytes_;
+    bool producer_;
+    Header* header_;
+    float* data_;
+
+    // Copied out of the header once validated; the consumer never trusts it for bounds again
+    uint32_t channels_;
+    uint32_t capacity_;
+    uint32_t mask_;
+    double sampleRate_;
+    double hostTicksPerFrame_;
+};
+
+} // namespace Prezefren
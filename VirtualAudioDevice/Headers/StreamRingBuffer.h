@@ -0,0 +1,116 @@
+#pragma once
+
+#include <CoreAudio/CoreAudioTypes.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Prezefren {
+
+/**
+ * @brief Lock-free single-writer, multi-reader frame ring behind a device stream
+ *
+ * The writer (the splitter feeding a VirtualDevice) appends float audio, planar or
+ * interleaved, as interleaved frames at a monotonic write position. Each reader (one
+ * per HAL client of the device) has its own cursor into the same frames, so every
+ * client sees the full stream at its own pace and none can starve another.
+ *
+ * A reader starts (and restarts after an underrun) by priming: it returns silence
+ * until targetLatency frames plus one read are buffered, then reads from there, so
+ * it runs about targetLatency frames behind the writer. Running dry zero-fills and
+ * re-primes; falling more than the capacity behind skips ahead to the target. A
+ * read the writer laps mid-copy is detected and returned as silence.
+ *
+ * Write() and Read() never allocate, lock or block. Readers are added and removed
+ * from a configuration thread; each reader slot is read by one thread at a time.
+ */
+class StreamRingBuffer {
+public:
+    static constexpr uint32_t kMaxReaders = 16;
+
+    struct Statistics {
+        uint64_t framesWritten;
+        uint64_t underruns;         // Reads that ran dry and were zero-filled
+        uint64_t overruns;          // Reads that fell a full ring behind and skipped ahead
+        uint32_t readers;
+    };
+
+    StreamRingBuffer();
+
+    /**
+     * @brief Allocate the ring (not real-time safe)
+     * @param channels Interleaved channels per frame
+     * @param capacityFrames Ring size, rounded up to a power of two
+     * @param targetLatencyFrames Backlog each reader keeps behind the writer
+     */
+    bool Configure(uint32_t channels, uint32_t capacityFrames, uint32_t targetLatencyFrames);
+
+    /**
+     * @brief Append a float32 buffer list (writer thread only)
+     *
+     * Planar lists use one buffer per channel, interleaved lists one buffer with
+     * mNumberChannels channels; missing channels repeat the last one.
+     * @return Frames appended
+     */
+    uint32_t Write(const AudioBufferList& bufferList);
+
+    /**
+     * @brief Copy the reader's next frames out, interleaved (that reader's thread only)
+     * @param position If given, receives the write position of the first frame read,
+     *        which counts every frame written since Configure()
+     * @return false if the frames were (partly) silence: unknown reader, priming,
+     *         underrun or overrun
+     */
+    bool Read(uint32_t readerId, float* interleaved, uint32_t frames, uint64_t* position = nullptr);
+
+    /**
+     * @brief Register / unregister a reader (configuration thread)
+     */
+    bool AddReader(uint32_t readerId);
+    void RemoveReader(uint32_t readerId);
+
+    /**
+     * @brief Make every reader prime again from the next write, e.g. on IO start
+     */
+    void Reset();
+
+    /**
+     * @brief Frames buffered for the reader furthest behind, or -1 with no primed reader
+     *
+     * Real-time safe; meant as a drift-compensation fill level for the writer.
+     */
+    double GetFillLevel() const;
+
+    uint32_t GetChannels() const { return channels_; }
+    uint32_t GetTargetLatency() const { return targetLatency_; }
+    uint32_t GetCapacity() const { return capacity_; }
+    Statistics GetStatistics() const;
+
+private:
+    struct alignas(64) Reader {
+        std::atomic<bool> active;
+        std::atomic<uint32_t> id;
+        std::atomic<uint64_t> cursor;       // Written by the reader only; atomic for GetFillLevel()
+        std::atomic<bool> primed;
+        uint32_t generation;
+    };
+
+    uint32_t channels_;
+    uint32_t capacity_;                     // Power of two
+    uint32_t mask_;
+    uint32_t targetLatency_;
+    std::vector<float> data_;               // capacity_ x channels_, interleaved
+
+    alignas(64) std::atomic<uint64_t> writeFrame_;
+    std::atomic<uint64_t> writeLimit_;      // End of the write in progress; frames before it minus capacity_ are gone
+    std::atomic<uint32_t> generation_;
+    Reader readers_[kMaxReaders];
+
+    std::atomic<uint64_t> underruns_;
+    std::atomic<uint64_t> overruns_;
+
+    Reader* FindReader(uint32_t readerId);
+    void CopyOut(uint64_t position, float* interleaved, uint32_t frames) const;
+};
+
+} // namespace Prezefren
@@ -1,8 +1,15 @@
 #pragma once
 
 #include <AVFoundation/AVFoundation.h>
+#include "LatencyProfile.h"
+#include "DeviceTopology.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <functional>
+#include <thread>
+#include <vector>
+#include <dispatch/dispatch.h>
 
 // Forward declarations to avoid heavy includes in main app
 namespace Prezefren {
@@ -27,9 +34,11 @@ public:
         bool useForTranscription = false;        // Route transcription through virtual device
         bool useForPassthrough = false;          // Route passthrough through virtual device
         bool enableStereoSeparation = false;     // Enable L/R channel separation
+        std::vector<Prezefren::DeviceSpec> devices;  // Explicit device set; replaces the three flags above
+        bool feedInstalledPlugin = false;        // Feed the installed HAL plugin's devices over shared memory
         
         // Performance settings
-        bool enableLowLatencyMode = true;        // Optimize for real-time performance
+        bool enableLowLatencyMode = true;        // LatencyProfile::LowLatency() instead of Balanced()
         bool enableStatistics = false;          // Disable by default to reduce overhead
         
         // Fallback behavior
@@ -62,6 +71,9 @@ public:
      * This method can be called from the existing AudioEngine's audio tap.
      * If virtual audio is disabled or fails, it simply returns false and
      * the existing system continues unchanged.
+     *
+     * A new tap format is handed to a control thread that renegotiates the splitter;
+     * buffers are dropped until the new conversion graph is published.
      * 
      * @param buffer Audio buffer from existing tap
      * @param timeStamp Timing information
@@ -84,11 +96,27 @@ public:
      */
     void UpdateConfig(const Config& newConfig);
 
+    /**
+     * @brief Replace the virtual device set while running
+     * @return false if the specs are invalid; the current devices stay
+     *
+     * Only devices whose spec changed are touched (see Driver::UpdateTopology()).
+     */
+    bool UpdateDeviceTopology(const std::vector<Prezefren::DeviceSpec>& devices);
+
     /**
      * @brief Get current configuration
      */
     Config GetConfig() const { return config_; }
 
+    /**
+     * @brief Tap buffer size the latency profile is built around
+     *
+     * The engine's tap should request this many frames; larger tap buffers still
+     * work but add their extra length to the latency.
+     */
+    UInt32 GetPreferredBufferFrameSize() const;
+
     /**
      * @brief Get simple statistics (only if enabled in config)
      */
@@ -97,6 +125,9 @@ public:
         uint64_t buffersProcessed;
         double averageLatency;
         bool hasErrors;
+        double clockDriftPpm;       // Largest capture-vs-device drift estimate, signed
+        double captureLatencyMs;    // Largest measured capture-to-device-client latency
+        double maximumLatencyMs;    // Bound the latency profile sets for that path
     };
     
     SimpleStats GetStatistics() const;
@@ -114,6 +145,34 @@ private:
     // Virtual audio components (using pimpl pattern to avoid heavy includes)
     std::unique_ptr<Prezefren::Driver> driver_;
     std::unique_ptr<Prezefren::AudioSplitter> splitter_;
+    AVAudioFormat* inputFormat_;        // Last format seen on the tap (tap thread only)
+    uint64_t requestedFormatGeneration_;    // Bumped per new tap format (tap thread only)
+    
+    /**
+     * @brief Applies input format changes off the tap thread
+     *
+     * Driver::SetInputFormat() takes the driver lock, builds every conversion and
+     * starts or joins async delivery threads, none of which belongs on the tap
+     * thread. The tap only hands the new format over; the worker applies the latest
+     * one and publishes its generation once the splitter runs on it.
+     */
+    struct FormatControl {
+        Prezefren::Driver* driver;
+        std::mutex pendingMutex;            // Held only to swap pending in or out
+        AVAudioFormat* pending;             // Retained; null once taken by the worker
+        uint64_t pendingGeneration;
+        std::atomic<uint64_t> appliedGeneration;
+        std::atomic<bool> supported;        // Whether the last applied format was accepted
+        std::atomic<bool> running;
+        dispatch_semaphore_t wakeup;
+        std::thread worker;
+        
+        explicit FormatControl(Prezefren::Driver* target);
+        ~FormatControl();
+        void Request(AVAudioFormat* format, uint64_t generation);
+        void Run();
+    };
+    std::unique_ptr<FormatControl> formatControl_;
     
     // Callbacks
     std::function<void(AVAudioPCMBuffer*, const AudioTimeStamp&)> transcriptionCallback_;
@@ -130,6 +189,7 @@ private:
     bool InitializeVirtualAudioSystem();
     void ShutdownVirtualAudioSystem();
     AVAudioPCMBuffer* ConvertAudioBufferList(const AudioBufferList& bufferList, AVAudioFormat* format);
+    static Prezefren::LatencyProfile LatencyProfileFor(const Config& config);
 };
 
 /**
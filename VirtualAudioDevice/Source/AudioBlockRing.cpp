@@ -0,0 +1,147 @@
+#include "../Headers/AudioBlockRing.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Prezefren {
+
+AudioBlockRing::AudioBlockRing()
+    : capacity_(0)
+    , maxBuffers_(0)
+    , maxBytesPerBuffer_(0)
+    , bytesPerSample_(sizeof(float))
+    , policy_(OverflowPolicy::DropNewest)
+    , writeIndex_(0)
+    , readIndex_(0)
+    , overflowCount_(0)
+    , overwriteCount_(0)
+{
+}
+
+bool AudioBlockRing::Configure(uint32_t capacityBlocks, uint32_t maxBuffers, uint32_t maxBytesPerBuffer,
+                               uint32_t bytesPerSample, OverflowPolicy policy) {
+    if (capacityBlocks < 2 || maxBuffers == 0 || maxBytesPerBuffer == 0 || bytesPerSample == 0) {
+        return false;
+    }
+
+    capacity_ = capacityBlocks;
+    maxBuffers_ = maxBuffers;
+    maxBytesPerBuffer_ = maxBytesPerBuffer;
+    bytesPerSample_ = bytesPerSample;
+    policy_ = policy;
+
+    headers_.assign(capacity_, SlotHeader());
+    bufferChannels_.assign(static_cast<size_t>(capacity_) * maxBuffers_, 0);
+    bufferBytes_.assign(static_cast<size_t>(capacity_) * maxBuffers_, 0);
+    data_.assign(static_cast<size_t>(capacity_) * maxBuffers_ * maxBytesPerBuffer_, 0);
+
+    writeIndex_.store(0, std::memory_order_relaxed);
+    readIndex_.store(0, std::memory_order_relaxed);
+    overflowCount_.store(0, std::memory_order_relaxed);
+    overwriteCount_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool AudioBlockRing::Push(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+    if (capacity_ == 0 || bufferList.mNumberBuffers == 0 || bufferList.mNumberBuffers > maxBuffers_) {
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Frames are counted on the first buffer; slices must fit every buffer's slot
+    uint32_t firstChannels = std::max<uint32_t>(bufferList.mBuffers[0].mNumberChannels, 1);
+    uint32_t totalFrames = bufferList.mBuffers[0].mDataByteSize / (firstChannels * bytesPerSample_);
+    uint32_t framesPerSlot = UINT32_MAX;
+    for (uint32_t i = 0; i < bufferList.mNumberBuffers; ++i) {
+        uint32_t channels = std::max<uint32_t>(bufferList.mBuffers[i].mNumberChannels, 1);
+        framesPerSlot = std::min(framesPerSlot, maxBytesPerBuffer_ / (channels * bytesPerSample_));
+    }
+    if (framesPerSlot == 0) {
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool complete = true;
+    for (uint32_t offset = 0; offset < totalFrames; offset += framesPerSlot) {
+        complete &= PushSlice(bufferList, timeStamp, offset, std::min(framesPerSlot, totalFrames - offset));
+    }
+    return complete;
+}
+
+bool AudioBlockRing::PushSlice(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp,
+                               uint32_t frameOffset, uint32_t frames) {
+    uint64_t write = writeIndex_.load(std::memory_order_relaxed);
+    uint64_t read = readIndex_.load(std::memory_order_acquire);
+
+    if (write - read >= capacity_) {
+        if (policy_ == OverflowPolicy::DropNewest) {
+            overflowCount_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // Reclaim the oldest block; if the consumer got there first, the slot is free anyway
+        if (readIndex_.compare_exchange_strong(read, read + 1, std::memory_order_acq_rel)) {
+            overwriteCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t slot = static_cast<uint32_t>(write % capacity_);
+    SlotHeader& header = headers_[slot];
+    header.timeStamp = timeStamp;
+    if (frameOffset > 0 && (timeStamp.mFlags & kAudioTimeStampSampleTimeValid)) {
+        header.timeStamp.mSampleTime += frameOffset;
+    }
+    header.numberBuffers = bufferList.mNumberBuffers;
+
+    for (uint32_t i = 0; i < bufferList.mNumberBuffers; ++i) {
+        const AudioBuffer& source = bufferList.mBuffers[i];
+        uint32_t channels = std::max<uint32_t>(source.mNumberChannels, 1);
+        uint32_t bytesPerFrame = channels * bytesPerSample_;
+        uint32_t start = std::min(frameOffset * bytesPerFrame, source.mDataByteSize);
+        uint32_t bytes = std::min(frames * bytesPerFrame, source.mDataByteSize - start);
+
+        size_t index = static_cast<size_t>(slot) * maxBuffers_ + i;
+        bufferChannels_[index] = source.mNumberChannels;
+        bufferBytes_[index] = bytes;
+        if (bytes > 0 && source.mData) {
+            std::memcpy(&data_[index * maxBytesPerBuffer_], static_cast<const uint8_t*>(source.mData) + start, bytes);
+        }
+    }
+
+    writeIndex_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioBlockRing::Pop(AudioBufferList& bufferList, AudioTimeStamp& timeStamp) {
+    for (;;) {
+        uint64_t read = readIndex_.load(std::memory_order_acquire);
+        uint64_t write = writeIndex_.load(std::memory_order_acquire);
+        if (read == write) {
+            return false;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(read % capacity_);
+        const SlotHeader& header = headers_[slot];
+        timeStamp = header.timeStamp;
+        uint32_t numberBuffers = std::min(header.numberBuffers, maxBuffers_);
+
+        for (uint32_t i = 0; i < numberBuffers; ++i) {
+            size_t index = static_cast<size_t>(slot) * maxBuffers_ + i;
+            bufferList.mBuffers[i].mNumberChannels = bufferChannels_[index];
+            bufferList.mBuffers[i].mDataByteSize = bufferBytes_[index];
+            std::memcpy(bufferList.mBuffers[i].mData, &data_[index * maxBytesPerBuffer_], bufferBytes_[index]);
+        }
+        bufferList.mNumberBuffers = numberBuffers;
+
+        // Commit only if the producer did not overwrite this block while we copied it
+        if (readIndex_.compare_exchange_strong(read, read + 1, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+}
+
+uint32_t AudioBlockRing::GetQueuedBlocks() const {
+    uint64_t write = writeIndex_.load(std::memory_order_acquire);
+    uint64_t read = readIndex_.load(std::memory_order_acquire);
+    return static_cast<uint32_t>(write - read);
+}
+
+} // namespace Prezefren
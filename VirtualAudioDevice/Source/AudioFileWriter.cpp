@@ -0,0 +1,361 @@
+#include "../Headers/AudioFileWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Prezefren {
+
+namespace {
+
+// WAV sizes are 32-bit; stop short of the limit rather than write a corrupt file
+constexpr uint64_t kMaxWavBytes = 0xFFFFFFFFull;
+
+void PutLE16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void PutLE32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutBE16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void PutBE32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutBE64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PutTag(std::vector<uint8_t>& out, const char* tag) {
+    out.insert(out.end(), tag, tag + 4);
+}
+
+uint32_t ClampToU32(uint64_t value) {
+    return static_cast<uint32_t>(std::min(value, kMaxWavBytes));
+}
+
+} // namespace
+
+AudioFileWriter::AudioFileWriter()
+    : fd_(-1)
+    , container_(Container::Wav)
+    , sampleRate_(0.0)
+    , headerBytes_(0)
+    , dataBytes_(0)
+    , syncIntervalBytes_(0)
+    , nextSyncBytes_(0)
+    , allocatedBytes_(0)
+    , preallocate_(true)
+    , finalized_(false)
+    , stagedBytes_(0)
+    , framesWritten_(0)
+    , writeErrors_(0)
+    , syncs_(0)
+    , longestWriteNs_(0)
+    , lastError_(0)
+{
+}
+
+AudioFileWriter::~AudioFileWriter() {
+    Close();
+}
+
+bool AudioFileWriter::Open(const std::string& path, Container container, const SampleLayout& layout,
+                           double sampleRate, double syncIntervalSeconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (fd_ >= 0 || layout.channels == 0 || layout.BufferCount() != 1 || sampleRate <= 0.0) {
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RecordError(errno);
+        return false;
+    }
+
+    fd_ = fd;
+    container_ = container;
+    layout_ = layout;
+    sampleRate_ = sampleRate;
+    dataBytes_ = 0;
+    stagedBytes_ = 0;
+    allocatedBytes_ = 0;
+    preallocate_ = true;
+    finalized_ = false;
+    staging_.assign(kStagingBytes - kStagingBytes % layout_.BytesPerFrame(), 0);
+
+    const double bytesPerSecond = sampleRate_ * layout_.BytesPerFrame();
+    syncIntervalBytes_ = syncIntervalSeconds > 0.0
+        ? std::max<uint64_t>(static_cast<uint64_t>(syncIntervalSeconds * bytesPerSecond), staging_.size())
+        : 0;
+    nextSyncBytes_ = syncIntervalBytes_;
+
+    headerBytes_ = static_cast<uint32_t>(BuildHeader().size());
+    if (!WriteHeader()) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void AudioFileWriter::Write(const void* data, uint32_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (fd_ < 0) {
+        return;
+    }
+
+    // Whole frames only, so a dropped write never shifts the channels
+    bytes -= bytes % layout_.BytesPerFrame();
+    if (container_ == Container::Wav) {
+        uint64_t room = kMaxWavBytes - headerBytes_ - dataBytes_ - stagedBytes_;
+        if (bytes > room) {
+            RecordError(EFBIG);
+            writeErrors_.fetch_add(1, std::memory_order_relaxed);
+            bytes = static_cast<uint32_t>(room - room % layout_.BytesPerFrame());
+        }
+    }
+
+    const uint8_t* source = static_cast<const uint8_t*>(data);
+    while (bytes > 0) {
+        size_t chunk = std::min<size_t>(bytes, staging_.size() - stagedBytes_);
+        std::memcpy(&staging_[stagedBytes_], source, chunk);
+        stagedBytes_ += chunk;
+        source += chunk;
+        bytes -= static_cast<uint32_t>(chunk);
+        if (stagedBytes_ == staging_.size()) {
+            Flush();
+        }
+    }
+
+    if (syncIntervalBytes_ > 0 && dataBytes_ + stagedBytes_ >= nextSyncBytes_) {
+        Flush();
+        WriteHeader();
+        Sync();
+        nextSyncBytes_ = dataBytes_ + syncIntervalBytes_;
+    }
+}
+
+bool AudioFileWriter::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (fd_ < 0) {
+        return true;
+    }
+
+    bool ok = Flush();
+    finalized_ = true;
+    ok = WriteHeader() && ok;
+    // Give back the preallocated extent past the audio
+    if (::ftruncate(fd_, static_cast<off_t>(headerBytes_ + dataBytes_)) != 0) {
+        RecordError(errno);
+        ok = false;
+    }
+    ok = Sync() && ok;
+    if (::close(fd_) != 0) {
+        RecordError(errno);
+        ok = false;
+    }
+    fd_ = -1;
+    return ok;
+}
+
+bool AudioFileWriter::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fd_ >= 0;
+}
+
+AudioFileWriter::Statistics AudioFileWriter::GetStatistics() const {
+    Statistics stats;
+    stats.framesWritten = framesWritten_.load(std::memory_order_relaxed);
+    stats.bytesWritten = stats.framesWritten * layout_.BytesPerFrame();
+    stats.writeErrors = writeErrors_.load(std::memory_order_relaxed);
+    stats.syncs = syncs_.load(std::memory_order_relaxed);
+    stats.longestWriteSeconds = longestWriteNs_.load(std::memory_order_relaxed) / 1e9;
+    stats.lastError = lastError_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool AudioFileWriter::Flush() {
+    // Caller holds mutex_. Data goes at an explicit offset: a failed write is
+    // dropped whole and the next one overwrites whatever part of it landed.
+    if (stagedBytes_ == 0) {
+        return true;
+    }
+
+    uint64_t offset = headerBytes_ + dataBytes_;
+    Preallocate(offset + stagedBytes_);
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = WriteAll(staging_.data(), stagedBytes_, static_cast<int64_t>(offset));
+    RecordDuration(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    if (ok) {
+        dataBytes_ += stagedBytes_;
+        framesWritten_.fetch_add(stagedBytes_ / layout_.BytesPerFrame(), std::memory_order_relaxed);
+    } else {
+        writeErrors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    stagedBytes_ = 0;
+    return ok;
+}
+
+bool AudioFileWriter::Sync() {
+    auto start = std::chrono::steady_clock::now();
+#if defined(__APPLE__)
+    int result = ::fsync(fd_);
+#else
+    int result = ::fdatasync(fd_);
+#endif
+    RecordDuration(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    if (result != 0) {
+        RecordError(errno);
+        return false;
+    }
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool AudioFileWriter::WriteHeader() {
+    if (headerBytes_ == 0) {
+        return true;
+    }
+    std::vector<uint8_t> header = BuildHeader();
+    return WriteAll(header.data(), header.size(), 0);
+}
+
+void AudioFileWriter::Preallocate(uint64_t endOffset) {
+    // Reserve whole extents ahead of the write position without changing the file
+    // size, so readers and the header never see the reserved tail. Best effort: a
+    // file system without support just allocates on write.
+    while (preallocate_ && endOffset > allocatedBytes_) {
+#if defined(__APPLE__)
+        fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, static_cast<off_t>(kPreallocateBytes), 0};
+        int result = ::fcntl(fd_, F_PREALLOCATE, &store);
+        if (result == -1) {
+            store.fst_flags = F_ALLOCATEALL;
+            result = ::fcntl(fd_, F_PREALLOCATE, &store);
+        }
+#elif defined(__linux__)
+        int result = ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(allocatedBytes_),
+                                 static_cast<off_t>(kPreallocateBytes));
+#else
+        int result = -1;
+#endif
+        if (result != 0) {
+            preallocate_ = false;
+            return;
+        }
+        allocatedBytes_ += kPreallocateBytes;
+    }
+}
+
+bool AudioFileWriter::WriteAll(const uint8_t* data, size_t bytes, int64_t offset) {
+    while (bytes > 0) {
+        ssize_t written = ::pwrite(fd_, data, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            RecordError(errno);
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+void AudioFileWriter::RecordError(int error) {
+    lastError_.store(error, std::memory_order_relaxed);
+}
+
+void AudioFileWriter::RecordDuration(int64_t nanoseconds) {
+    if (nanoseconds > longestWriteNs_.load(std::memory_order_relaxed)) {
+        longestWriteNs_.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+std::vector<uint8_t> AudioFileWriter::BuildHeader() const {
+    // Sizes reflect the data on disk so far; a CAF data chunk stays open-ended
+    // (size -1, "to end of file") until Close() so an interrupted file still reads
+    const bool isFloat = layout_.type == SampleLayout::Type::Float32;
+    const uint32_t bytesPerFrame = layout_.BytesPerFrame();
+    const uint32_t bitsPerSample = layout_.BytesPerSample() * 8;
+    std::vector<uint8_t> header;
+
+    switch (container_) {
+    case Container::Wav: {
+        // Float needs the extended fmt chunk and a fact chunk
+        const uint32_t fmtBytes = isFloat ? 18 : 16;
+        const uint32_t headerBytes = 12 + 8 + fmtBytes + (isFloat ? 12 : 0) + 8;
+        PutTag(header, "RIFF");
+        PutLE32(header, ClampToU32(headerBytes - 8 + dataBytes_));
+        PutTag(header, "WAVE");
+        PutTag(header, "fmt ");
+        PutLE32(header, fmtBytes);
+        PutLE16(header, isFloat ? 3 : 1);
+        PutLE16(header, static_cast<uint16_t>(layout_.channels));
+        PutLE32(header, static_cast<uint32_t>(std::llround(sampleRate_)));
+        PutLE32(header, static_cast<uint32_t>(std::llround(sampleRate_)) * bytesPerFrame);
+        PutLE16(header, static_cast<uint16_t>(bytesPerFrame));
+        PutLE16(header, static_cast<uint16_t>(bitsPerSample));
+        if (isFloat) {
+            PutLE16(header, 0);
+            PutTag(header, "fact");
+            PutLE32(header, 4);
+            PutLE32(header, ClampToU32(dataBytes_ / bytesPerFrame));
+        }
+        PutTag(header, "data");
+        PutLE32(header, ClampToU32(dataBytes_));
+        break;
+    }
+    case Container::Caf: {
+        uint64_t sampleRateBits;
+        std::memcpy(&sampleRateBits, &sampleRate_, sizeof(sampleRateBits));
+        PutTag(header, "caff");
+        PutBE16(header, 1);
+        PutBE16(header, 0);
+        PutTag(header, "desc");
+        PutBE64(header, 32);
+        PutBE64(header, sampleRateBits);
+        PutTag(header, "lpcm");
+        PutBE32(header, (isFloat ? 1u : 0u) | 2u);     // kCAFLinearPCMFormatFlagIsFloat | IsLittleEndian
+        PutBE32(header, bytesPerFrame);
+        PutBE32(header, 1);
+        PutBE32(header, layout_.channels);
+        PutBE32(header, bitsPerSample);
+        PutTag(header, "data");
+        PutBE64(header, finalized_ ? dataBytes_ + 4 : ~0ull);
+        PutBE32(header, 0);     // Edit count
+        break;
+    }
+    case Container::Raw:
+        break;
+    }
+    return header;
+}
+
+} // namespace Prezefren
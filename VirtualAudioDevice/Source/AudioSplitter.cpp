@@ -1,27 +1,57 @@
 #include "../Headers/AudioSplitter.h"
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cmath>
 #include <cstring>
+#include <iterator>
+#include <mach/mach_time.h>
+#include <pthread.h>
 
 namespace Prezefren {
 
+namespace {
+
+double HostTicksPerSecond() {
+    mach_timebase_info_data_t timebaseInfo;
+    mach_timebase_info(&timebaseInfo);
+    return 1e9 * timebaseInfo.denom / timebaseInfo.numer;
+}
+
+// Drops entries whose node every registration has released, so the lookup maps track live nodes only
+template <typename Map>
+void EraseExpired(Map& nodes) {
+    for (auto it = nodes.begin(); it != nodes.end();) {
+        it = it->second.expired() ? nodes.erase(it) : std::next(it);
+    }
+}
+
+} // namespace
+
 AudioSplitter::AudioSplitter()
     : isInitialized_(false)
     , inputFormat_(nullptr)
+    , maxFramesPerBuffer_(kDefaultMaxFramesPerBuffer)
     , nextDestinationId_(1)
     , totalFramesProcessed_(0)
-    , totalProcessingTime_(0.0)
+    , lastProcessTimeNs_(0)
+    , totalProcessingTimeNs_(0)
+    , formatMismatches_(0)
+    , reconfigurations_(0)
 {
 }
 
 AudioSplitter::~AudioSplitter() {
+    // Drop the published table first: it holds its own conversion references
+    destinationTable_.Publish(nullptr);
+    destinationTable_.Reclaim();
     CleanupConverters();
     if (inputFormat_) {
         [inputFormat_ release];
     }
 }
 
-bool AudioSplitter::Initialize(AVAudioFormat* inputFormat) {
+bool AudioSplitter::Initialize(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer) {
     std::lock_guard<std::mutex> lock(destinationsMutex_);
     
     if (isInitialized_) {
@@ -33,33 +63,160 @@ bool AudioSplitter::Initialize(AVAudioFormat* inputFormat) {
         return false;
     }
     
-    inputFormat_ = [inputFormat retain];
-    isInitialized_ = true;
+    if (!IsSupportedFormat(inputFormat)) {
+        NSLog(@"❌ AudioSplitter: Input must be 32-bit float or 16-bit integer PCM");
+        return false;
+    }
+    
+    SetInputFormat(inputFormat, maxFramesPerBuffer > 0 ? maxFramesPerBuffer : kDefaultMaxFramesPerBuffer);
+    PublishDestinationTable();
+    isInitialized_.store(true, std::memory_order_release);
     
-    NSLog(@"✅ AudioSplitter initialized: %.0fHz, %u channels", 
-          inputFormat.sampleRate, inputFormat.channelCount);
+    NSLog(@"✅ AudioSplitter initialized: %.0fHz, %u channels, up to %u frames per buffer", 
+          inputFormat.sampleRate, inputFormat.channelCount, maxFramesPerBuffer_);
     
     return true;
 }
 
-int AudioSplitter::AddOutputDestination(std::unique_ptr<OutputDestination> destination) {
+bool AudioSplitter::Reconfigure(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer) {
+    if (!isInitialized_.load(std::memory_order_acquire)) {
+        return Initialize(inputFormat, maxFramesPerBuffer > 0 ? maxFramesPerBuffer : kDefaultMaxFramesPerBuffer);
+    }
+    
     std::lock_guard<std::mutex> lock(destinationsMutex_);
     
+    if (!inputFormat) {
+        inputFormat = inputFormat_;
+    }
+    if (!inputFormat || !IsSupportedFormat(inputFormat)) {
+        NSLog(@"❌ AudioSplitter: Cannot reconfigure to an unsupported input format");
+        return false;
+    }
+    if (maxFramesPerBuffer == 0) {
+        maxFramesPerBuffer = maxFramesPerBuffer_;
+    }
+    if ([inputFormat isEqual:inputFormat_] && maxFramesPerBuffer == maxFramesPerBuffer_) {
+        return true;
+    }
+    
+    // Everything below runs here, off the audio thread, which keeps converting with
+    // the published table until the new one replaces it. Keep the old configuration
+    // so a destination that cannot follow the new input leaves nothing changed.
+    AVAudioFormat* previousFormat = inputFormat_;
+    SampleLayout previousLayout = inputLayout_;
+    UInt32 previousMaxFrames = maxFramesPerBuffer_;
+    UInt32 previousChannels = previousFormat.channelCount;
+    std::unordered_map<int, Registration> previousRegistry = registry_;
+    auto previousChannelNodes = std::move(channelNodes_);
+    auto previousRateNodes = std::move(rateNodes_);
+    channelNodes_.clear();
+    rateNodes_.clear();
+    
+    SetInputFormat(inputFormat, maxFramesPerBuffer);
+    
+    bool rebuilt = true;
+    for (int id : destinationOrder_) {
+        if (!RebindDestination(registry_.at(id), previousRegistry.at(id), previousFormat, previousChannels)) {
+            NSLog(@"❌ AudioSplitter: Destination '%s' cannot follow %.0fHz %uch input; keeping %.0fHz %uch",
+                  registry_.at(id).destination->name.c_str(), inputFormat.sampleRate, inputFormat.channelCount,
+                  previousFormat.sampleRate, previousChannels);
+            rebuilt = false;
+            break;
+        }
+    }
+    
+    if (!rebuilt) {
+        // The previous registrations still hold the untouched destinations
+        registry_ = std::move(previousRegistry);
+        channelNodes_ = std::move(previousChannelNodes);
+        rateNodes_ = std::move(previousRateNodes);
+        [inputFormat_ release];
+        inputFormat_ = previousFormat;
+        inputLayout_ = previousLayout;
+        maxFramesPerBuffer_ = previousMaxFrames;
+        return false;
+    }
+    
+    // The swap: the next callback runs entirely on the new graph. The old table, and
+    // with it the old conversions, goes away at the next reclamation.
+    PublishDestinationTable();
+    ++reconfigurations_;
+    [previousFormat release];
+    
+    NSLog(@"✅ AudioSplitter reconfigured: %.0fHz, %u channels, up to %u frames per buffer (%zu destinations)",
+          inputFormat.sampleRate, inputFormat.channelCount, maxFramesPerBuffer_, destinationOrder_.size());
+    return true;
+}
+
+void AudioSplitter::SetInputFormat(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer) {
+    // Caller holds destinationsMutex_ and owns releasing any previous format
+    inputFormat_ = [inputFormat retain];
+    inputLayout_ = LayoutOf(inputFormat);
+    maxFramesPerBuffer_ = maxFramesPerBuffer;
+}
+
+bool AudioSplitter::RebindDestination(
+    Registration& registration,
+    const Registration& previous,
+    AVAudioFormat* previousFormat,
+    UInt32 previousChannels
+) {
+    // The published table still references the current destination: rebind a copy
+    // and leave that one as it is until the old table is reclaimed
+    auto rebound = std::make_shared<OutputDestination>(*previous.destination);
+    registration.destination = rebound;
+    OutputDestination& destination = *rebound;
+    
+    // Passthrough destinations were created with the input format itself and keep
+    // following it; every other destination keeps the format it asked for
+    if (destination.format == previousFormat) {
+        destination.format = inputFormat_;
+    }
+    if (!destination.routing.empty()) {
+        UInt32 outputChannels = static_cast<UInt32>(destination.routing.size() / previousChannels);
+        destination.routing = RoutingMatrix::Adapt(destination.routing, outputChannels, previousChannels,
+                                                   inputFormat_.channelCount);
+    }
+    
+    registration.conversion = nullptr;
+    registration.reblocker = nullptr;
+    registration.effects = nullptr;
+    registration.formatter = nullptr;
+    registration.async = nullptr;
+    if (destination.format && NeedsConversion(destination)) {
+        registration.conversion = AcquireConversion(destination.format, destination.routing, destination.delivery);
+        if (!registration.conversion) {
+            return false;
+        }
+        registration.conversion->fadeFrames = FramesForDuration(registration.conversion->sampleRate, kReconfigureFadeMs);
+    }
+    return BuildDelivery(registration, &previous);
+}
+
+int AudioSplitter::AddOutputDestination(std::unique_ptr<OutputDestination> destination) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    return RegisterDestination(std::move(destination));
+}
+
+int AudioSplitter::RegisterDestination(std::unique_ptr<OutputDestination> destination) {
+    // Caller holds destinationsMutex_, so the input format cannot change under the
+    // destination between its creation and its first conversion
     if (!destination) {
         return -1;
     }
     
-    int id = nextDestinationId_++;
-    destination->enabled = true;
+    if (destination->format && !IsSupportedFormat(destination->format)) {
+        NSLog(@"❌ AudioSplitter: Destination '%s' must use 32-bit float or 16-bit integer PCM",
+              destination->name.c_str());
+        return -1;
+    }
     
-    // Create format converter if needed
-    if (destination->format && ![destination->format isEqual:inputFormat_]) {
-        NSError* error = nil;
-        AVAudioConverter* converter = [[AVAudioConverter alloc] 
-            initFromFormat:inputFormat_ toFormat:destination->format];
+    // Create format converter and its buffers if needed
+    std::shared_ptr<RateNode> conversion;
+    if (destination->format && NeedsConversion(*destination)) {
+        conversion = AcquireConversion(destination->format, destination->routing, destination->delivery);
         
-        if (converter && !error) {
-            formatConverters_[id] = converter;
+        if (conversion) {
             NSLog(@"✅ AudioSplitter: Created format converter for destination '%s': %.0fHz %uch -> %.0fHz %uch",
                   destination->name.c_str(),
                   inputFormat_.sampleRate, inputFormat_.channelCount,
@@ -67,128 +224,464 @@ int AudioSplitter::AddOutputDestination(std::unique_ptr<OutputDestination> desti
         } else {
             NSLog(@"❌ AudioSplitter: Failed to create format converter for destination '%s'", 
                   destination->name.c_str());
-            [converter release];
             return -1;
         }
     }
     
-    destinations_.push_back(std::move(destination));
+    int id = nextDestinationId_++;
+    destination->id = id;
+    destination->enabled = true;
+    
+    Registration& registration = registry_[id];
+    registration.destination = std::shared_ptr<OutputDestination>(std::move(destination));
+    registration.conversion = std::move(conversion);
+    if (!BuildDelivery(registration, nullptr)) {
+        registry_.erase(id);
+        return -1;
+    }
+    destinationOrder_.push_back(id);
+    PublishDestinationTable();
     
     NSLog(@"✅ AudioSplitter: Added destination '%s' with ID %d", 
-          destinations_.back()->name.c_str(), id);
+          registration.destination->name.c_str(), id);
     
     return id;
 }
 
-void AudioSplitter::RemoveOutputDestination(int destinationId) {
+bool AudioSplitter::NeedsConversion(const OutputDestination& destination) const {
+    // DSP chains work on planar float and the reblocker on float, so other input
+    // layouts go through the graph for them
+    bool inputPlanarFloat = inputLayout_.IsPlanarFloat();
+    bool inputFloat = inputLayout_.type == SampleLayout::Type::Float32;
+    return ![destination.format isEqual:inputFormat_] || !destination.routing.empty() ||
+           destination.delivery.compensateDrift ||
+           (!destination.effects.empty() && !inputPlanarFloat) ||
+           (destination.delivery.blockFrames > 0 && !inputFloat);
+}
+
+bool AudioSplitter::BuildDelivery(Registration& registration, const Registration* previous) {
+    // Everything between the conversion and the callback. Across a Reconfigure(),
+    // previous is the destination's old registration: a converted destination that
+    // stays converted at the same channels and rate keeps its reblocker, DSP chain
+    // and async delivery, with their queued audio and state.
+    const OutputDestination& destination = *registration.destination;
+    const RateNode* conversion = registration.conversion.get();
+    const bool sameShape = previous && previous->conversion && conversion &&
+                           previous->conversion->outputList->mNumberBuffers == conversion->outputList->mNumberBuffers &&
+                           previous->conversion->sampleRate == conversion->sampleRate;
+    
+    // The consumer thread owns the ring's reblocker and formatter. They were sized
+    // for the ring's slots, and the ring splits larger blocks across slots, so the
+    // whole consumer side carries over even if the new conversion produces more
+    // frames per callback. Keeping it keeps the delivered audio in order.
+    const bool keepAsync = destination.delivery.asynchronous && sameShape && previous->async;
+    if (keepAsync) {
+        registration.async = previous->async;
+        registration.reblocker = previous->async->reblocker;
+        registration.formatter = previous->async->formatter;
+    }
+    
+    if (destination.delivery.blockFrames > 0 && !keepAsync) {
+        registration.reblocker = sameShape && previous->reblocker
+            ? previous->reblocker
+            : CreateReblocker(destination, conversion);
+        if (!registration.reblocker) {
+            NSLog(@"❌ AudioSplitter: Failed to create %u-frame reblocker for destination '%s'",
+                  destination.delivery.blockFrames, destination.name.c_str());
+            return false;
+        }
+    }
+    if (!destination.effects.empty()) {
+        if (sameShape && previous->effects) {
+            registration.effects = previous->effects;
+        } else {
+            registration.effects = CreateEffects(destination, conversion);
+            if (!registration.effects || !registration.effects->chain.SetStages(destination.effects)) {
+                NSLog(@"❌ AudioSplitter: Invalid DSP chain for destination '%s'", destination.name.c_str());
+                registration.effects = nullptr;
+                return false;
+            }
+        }
+    }
+    if (conversion && !LayoutOf(destination.format).IsPlanarFloat() && !keepAsync) {
+        UInt32 neededFrames = std::max(conversion->outputCapacity, destination.delivery.blockFrames);
+        registration.formatter = sameShape && previous->formatter && previous->formatter->maxFrames >= neededFrames
+            ? previous->formatter
+            : CreateFormatter(destination, conversion);
+        if (!registration.formatter) {
+            NSLog(@"❌ AudioSplitter: Unsupported output layout for destination '%s'", destination.name.c_str());
+            return false;
+        }
+    }
+    if (destination.delivery.asynchronous && !keepAsync) {
+        registration.async = StartAsyncDelivery(registration.destination, conversion, registration.reblocker,
+                                                registration.formatter);
+        if (!registration.async) {
+            NSLog(@"❌ AudioSplitter: Failed to start async delivery for destination '%s'", destination.name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AudioSplitter::RemoveOutputDestination(int destinationId) {
     std::lock_guard<std::mutex> lock(destinationsMutex_);
     
-    // Remove format converter
-    auto converterIt = formatConverters_.find(destinationId);
-    if (converterIt != formatConverters_.end()) {
-        [converterIt->second release];
-        formatConverters_.erase(converterIt);
+    auto it = registry_.find(destinationId);
+    if (it == registry_.end()) {
+        NSLog(@"⚠️ AudioSplitter: No destination with ID %d", destinationId);
+        return false;
     }
     
-    // Find and remove destination
-    auto it = std::find_if(destinations_.begin(), destinations_.end(),
-        [destinationId](const std::unique_ptr<OutputDestination>& dest) {
-            return dest.get() != nullptr; // Simple check since we don't store ID in destination
-        });
+    NSLog(@"✅ AudioSplitter: Removed destination '%s' (ID %d)",
+          it->second.destination->name.c_str(), destinationId);
+    registry_.erase(it);
+    destinationOrder_.erase(std::find(destinationOrder_.begin(), destinationOrder_.end(), destinationId));
+    
+    // The audio thread may still hold the old table; its references keep the
+    // removed destination and conversion alive until reclamation. Usually it is
+    // between callbacks, so reclaim right away: a removed recording drains and
+    // closes its file here rather than at some later configuration change.
+    PublishDestinationTable();
+    destinationTable_.Reclaim();
+    return true;
+}
+
+bool AudioSplitter::SetDestinationEnabled(int destinationId, bool enabled) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    auto it = registry_.find(destinationId);
+    if (it == registry_.end()) {
+        NSLog(@"⚠️ AudioSplitter: No destination with ID %d", destinationId);
+        return false;
+    }
     
-    if (it != destinations_.end()) {
-        NSLog(@"✅ AudioSplitter: Removed destination '%s'", (*it)->name.c_str());
-        destinations_.erase(it);
+    // Only the configuration side reads this flag; the audio thread sees the change
+    // as a destination appearing in or leaving the next published table
+    if (it->second.destination->enabled != enabled) {
+        it->second.destination->enabled = enabled;
+        PublishDestinationTable();
     }
+    return true;
 }
 
-void AudioSplitter::SetDestinationEnabled(int destinationId, bool enabled) {
+bool AudioSplitter::SetDestinationEffects(int destinationId, const std::vector<DspChain::Stage>& stages) {
     std::lock_guard<std::mutex> lock(destinationsMutex_);
     
-    // Note: In a real implementation, we'd need to store destination ID
-    // For now, we'll enable/disable all destinations of a certain type
-    for (auto& dest : destinations_) {
-        if (dest) {
-            dest->enabled = enabled;
+    auto it = registry_.find(destinationId);
+    if (it == registry_.end()) {
+        NSLog(@"⚠️ AudioSplitter: No destination with ID %d", destinationId);
+        return false;
+    }
+    
+    Registration& registration = it->second;
+    if (!registration.effects) {
+        if (stages.empty()) {
+            return true;
+        }
+        if (!registration.conversion && !inputLayout_.IsPlanarFloat()) {
+            NSLog(@"❌ AudioSplitter: '%s' receives non-planar audio; add its DSP chain at creation",
+                  registration.destination->name.c_str());
+            return false;
+        }
+        
+        // First chain for this destination: set it up, then publish a table that runs it
+        auto effects = CreateEffects(*registration.destination, registration.conversion.get());
+        if (!effects || !effects->chain.SetStages(stages)) {
+            return false;
+        }
+        registration.effects = std::move(effects);
+        registration.destination->effects = stages;
+        PublishDestinationTable();
+        return true;
+    }
+    
+    // Existing chain: the new stages are published to the audio thread lock-free
+    if (!registration.effects->chain.SetStages(stages)) {
+        NSLog(@"❌ AudioSplitter: Invalid DSP chain for destination '%s'", registration.destination->name.c_str());
+        return false;
+    }
+    registration.destination->effects = stages;
+    return true;
+}
+
+void AudioSplitter::PublishDestinationTable() {
+    // Caller holds destinationsMutex_. The table is built here, off the audio thread,
+    // so ProcessAudioBuffer only ever reads finished, immutable data.
+    // Only nodes with an enabled consumer are listed, each exactly once.
+    auto table = std::make_unique<DestinationTable>();
+    table->inputLayout = inputLayout_;
+    table->maxFrames = maxFramesPerBuffer_;
+    table->entries.reserve(destinationOrder_.size());
+    for (int id : destinationOrder_) {
+        const Registration& registration = registry_.at(id);
+        if (!registration.destination->enabled || !registration.destination->callback) {
+            continue;
         }
+        
+        const std::shared_ptr<RateNode>& node = registration.conversion;
+        if (node) {
+            if (std::find(table->rateNodes.begin(), table->rateNodes.end(), node) == table->rateNodes.end()) {
+                table->rateNodes.push_back(node);
+            }
+            if (std::find(table->channelNodes.begin(), table->channelNodes.end(), node->source) == table->channelNodes.end()) {
+                table->channelNodes.push_back(node->source);
+            }
+        }
+        table->entries.push_back({registration.destination, node.get(), registration.async,
+                                  registration.async ? nullptr : registration.reblocker, registration.effects,
+                                  registration.async ? nullptr : registration.formatter});
     }
+    
+    destinationTable_.Publish(std::move(table));
+}
+
+bool AudioSplitter::IsActive() const {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    return isInitialized_.load(std::memory_order_acquire) && !registry_.empty();
 }
 
 void AudioSplitter::ProcessAudioBuffer(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-    if (!isInitialized_) {
+    if (!isInitialized_.load(std::memory_order_acquire)) {
         return;
     }
     
     auto startTime = std::chrono::high_resolution_clock::now();
+    UInt32 frames = 0;
     
-    std::lock_guard<std::mutex> lock(destinationsMutex_);
-    
-    // Process for each enabled destination
-    for (const auto& dest : destinations_) {
-        if (dest && dest->enabled && dest->callback) {
-            ConvertAndSendToDestination(*dest, bufferList, timeStamp);
-        }
-    }
-    
-    // Update statistics
     {
-        std::lock_guard<std::mutex> statsLock(statsMutex_);
-        totalFramesProcessed_ += bufferList.mBuffers[0].mDataByteSize / sizeof(float);
+        // Lock-free snapshot: configuration changes publish a new table instead of
+        // mutating this one, so the audio thread never waits on the UI thread.
+        // The whole buffer is converted with this one table, even mid-Reconfigure().
+        RcuPointer<DestinationTable>::ReadGuard table(destinationTable_);
+        if (!table) {
+            return;
+        }
         
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        totalProcessingTime_ += duration.count() / 1000.0; // Convert to milliseconds
-        lastProcessTime_ = endTime;
+        // Buffers still arriving in the old layout around a Reconfigure() are dropped
+        // rather than misread
+        const SampleLayout& layout = table->inputLayout;
+        if (bufferList.mNumberBuffers == 0 || bufferList.mNumberBuffers > layout.BufferCount() ||
+            bufferList.mBuffers[0].mNumberChannels != layout.ChannelsPerBuffer()) {
+            formatMismatches_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        frames = layout.FramesIn(bufferList.mBuffers[0].mDataByteSize);
+        RunConversionGraph(*table.get(), bufferList, timeStamp);
     }
+    
+    // Update statistics (single writer, relaxed atomics are sufficient)
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    totalFramesProcessed_.fetch_add(frames, std::memory_order_relaxed);
+    totalProcessingTimeNs_.fetch_add(duration.count(), std::memory_order_relaxed);
+    lastProcessTimeNs_.store(endTime.time_since_epoch().count(), std::memory_order_relaxed);
 }
 
-int AudioSplitter::CreateTranscriptionDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+int AudioSplitter::CreateTranscriptionDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                                  const DeliveryOptions& delivery) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
     auto format = CreateTranscriptionFormat();
     auto destination = std::make_unique<OutputDestination>(
         "Transcription",
         std::move(callback),
-        format
+        format,
+        delivery
     );
     
-    return AddOutputDestination(std::move(destination));
+    return RegisterDestination(std::move(destination));
 }
 
-int AudioSplitter::CreatePassthroughDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+int AudioSplitter::CreatePassthroughDestination(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                                const DeliveryOptions& delivery) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
     // Use original format for passthrough (no conversion)
     auto destination = std::make_unique<OutputDestination>(
         "Passthrough",
         std::move(callback),
-        inputFormat_
+        inputFormat_,
+        delivery
     );
     
-    return AddOutputDestination(std::move(destination));
+    return RegisterDestination(std::move(destination));
 }
 
-int AudioSplitter::CreateChannelDestination(int channel, std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+int AudioSplitter::CreateChannelDestination(int channel, std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                            const DeliveryOptions& delivery) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    UInt32 inputChannels = inputFormat_ ? inputFormat_.channelCount : 0;
+    if (channel < 0 || static_cast<UInt32>(channel) >= inputChannels) {
+        NSLog(@"❌ AudioSplitter: Channel %d out of range (%u input channels)", channel, inputChannels);
+        return -1;
+    }
+    
     auto format = CreateChannelFormat(1); // Mono output for single channel
     auto destination = std::make_unique<OutputDestination>(
         channel == 0 ? "Left Channel" : "Right Channel",
         std::move(callback),
-        format
+        format,
+        delivery
     );
+    destination->routing = RoutingMatrix::Extract(inputChannels, channel);
     
-    return AddOutputDestination(std::move(destination));
+    return RegisterDestination(std::move(destination));
+}
+
+int AudioSplitter::CreateMatrixDestination(const std::string& name, UInt32 outputChannels, const std::vector<float>& gains,
+                                           double sampleRate,
+                                           std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback,
+                                           const DeliveryOptions& delivery) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    UInt32 inputChannels = inputFormat_ ? inputFormat_.channelCount : 0;
+    if (outputChannels == 0 || gains.size() != static_cast<size_t>(outputChannels) * inputChannels) {
+        NSLog(@"❌ AudioSplitter: Matrix for '%s' must be %u x %u gains", name.c_str(), outputChannels, inputChannels);
+        return -1;
+    }
+    
+    auto format = CreateChannelFormat(outputChannels, sampleRate);
+    auto destination = std::make_unique<OutputDestination>(
+        name,
+        std::move(callback),
+        format,
+        delivery
+    );
+    destination->routing = gains;
+    
+    return RegisterDestination(std::move(destination));
+}
+
+int AudioSplitter::CreateRecordingDestination(const std::string& path, const RecordingOptions& options) {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    UInt32 inputChannels = inputFormat_ ? inputFormat_.channelCount : 0;
+    if (inputChannels == 0) {
+        NSLog(@"❌ AudioSplitter: Initialize before recording to '%s'", path.c_str());
+        return -1;
+    }
+    
+    UInt32 channels = options.channels > 0 ? options.channels : inputChannels;
+    double sampleRate = options.sampleRate > 0.0 ? options.sampleRate : inputFormat_.sampleRate;
+    AVAudioFormat* format = [[AVAudioFormat alloc]
+        initWithCommonFormat:options.sampleType == SampleLayout::Type::Int16 ? AVAudioPCMFormatInt16 : AVAudioPCMFormatFloat32
+                  sampleRate:sampleRate
+                    channels:channels
+                 interleaved:YES];
+    if (!format || !IsSupportedFormat(format)) {
+        NSLog(@"❌ AudioSplitter: Cannot record %u channels at %.0fHz", channels, sampleRate);
+        [format release];
+        return -1;
+    }
+    
+    auto recorder = std::make_shared<AudioFileWriter>();
+    if (!recorder->Open(path, options.container, LayoutOf(format), sampleRate, options.syncIntervalSeconds)) {
+        NSLog(@"❌ AudioSplitter: Cannot create recording '%s' (errno %d)",
+              path.c_str(), recorder->GetStatistics().lastError);
+        [format release];
+        return -1;
+    }
+    
+    // The ring absorbs disk stalls. Its slots hold one converted input buffer, so
+    // the capacity assumes full-size buffers.
+    DeliveryOptions delivery;
+    delivery.asynchronous = true;
+    delivery.overflowPolicy = AudioBlockRing::OverflowPolicy::DropNewest;
+    delivery.drainOnStop = true;
+    delivery.ringCapacityBlocks = std::max<UInt32>(
+        32, static_cast<UInt32>(std::ceil(options.bufferSeconds * inputFormat_.sampleRate / maxFramesPerBuffer_)));
+    
+    // Interleaved (or mono) by construction, so every block is one buffer
+    auto destination = std::make_unique<OutputDestination>(
+        "Recording",
+        [recorder](const AudioBufferList& bufferList, const AudioTimeStamp&) {
+            if (bufferList.mNumberBuffers > 0) {
+                recorder->Write(bufferList.mBuffers[0].mData, bufferList.mBuffers[0].mDataByteSize);
+            }
+        },
+        format,
+        delivery
+    );
+    // An explicit matrix keeps the recording on the conversion graph even when its
+    // format matches the input, so it never becomes passthrough and keeps its async
+    // delivery (and file order) across Reconfigure()
+    destination->routing = channels == 1 && inputChannels > 1
+        ? RoutingMatrix::Downmix(inputChannels)
+        : RoutingMatrix::Map(inputChannels, channels);
+    
+    int id = RegisterDestination(std::move(destination));
+    if (id < 0) {
+        return -1;
+    }
+    
+    registry_.at(id).recorder = recorder;
+    NSLog(@"✅ AudioSplitter: Recording to '%s': %.0fHz %uch, %.1f s buffered",
+          path.c_str(), sampleRate, channels, options.bufferSeconds);
+    return id;
+}
+
+bool AudioSplitter::GetRecordingStatistics(int destinationId, AudioFileWriter::Statistics& stats) const {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    auto it = registry_.find(destinationId);
+    if (it == registry_.end() || !it->second.recorder) {
+        return false;
+    }
+    stats = it->second.recorder->GetStatistics();
+    return true;
 }
 
 AudioSplitter::Statistics AudioSplitter::GetStatistics() const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    uint64_t frames = totalFramesProcessed_.load(std::memory_order_relaxed);
+    double processingTimeMs = totalProcessingTimeNs_.load(std::memory_order_relaxed) / 1e6;
     
     Statistics stats;
-    stats.totalFramesProcessed = totalFramesProcessed_;
-    stats.activeDestinations = destinations_.size();
-    stats.averageProcessingTime = totalFramesProcessed_ > 0 ? 
-        totalProcessingTime_ / totalFramesProcessed_ : 0.0;
+    stats.totalFramesProcessed = frames;
+    stats.activeDestinations = registry_.size();
+    stats.averageProcessingTime = frames > 0 ? processingTimeMs / frames : 0.0;
     stats.inputSampleRate = inputFormat_ ? inputFormat_.sampleRate : 0.0;
     stats.inputChannels = inputFormat_ ? inputFormat_.channelCount : 0;
+    stats.asyncOverflows = 0;
+    stats.asyncOverwrites = 0;
+    stats.formatMismatches = formatMismatches_.load(std::memory_order_relaxed);
+    stats.reconfigurations = reconfigurations_;
+    for (const auto& pair : registry_) {
+        if (pair.second.async) {
+            stats.asyncOverflows += pair.second.async->ring.GetOverflowCount();
+            stats.asyncOverwrites += pair.second.async->ring.GetOverwriteCount();
+        }
+    }
     
     return stats;
 }
 
+bool AudioSplitter::GetDestinationStatistics(int destinationId, DestinationStatistics& stats) const {
+    std::lock_guard<std::mutex> lock(destinationsMutex_);
+    
+    auto it = registry_.find(destinationId);
+    if (it == registry_.end()) {
+        return false;
+    }
+    
+    const AsyncDelivery* async = it->second.async.get();
+    stats.asynchronous = async != nullptr;
+    stats.deliveredBlocks = async ? async->deliveredBlocks.load(std::memory_order_relaxed) : 0;
+    stats.queuedBlocks = async ? async->ring.GetQueuedBlocks() : 0;
+    stats.overflows = async ? async->ring.GetOverflowCount() : 0;
+    stats.overwrites = async ? async->ring.GetOverwriteCount() : 0;
+    const RateNode* conversion = it->second.conversion.get();
+    stats.conversionLatency = conversion ? conversion->resampler.GetDelayInputFrames() / inputFormat_.sampleRate : 0.0;
+    const DriftEstimator* drift = conversion ? conversion->drift.get() : nullptr;
+    stats.driftCompensated = drift != nullptr;
+    stats.driftPpm = drift ? drift->GetDriftPpm() : 0.0;
+    stats.ratioAdjustment = drift ? drift->GetRatioAdjustment() : 1.0;
+    return true;
+}
+
 AVAudioFormat* AudioSplitter::CreateTranscriptionFormat() const {
     // Optimized format for speech recognition: 16kHz mono
     return [[AVAudioFormat alloc] initWithCommonFormat:AVAudioPCMFormatFloat32
@@ -197,85 +690,613 @@ AVAudioFormat* AudioSplitter::CreateTranscriptionFormat() const {
                                            interleaved:NO];
 }
 
-AVAudioFormat* AudioSplitter::CreateChannelFormat(int channelCount) const {
-    // Use input sample rate but specified channel count
-    double sampleRate = inputFormat_ ? inputFormat_.sampleRate : 48000.0;
+AVAudioFormat* AudioSplitter::CreateChannelFormat(int channelCount, double sampleRate) const {
+    // Use input sample rate unless one is given, with the specified channel count
+    if (sampleRate <= 0.0) {
+        sampleRate = inputFormat_ ? inputFormat_.sampleRate : 48000.0;
+    }
     return [[AVAudioFormat alloc] initWithCommonFormat:AVAudioPCMFormatFloat32
                                             sampleRate:sampleRate
                                               channels:channelCount
                                            interleaved:NO];
 }
 
-void AudioSplitter::ConvertAndSendToDestination(
-    const OutputDestination& dest,
+void AudioSplitter::RunConversionGraph(
+    const DestinationTable& table,
     const AudioBufferList& bufferList, 
     const AudioTimeStamp& timeStamp
-) {
-    // Find converter for this destination
-    AVAudioConverter* converter = nullptr;
-    for (const auto& pair : formatConverters_) {
-        // In a real implementation, we'd match by destination ID
-        converter = pair.second;
-        break; // For now, use first available converter
-    }
-    
-    if (converter) {
-        // Create input buffer from AudioBufferList
-        AVAudioPCMBuffer* inputBuffer = [[AVAudioPCMBuffer alloc] 
-            initWithPCMFormat:inputFormat_ 
-               frameCapacity:bufferList.mBuffers[0].mDataByteSize / sizeof(float)];
+) const {
+    // Passthrough destinations get the original buffer untouched
+    for (const auto& entry : table.entries) {
+        if (!entry.node) {
+            Deliver(entry, bufferList, timeStamp);
+        }
+    }
+    
+    if (table.rateNodes.empty()) {
+        return;
+    }
+    
+    UInt32 totalFrames = table.inputLayout.FramesIn(bufferList.mBuffers[0].mDataByteSize);
+    
+    // Convert in slices no larger than the preallocated capacity:
+    // downmix once per layout, resample once per (layout, rate), then fan out
+    for (UInt32 offset = 0; offset < totalFrames; ) {
+        UInt32 frames = std::min(totalFrames - offset, table.maxFrames);
+        
+        for (const auto& channelNode : table.channelNodes) {
+            RunChannelNode(*channelNode, table.inputLayout, bufferList, offset, frames);
+        }
+        
+        for (const auto& rateNode : table.rateNodes) {
+            RateNode& node = *rateNode;
+            StampRateNode(node, timeStamp, offset, node.resampler.GetNextOutputPosition());
+            node.producedFrames = node.resampler.Process(node.source->outputPointers.data(), frames,
+                                                         node.outputPointers.data(), node.outputCapacity);
+            if (node.drift) {
+                UpdateDrift(node, frames);
+            }
+            if (node.fadePosition < node.fadeFrames) {
+                ApplyFadeIn(node);
+            }
+            for (UInt32 c = 0; c < node.outputList->mNumberBuffers; ++c) {
+                node.outputList->mBuffers[c].mDataByteSize = node.producedFrames * sizeof(float);
+            }
+        }
         
-        if (inputBuffer) {
-            // Copy data to input buffer
-            inputBuffer.frameLength = bufferList.mBuffers[0].mDataByteSize / sizeof(float);
-            memcpy(inputBuffer.floatChannelData[0], 
-                   bufferList.mBuffers[0].mData, 
-                   bufferList.mBuffers[0].mDataByteSize);
-            
-            // Create output buffer
-            AVAudioPCMBuffer* outputBuffer = [[AVAudioPCMBuffer alloc] 
-                initWithPCMFormat:dest.format 
-                   frameCapacity:inputBuffer.frameLength * 2]; // Allow for sample rate conversion
-            
-            if (outputBuffer) {
-                NSError* error = nil;
-                AVAudioConverterInputStatus status = [converter convertToBuffer:outputBuffer
-                                                                          error:&error
-                                                             withInputFromBlock:^AVAudioBuffer* _Nullable(AVAudioPacketCount inNumberOfPackets, AVAudioConverterInputStatus* _Nonnull outStatus) {
-                    *outStatus = AVAudioConverterInputStatus_HaveData;
-                    return inputBuffer;
-                }];
-                
-                if (status == AVAudioConverterInputStatus_HaveData && !error) {
-                    // Convert AVAudioPCMBuffer back to AudioBufferList for callback
-                    AudioBufferList convertedBufferList;
-                    convertedBufferList.mNumberBuffers = 1;
-                    convertedBufferList.mBuffers[0].mNumberChannels = dest.format.channelCount;
-                    convertedBufferList.mBuffers[0].mDataByteSize = outputBuffer.frameLength * sizeof(float);
-                    convertedBufferList.mBuffers[0].mData = outputBuffer.floatChannelData[0];
-                    
-                    dest.callback(convertedBufferList, timeStamp);
-                } else {
-                    NSLog(@"❌ AudioSplitter: Format conversion failed for destination '%s': %@", 
-                          dest.name.c_str(), error.localizedDescription);
-                }
-                
-                [outputBuffer release];
+        for (const auto& entry : table.entries) {
+            if (entry.node && entry.node->producedFrames > 0) {
+                Deliver(entry, *entry.node->outputList, entry.node->outputTimeStamp);
             }
-            
-            [inputBuffer release];
+        }
+        
+        offset += frames;
+    }
+}
+
+void AudioSplitter::UpdateDrift(RateNode& node, UInt32 inputFrames) const {
+    // The new ratio applies from the next output frame on; the resampler interpolates
+    // its phase, so the correction never produces a discontinuity
+    if (node.fillLevel) {
+        node.drift->UpdateFillLevel(node.fillLevel(), inputFrames * node.rateRatio / node.sampleRate);
+    } else if (node.outputTimeStamp.mFlags & kAudioTimeStampHostTimeValid) {
+        node.drift->UpdateTimeStamp(node.outputTimeStamp.mHostTime, node.producedFrames);
+    }
+    node.resampler.SetRatioAdjustment(node.drift->GetRatioAdjustment());
+}
+
+void AudioSplitter::ApplyFadeIn(RateNode& node) {
+    // Raised-cosine ramp over the first output frames of a conversion built by
+    // Reconfigure(): its resampler starts from an empty history, and the ramp keeps
+    // the step from silence into the new input from clicking
+    const UInt32 frames = std::min(node.producedFrames, node.fadeFrames - node.fadePosition);
+    for (UInt32 i = 0; i < frames; ++i) {
+        float gain = static_cast<float>(0.5 - 0.5 * std::cos(M_PI * (node.fadePosition + i) / node.fadeFrames));
+        for (float* channel : node.outputPointers) {
+            channel[i] *= gain;
+        }
+    }
+    node.fadePosition += frames;
+}
+
+void AudioSplitter::StampRateNode(
+    RateNode& node,
+    const AudioTimeStamp& timeStamp,
+    UInt32 offset,
+    double outputPosition
+) const {
+    // The slice's first output frame sits at offset + outputPosition input frames from
+    // the callback's first frame; carry that instant onto the output timeline
+    double inputFrames = offset + outputPosition;
+    node.outputTimeStamp = timeStamp;
+    node.outputTimeStamp.mSampleTime = (timeStamp.mSampleTime + inputFrames) * node.rateRatio;
+    if (timeStamp.mFlags & kAudioTimeStampHostTimeValid) {
+        double hostTime = static_cast<double>(timeStamp.mHostTime) + inputFrames * node.hostTicksPerInputFrame;
+        node.outputTimeStamp.mHostTime = hostTime > 0.0 ? static_cast<UInt64>(std::llround(hostTime)) : 0;
+    }
+}
+
+void AudioSplitter::RunChannelNode(
+    ChannelNode& node,
+    const SampleLayout& inputLayout,
+    const AudioBufferList& bufferList,
+    UInt32 offset,
+    UInt32 frames
+) const {
+    UInt32 inputChannels = inputLayout.channels;
+    
+    // Planar float view of the input: the caller's buffers, or the specialized read
+    // kernel's output for any other layout
+    if (node.readKernel) {
+        UInt32 bufferCount = inputLayout.BufferCount();
+        if (bufferList.mNumberBuffers < bufferCount) {
+            // Malformed list: deliver silence rather than read past it
+            std::fill(node.inputStorage.begin(), node.inputStorage.end(), 0.0f);
+        } else {
+            for (UInt32 b = 0; b < bufferCount; ++b) {
+                node.inputBuffers[b] = bufferList.mBuffers[b].mData;
+            }
+            node.readKernel(node.inputBuffers.data(), inputChannels, offset, frames, node.inputStoragePointers.data());
         }
     } else {
-        // No conversion needed, send original buffer
-        dest.callback(bufferList, timeStamp);
+        for (UInt32 c = 0; c < inputChannels; ++c) {
+            node.inputPointers[c] = c < bufferList.mNumberBuffers
+                ? static_cast<const float*>(bufferList.mBuffers[c].mData) + offset
+                : node.silence.data();
+        }
+    }
+    
+    if (!node.matrix.IsSelection()) {
+        node.matrix.Process(node.inputPointers.data(), node.mixPointers.data(), frames);
+    }
+    
+    for (UInt32 c = 0; c < node.matrix.GetOutputCount(); ++c) {
+        int selected = node.matrix.GetSelectedInput(c);
+        node.outputPointers[c] = node.matrix.IsSelection() ? node.inputPointers[selected] : node.mixPointers[c];
     }
 }
 
-void AudioSplitter::CleanupConverters() {
-    for (auto& pair : formatConverters_) {
-        [pair.second release];
+std::shared_ptr<AudioSplitter::ChannelNode> AudioSplitter::AcquireChannelNode(UInt32 outputChannels, const std::vector<float>& gains) {
+    auto found = channelNodes_.find(gains);
+    if (found != channelNodes_.end()) {
+        if (auto existing = found->second.lock()) {
+            return existing;
+        }
+    }
+    
+    UInt32 inputChannels = inputFormat_.channelCount;
+    auto node = std::make_shared<ChannelNode>();
+    if (!node->matrix.Configure(inputChannels, outputChannels, gains)) {
+        return nullptr;
+    }
+    
+    // Planar float input is read in place; every other layout gets a kernel picked here
+    node->readKernel = inputLayout_.IsPlanarFloat() ? nullptr : SampleKernels::SelectRead(inputLayout_);
+    node->silence.assign(maxFramesPerBuffer_, 0.0f);
+    node->inputPointers.assign(inputChannels, nullptr);
+    if (node->readKernel) {
+        node->inputStorage.assign(static_cast<size_t>(inputChannels) * maxFramesPerBuffer_, 0.0f);
+        node->inputBuffers.assign(inputLayout_.BufferCount(), nullptr);
+        for (UInt32 c = 0; c < inputChannels; ++c) {
+            node->inputStoragePointers.push_back(&node->inputStorage[static_cast<size_t>(c) * maxFramesPerBuffer_]);
+            node->inputPointers[c] = node->inputStoragePointers[c];
+        }
+    }
+    node->outputPointers.assign(outputChannels, nullptr);
+    if (!node->matrix.IsSelection()) {
+        node->mixStorage.assign(static_cast<size_t>(outputChannels) * maxFramesPerBuffer_, 0.0f);
+        for (UInt32 c = 0; c < outputChannels; ++c) {
+            node->mixPointers.push_back(&node->mixStorage[static_cast<size_t>(c) * maxFramesPerBuffer_]);
+        }
+    }
+    
+    EraseExpired(channelNodes_);
+    channelNodes_[gains] = node;
+    return node;
+}
+
+std::shared_ptr<AudioSplitter::RateNode> AudioSplitter::AcquireConversion(
+    AVAudioFormat* outputFormat,
+    const std::vector<float>& routing,
+    const DeliveryOptions& delivery
+) {
+    UInt32 inputChannels = inputFormat_.channelCount;
+    UInt32 outputChannels = outputFormat.channelCount;
+    
+    // Default routing keeps the old behaviour: average to mono, otherwise map channels in order
+    std::vector<float> gains = routing;
+    if (gains.empty()) {
+        gains = outputChannels == 1 && inputChannels > 1
+            ? RoutingMatrix::Downmix(inputChannels)
+            : RoutingMatrix::Map(inputChannels, outputChannels);
+    }
+    if (outputChannels == 0 || gains.size() != static_cast<size_t>(outputChannels) * inputChannels) {
+        NSLog(@"❌ AudioSplitter: Routing matrix must be %u x %u", outputChannels, inputChannels);
+        return nullptr;
+    }
+    
+    std::shared_ptr<ChannelNode> source = AcquireChannelNode(outputChannels, gains);
+    if (!source) {
+        return nullptr;
+    }
+    
+    auto key = std::make_pair(static_cast<const ChannelNode*>(source.get()), outputFormat.sampleRate);
+    if (!delivery.compensateDrift) {
+        auto found = rateNodes_.find(key);
+        if (found != rateNodes_.end()) {
+            if (auto existing = found->second.lock()) {
+                NSLog(@"✅ AudioSplitter: Sharing existing %.0fHz %uch conversion", key.second, outputChannels);
+                return existing;
+            }
+        }
+    }
+    
+    auto node = std::make_shared<RateNode>();
+    node->sampleRate = outputFormat.sampleRate;
+    node->producedFrames = 0;
+    node->fadeFrames = 0;
+    node->fadePosition = 0;
+    
+    bool configured = delivery.compensateDrift
+        ? node->resampler.ConfigureAdaptive(inputFormat_.sampleRate, outputFormat.sampleRate,
+                                            outputChannels, maxFramesPerBuffer_)
+        : node->resampler.Configure(inputFormat_.sampleRate, outputFormat.sampleRate,
+                                    outputChannels, maxFramesPerBuffer_);
+    if (!configured) {
+        NSLog(@"❌ AudioSplitter: Unsupported conversion %.0fHz -> %.0fHz",
+              inputFormat_.sampleRate, outputFormat.sampleRate);
+        return nullptr;
+    }
+    
+    if (delivery.compensateDrift) {
+        node->drift = std::make_unique<DriftEstimator>();
+        node->drift->Configure(outputFormat.sampleRate, HostTicksPerSecond(), delivery.targetFillFrames,
+                               PolyphaseResampler::kMaxRatioAdjustment);
+        node->fillLevel = delivery.fillLevel;
+    }
+    
+    node->source = source;
+    node->rateRatio = outputFormat.sampleRate / inputFormat_.sampleRate;
+    node->hostTicksPerInputFrame = HostTicksPerSecond() / inputFormat_.sampleRate;
+    std::memset(&node->outputTimeStamp, 0, sizeof(node->outputTimeStamp));
+    node->outputCapacity = node->resampler.MaxOutputFrames(maxFramesPerBuffer_);
+    node->outputStorage.assign(static_cast<size_t>(outputChannels) * node->outputCapacity, 0.0f);
+    node->outputPointers.resize(outputChannels);
+    
+    node->outputListStorage.assign(
+        offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * outputChannels, 0);
+    node->outputList = reinterpret_cast<AudioBufferList*>(node->outputListStorage.data());
+    node->outputList->mNumberBuffers = outputChannels;
+    
+    for (UInt32 c = 0; c < outputChannels; ++c) {
+        float* channelOutput = &node->outputStorage[static_cast<size_t>(c) * node->outputCapacity];
+        node->outputPointers[c] = channelOutput;
+        node->outputList->mBuffers[c].mNumberChannels = 1;
+        node->outputList->mBuffers[c].mData = channelOutput;
+        node->outputList->mBuffers[c].mDataByteSize = 0;
+    }
+    
+    // Drift-compensated nodes follow one consumer's clock and are not shared
+    if (!node->drift) {
+        EraseExpired(rateNodes_);
+        rateNodes_[key] = node;
+    }
+    return node;
+}
+
+bool AudioSplitter::IsSupportedFormat(AVAudioFormat* format) const {
+    // Anything else is converted from planar float by a formatter kernel
+    return (format.commonFormat == AVAudioPCMFormatFloat32 || format.commonFormat == AVAudioPCMFormatInt16) &&
+           format.channelCount > 0 && format.channelCount <= kMaxChannels;
+}
+
+SampleLayout AudioSplitter::LayoutOf(AVAudioFormat* format) {
+    SampleLayout layout;
+    layout.type = format.commonFormat == AVAudioPCMFormatInt16 ? SampleLayout::Type::Int16 : SampleLayout::Type::Float32;
+    layout.channels = format.channelCount;
+    layout.interleaved = format.isInterleaved && format.channelCount > 1;
+    return layout;
+}
+
+std::shared_ptr<AudioSplitter::Formatter> AudioSplitter::CreateFormatter(
+    const OutputDestination& destination,
+    const RateNode* conversion
+) const {
+    // Sized for the largest planar list this destination can be handed: a slice of
+    // rate node output or one reblocked block
+    auto formatter = std::make_shared<Formatter>();
+    formatter->layout = LayoutOf(destination.format);
+    formatter->kernel = SampleKernels::SelectWrite(formatter->layout);
+    if (!formatter->kernel || formatter->layout.channels != conversion->outputList->mNumberBuffers) {
+        return nullptr;
+    }
+    
+    formatter->maxFrames = std::max(conversion->outputCapacity, destination.delivery.blockFrames);
+    const UInt32 bufferCount = formatter->layout.BufferCount();
+    const size_t bytesPerBuffer = static_cast<size_t>(formatter->maxFrames) * formatter->layout.BytesPerFrame();
+    formatter->storage.assign(bufferCount * bytesPerBuffer, 0);
+    formatter->listStorage.assign(offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * bufferCount, 0);
+    formatter->list = reinterpret_cast<AudioBufferList*>(formatter->listStorage.data());
+    formatter->list->mNumberBuffers = bufferCount;
+    for (UInt32 b = 0; b < bufferCount; ++b) {
+        void* data = &formatter->storage[b * bytesPerBuffer];
+        formatter->bufferPointers.push_back(data);
+        formatter->list->mBuffers[b].mNumberChannels = formatter->layout.ChannelsPerBuffer();
+        formatter->list->mBuffers[b].mData = data;
+        formatter->list->mBuffers[b].mDataByteSize = 0;
     }
-    formatConverters_.clear();
+    
+    NSLog(@"✅ AudioSplitter: '%s' receives %s %s audio",
+          destination.name.c_str(),
+          formatter->layout.type == SampleLayout::Type::Int16 ? "int16" : "float32",
+          formatter->layout.interleaved ? "interleaved" : "planar");
+    return formatter;
+}
+
+void AudioSplitter::Deliver(
+    const DestinationTable::Entry& entry,
+    const AudioBufferList& bufferList,
+    const AudioTimeStamp& timeStamp
+) {
+    if (entry.effects) {
+        DeliverWithEffects(entry, bufferList, timeStamp);
+    } else {
+        HandOff(entry, bufferList, timeStamp);
+    }
+}
+
+void AudioSplitter::DeliverWithEffects(
+    const DestinationTable::Entry& entry,
+    const AudioBufferList& bufferList,
+    const AudioTimeStamp& timeStamp
+) {
+    // Planar audio only (enforced at configuration). Passthrough buffers may exceed
+    // the preallocated size, so process and hand off in slices with advanced timestamps
+    Effects& effects = *entry.effects;
+    const UInt32 channels = effects.chain.GetChannelCount();
+    const UInt32 totalFrames = bufferList.mNumberBuffers > 0 ? bufferList.mBuffers[0].mDataByteSize / sizeof(float) : 0;
+    
+    AudioTimeStamp sliceTimeStamp = timeStamp;
+    for (UInt32 offset = 0; offset < totalFrames; ) {
+        UInt32 frames = std::min(totalFrames - offset, effects.maxFrames);
+        for (UInt32 c = 0; c < channels; ++c) {
+            const AudioBuffer& buffer = bufferList.mBuffers[std::min(c, bufferList.mNumberBuffers - 1)];
+            effects.inputPointers[c] = static_cast<const float*>(buffer.mData) + offset;
+            effects.list->mBuffers[c].mDataByteSize = frames * sizeof(float);
+        }
+        effects.chain.Process(effects.inputPointers.data(), effects.outputPointers.data(), frames);
+        
+        sliceTimeStamp.mSampleTime = timeStamp.mSampleTime + offset;
+        if (timeStamp.mFlags & kAudioTimeStampHostTimeValid) {
+            sliceTimeStamp.mHostTime = timeStamp.mHostTime + static_cast<UInt64>(offset * effects.hostTicksPerFrame);
+        }
+        HandOff(entry, *effects.list, sliceTimeStamp);
+        offset += frames;
+    }
+}
+
+void AudioSplitter::HandOff(
+    const DestinationTable::Entry& entry,
+    const AudioBufferList& bufferList,
+    const AudioTimeStamp& timeStamp
+) {
+    if (entry.async) {
+        // Real-time side of async delivery: one copy into the ring and a wakeup
+        entry.async->ring.Push(bufferList, timeStamp);
+        dispatch_semaphore_signal(entry.async->wakeup);
+    } else if (entry.reblocker) {
+        DeliverReblocked(*entry.reblocker, *entry.destination, entry.formatter.get(), bufferList, timeStamp);
+    } else {
+        InvokeCallback(*entry.destination, entry.formatter.get(), bufferList, timeStamp);
+    }
+}
+
+void AudioSplitter::InvokeCallback(
+    const OutputDestination& destination,
+    Formatter* formatter,
+    const AudioBufferList& bufferList,
+    const AudioTimeStamp& timeStamp
+) {
+    if (!formatter || bufferList.mNumberBuffers == 0) {
+        destination.callback(bufferList, timeStamp);
+        return;
+    }
+    
+    // Planar float in; the destination's layout out through its preselected kernel
+    UInt32 frames = std::min<UInt32>(bufferList.mBuffers[0].mDataByteSize / sizeof(float), formatter->maxFrames);
+    const float* planar[kMaxChannels];
+    UInt32 channels = std::min(formatter->layout.channels, kMaxChannels);
+    for (UInt32 c = 0; c < channels; ++c) {
+        planar[c] = static_cast<const float*>(bufferList.mBuffers[std::min(c, bufferList.mNumberBuffers - 1)].mData);
+    }
+    formatter->kernel(planar, channels, frames, formatter->bufferPointers.data());
+    for (UInt32 b = 0; b < formatter->list->mNumberBuffers; ++b) {
+        formatter->list->mBuffers[b].mDataByteSize = frames * formatter->layout.BytesPerFrame();
+    }
+    destination.callback(*formatter->list, timeStamp);
+}
+
+void AudioSplitter::DeliverReblocked(
+    Reblocker& reblocker,
+    const OutputDestination& destination,
+    Formatter* formatter,
+    const AudioBufferList& bufferList,
+    const AudioTimeStamp& timeStamp
+) {
+    // Alternate filling and draining so any input size fits the preallocated ring
+    UInt32 totalFrames = bufferList.mNumberBuffers > 0
+        ? bufferList.mBuffers[0].mDataByteSize / (sizeof(float) * std::max<UInt32>(bufferList.mBuffers[0].mNumberChannels, 1))
+        : 0;
+    AudioTimeStamp blockTimeStamp;
+    for (UInt32 offset = 0; offset < totalFrames; ) {
+        UInt32 written = reblocker.Write(bufferList, timeStamp, offset);
+        while (reblocker.Read(blockTimeStamp)) {
+            InvokeCallback(destination, formatter, reblocker.GetBlock(), blockTimeStamp);
+        }
+        if (written == 0) {
+            break;
+        }
+        offset += written;
+    }
+}
+
+std::shared_ptr<AudioSplitter::Effects> AudioSplitter::CreateEffects(
+    const OutputDestination& destination,
+    const RateNode* conversion
+) const {
+    // Planar, at the rate the destination receives: the rate node's output or the input
+    UInt32 channels = conversion ? conversion->outputList->mNumberBuffers : inputFormat_.channelCount;
+    UInt32 maxFrames = conversion ? conversion->outputCapacity : maxFramesPerBuffer_;
+    double sampleRate = conversion ? conversion->sampleRate : inputFormat_.sampleRate;
+    
+    auto effects = std::make_shared<Effects>();
+    if (!effects->chain.Configure(channels, sampleRate)) {
+        return nullptr;
+    }
+    
+    effects->maxFrames = maxFrames;
+    effects->hostTicksPerFrame = HostTicksPerSecond() / sampleRate;
+    effects->storage.assign(static_cast<size_t>(channels) * maxFrames, 0.0f);
+    effects->inputPointers.assign(channels, nullptr);
+    effects->listStorage.assign(offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * channels, 0);
+    effects->list = reinterpret_cast<AudioBufferList*>(effects->listStorage.data());
+    effects->list->mNumberBuffers = channels;
+    for (UInt32 c = 0; c < channels; ++c) {
+        float* channelStorage = &effects->storage[static_cast<size_t>(c) * maxFrames];
+        effects->outputPointers.push_back(channelStorage);
+        effects->list->mBuffers[c].mNumberChannels = 1;
+        effects->list->mBuffers[c].mData = channelStorage;
+        effects->list->mBuffers[c].mDataByteSize = 0;
+    }
+    
+    NSLog(@"✅ AudioSplitter: '%s' runs a DSP chain at %.0fHz", destination.name.c_str(), sampleRate);
+    return effects;
+}
+
+std::shared_ptr<Reblocker> AudioSplitter::CreateReblocker(
+    const OutputDestination& destination,
+    const RateNode* conversion
+) const {
+    // Same layout the destination would otherwise receive: the rate node's planar
+    // output, or the original input for passthrough
+    UInt32 numberBuffers;
+    UInt32 channelsPerBuffer;
+    UInt32 maxInputFrames;
+    double sampleRate;
+    if (conversion) {
+        numberBuffers = conversion->outputList->mNumberBuffers;
+        channelsPerBuffer = 1;
+        maxInputFrames = conversion->outputCapacity;
+        sampleRate = conversion->sampleRate;
+    } else {
+        bool interleaved = inputFormat_.isInterleaved && inputFormat_.channelCount > 1;
+        numberBuffers = interleaved ? 1 : inputFormat_.channelCount;
+        channelsPerBuffer = interleaved ? inputFormat_.channelCount : 1;
+        maxInputFrames = maxFramesPerBuffer_;
+        sampleRate = inputFormat_.sampleRate;
+    }
+    
+    auto reblocker = std::make_shared<Reblocker>();
+    if (!reblocker->Configure(numberBuffers, channelsPerBuffer, destination.delivery.blockFrames,
+                              maxInputFrames, HostTicksPerSecond() / sampleRate)) {
+        return nullptr;
+    }
+    
+    NSLog(@"✅ AudioSplitter: '%s' delivers fixed %u-frame blocks (%.1f ms)",
+          destination.name.c_str(), destination.delivery.blockFrames,
+          1000.0 * destination.delivery.blockFrames / sampleRate);
+    return reblocker;
+}
+
+UInt32 AudioSplitter::FramesForDuration(double sampleRate, double milliseconds) {
+    return static_cast<UInt32>(std::llround(sampleRate * milliseconds / 1000.0));
+}
+
+std::shared_ptr<AudioSplitter::AsyncDelivery> AudioSplitter::StartAsyncDelivery(
+    const std::shared_ptr<OutputDestination>& destination,
+    const RateNode* conversion,
+    std::shared_ptr<Reblocker> reblocker,
+    std::shared_ptr<Formatter> formatter
+) const {
+    // Slot layout mirrors what this destination receives: the rate node's planar
+    // output, or the original input for passthrough
+    UInt32 maxBuffers;
+    UInt32 maxBytesPerBuffer;
+    if (conversion) {
+        maxBuffers = conversion->outputList->mNumberBuffers;
+        maxBytesPerBuffer = conversion->outputCapacity * sizeof(float);
+    } else {
+        maxBuffers = inputLayout_.BufferCount();
+        maxBytesPerBuffer = maxFramesPerBuffer_ * inputLayout_.BytesPerFrame();
+    }
+    
+    auto async = std::make_shared<AsyncDelivery>();
+    if (!async->wakeup ||
+        !async->ring.Configure(destination->delivery.ringCapacityBlocks, maxBuffers, maxBytesPerBuffer,
+                               conversion ? sizeof(float) : inputLayout_.BytesPerSample(),
+                               destination->delivery.overflowPolicy)) {
+        return nullptr;
+    }
+    
+    async->destination = destination;
+    async->reblocker = std::move(reblocker);
+    async->formatter = std::move(formatter);
+    async->consumerStorage.assign(static_cast<size_t>(maxBuffers) * maxBytesPerBuffer, 0);
+    async->consumerListStorage.assign(offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * maxBuffers, 0);
+    async->consumerList = reinterpret_cast<AudioBufferList*>(async->consumerListStorage.data());
+    async->consumerList->mNumberBuffers = maxBuffers;
+    for (UInt32 i = 0; i < maxBuffers; ++i) {
+        async->consumerList->mBuffers[i].mData = &async->consumerStorage[static_cast<size_t>(i) * maxBytesPerBuffer];
+    }
+    
+    async->running.store(true, std::memory_order_release);
+    AsyncDelivery* state = async.get();
+    async->worker = std::thread([state] { state->Run(); });
+    
+    NSLog(@"✅ AudioSplitter: Async delivery for '%s': %u blocks, %s on overflow",
+          destination->name.c_str(), destination->delivery.ringCapacityBlocks,
+          destination->delivery.overflowPolicy == AudioBlockRing::OverflowPolicy::DropNewest ? "drop newest" : "overwrite oldest");
+    return async;
+}
+
+AudioSplitter::AsyncDelivery::AsyncDelivery()
+    : wakeup(dispatch_semaphore_create(0))
+    , running(false)
+    , deliveredBlocks(0)
+    , consumerList(nullptr)
+{
+}
+
+AudioSplitter::AsyncDelivery::~AsyncDelivery() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) {
+        dispatch_semaphore_signal(wakeup);
+        worker.join();
+    }
+    if (wakeup) {
+        dispatch_release(wakeup);
+    }
+}
+
+void AudioSplitter::AsyncDelivery::Run() {
+    pthread_setname_np("com.prezefren.splitter.delivery");
+    
+    while (running.load(std::memory_order_acquire)) {
+        // Timed wait so shutdown never depends on another signal arriving
+        dispatch_semaphore_wait(wakeup, dispatch_time(DISPATCH_TIME_NOW, 100 * NSEC_PER_MSEC));
+        DeliverQueued();
+    }
+    
+    // Stopping happens once no table refers to this delivery, so the producer is
+    // gone and what is left in the ring is all there will ever be
+    if (destination->delivery.drainOnStop) {
+        DeliverQueued();
+    }
+}
+
+void AudioSplitter::AsyncDelivery::DeliverQueued() {
+    const UInt32 maxBuffers = ring.GetMaxBuffers();
+    AudioTimeStamp timeStamp;
+    
+    for (;;) {
+        consumerList->mNumberBuffers = maxBuffers;
+        if (!ring.Pop(*consumerList, timeStamp)) {
+            break;
+        }
+        if (reblocker) {
+            DeliverReblocked(*reblocker, *destination, formatter.get(), *consumerList, timeStamp);
+        } else {
+            InvokeCallback(*destination, formatter.get(), *consumerList, timeStamp);
+        }
+        deliveredBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioSplitter::CleanupConverters() {
+    registry_.clear();
+    destinationOrder_.clear();
+    channelNodes_.clear();
+    rateNodes_.clear();
 }
 
 } // namespace Prezefren
\ No newline at end of file
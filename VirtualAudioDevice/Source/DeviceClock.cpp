@@ -0,0 +1,120 @@
+#include "../Headers/DeviceClock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Prezefren {
+
+namespace {
+
+// A feed further than this from the loop's prediction is a discontinuity (capture
+// restart, reconfiguration), not jitter
+constexpr double kResyncSeconds = 0.05;
+constexpr double kMaxGapSeconds = 1.0;
+
+} // namespace
+
+DeviceClock::DeviceClock()
+    : sampleRate_(0.0)
+    , periodFrames_(0)
+    , nominalTicksPerFrame_(0.0)
+    , bandwidthHz_(kDefaultBandwidthHz)
+    , seed_(0)
+    , hasReference_(false)
+    , referenceSampleTime_(0.0)
+    , referenceHostTime_(0.0)
+    , ticksPerFrame_(0.0)
+{
+}
+
+void DeviceClock::Configure(double sampleRate, uint32_t periodFrames, double hostTicksPerSecond,
+                            double bandwidthHz) {
+    sampleRate_ = sampleRate;
+    periodFrames_ = std::max<uint32_t>(periodFrames, 1);
+    nominalTicksPerFrame_ = hostTicksPerSecond / sampleRate;
+    bandwidthHz_ = bandwidthHz;
+    ticksPerFrame_ = nominalTicksPerFrame_;
+    hasReference_ = false;
+    timeline_.Store({0.0, 0.0, nominalTicksPerFrame_, seed_});
+}
+
+void DeviceClock::Start(uint64_t hostTime) {
+    // Keep the measured rate: the feed is still the same clock
+    hasReference_ = false;
+    ++seed_;
+    timeline_.Store({0.0, static_cast<double>(hostTime), ticksPerFrame_, seed_});
+}
+
+void DeviceClock::Update(double sampleTime, uint64_t hostTime) {
+    if (nominalTicksPerFrame_ <= 0.0) {
+        return;
+    }
+
+    const double observed = static_cast<double>(hostTime);
+    if (!hasReference_) {
+        referenceSampleTime_ = sampleTime;
+        referenceHostTime_ = observed;
+        hasReference_ = true;
+        return;
+    }
+
+    const double frames = sampleTime - referenceSampleTime_;
+    if (frames <= 0.0 || frames > kMaxGapSeconds * sampleRate_) {
+        referenceSampleTime_ = sampleTime;
+        referenceHostTime_ = observed;
+        return;
+    }
+
+    const double predicted = referenceHostTime_ + ticksPerFrame_ * frames;
+    const double error = observed - predicted;
+    if (std::fabs(error) > kResyncSeconds * sampleRate_ * nominalTicksPerFrame_) {
+        referenceSampleTime_ = sampleTime;
+        referenceHostTime_ = observed;
+        return;
+    }
+
+    // Second-order loop, critically damped, coefficients scaled to this update's span
+    const double omega = 2.0 * M_PI * bandwidthHz_ * frames / sampleRate_;
+    referenceHostTime_ = predicted + std::sqrt(2.0) * omega * error;
+    referenceSampleTime_ = sampleTime;
+    ticksPerFrame_ += omega * omega * error / frames;
+
+    const double limit = nominalTicksPerFrame_ * kMaxDeviationPpm * 1e-6;
+    ticksPerFrame_ = std::clamp(ticksPerFrame_, nominalTicksPerFrame_ - limit, nominalTicksPerFrame_ + limit);
+
+    // Re-anchor where the old line is now so the position never jumps
+    Timeline timeline = timeline_.Load();
+    const double anchorHost = std::max(observed, timeline.anchorHostTime);
+    timeline.anchorSampleTime = PositionAt(timeline, anchorHost);
+    timeline.anchorHostTime = anchorHost;
+    timeline.hostTicksPerFrame = ticksPerFrame_;
+    timeline_.Store(timeline);
+}
+
+void DeviceClock::GetZeroTimeStamp(uint64_t now, double& sampleTime, uint64_t& hostTime, uint64_t& seed) const {
+    const Timeline timeline = timeline_.Load();
+    const double position = std::max(PositionAt(timeline, static_cast<double>(now)), 0.0);
+    const double period = static_cast<double>(std::max<uint32_t>(periodFrames_, 1));
+
+    sampleTime = std::floor(position / period) * period;
+    const double host = timeline.anchorHostTime + (sampleTime - timeline.anchorSampleTime) * timeline.hostTicksPerFrame;
+    hostTime = static_cast<uint64_t>(std::max(host, 0.0));
+    seed = timeline.seed;
+}
+
+double DeviceClock::GetSampleTime(uint64_t hostTime) const {
+    return PositionAt(timeline_.Load(), static_cast<double>(hostTime));
+}
+
+double DeviceClock::GetRateScalar() const {
+    const Timeline timeline = timeline_.Load();
+    return timeline.hostTicksPerFrame > 0.0 ? nominalTicksPerFrame_ / timeline.hostTicksPerFrame : 1.0;
+}
+
+double DeviceClock::PositionAt(const Timeline& timeline, double hostTime) {
+    if (timeline.hostTicksPerFrame <= 0.0) {
+        return timeline.anchorSampleTime;
+    }
+    return timeline.anchorSampleTime + (hostTime - timeline.anchorHostTime) / timeline.hostTicksPerFrame;
+}
+
+} // namespace Prezefren
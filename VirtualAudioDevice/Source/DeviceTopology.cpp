@@ -0,0 +1,113 @@
+#include "../Headers/DeviceTopology.h"
+#include "../Headers/RoutingMatrix.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Prezefren {
+
+std::vector<float> DeviceSpec::RoutingFor(uint32_t inputChannels) const {
+    if (inputChannels == 0 || channels == 0) {
+        return {};
+    }
+
+    if (source == Source::Downmix) {
+        std::vector<float> row = RoutingMatrix::Downmix(inputChannels);
+        std::vector<float> gains;
+        gains.reserve(static_cast<size_t>(channels) * inputChannels);
+        for (uint32_t c = 0; c < channels; ++c) {
+            gains.insert(gains.end(), row.begin(), row.end());
+        }
+        return gains;
+    }
+
+    if (channelMap.empty()) {
+        return channels == 1 && inputChannels > 1
+            ? RoutingMatrix::Downmix(inputChannels)
+            : RoutingMatrix::Map(inputChannels, channels);
+    }
+
+    std::vector<float> gains(static_cast<size_t>(channels) * inputChannels, 0.0f);
+    for (uint32_t c = 0; c < channels; ++c) {
+        int input = channelMap[c];
+        if (input >= 0 && static_cast<uint32_t>(input) < inputChannels) {
+            gains[static_cast<size_t>(c) * inputChannels + input] = 1.0f;
+        }
+    }
+    return gains;
+}
+
+bool DeviceSpec::SameDevice(const DeviceSpec& other) const {
+    return uid == other.uid && name == other.name && sampleRate == other.sampleRate && channels == other.channels;
+}
+
+bool DeviceSpec::SameRouting(const DeviceSpec& other) const {
+    return source == other.source && channelMap == other.channelMap && consumer == other.consumer;
+}
+
+bool ValidateTopology(const std::vector<DeviceSpec>& specs, std::string& error) {
+    std::unordered_set<std::string> uids;
+    for (const DeviceSpec& spec : specs) {
+        if (spec.uid.empty()) {
+            error = "device '" + spec.name + "' has no uid";
+            return false;
+        }
+        if (!uids.insert(spec.uid).second) {
+            error = "uid " + spec.uid + " is used twice";
+            return false;
+        }
+        if (spec.sampleRate <= 0.0) {
+            error = spec.uid + ": sample rate must be positive";
+            return false;
+        }
+        if (spec.channels == 0 || spec.channels > DeviceSpec::kMaxChannels) {
+            error = spec.uid + ": channel count out of range";
+            return false;
+        }
+        if (spec.source == DeviceSpec::Source::Channels && !spec.channelMap.empty()) {
+            if (spec.channelMap.size() != spec.channels) {
+                error = spec.uid + ": channel map needs one entry per channel";
+                return false;
+            }
+            for (int input : spec.channelMap) {
+                if (input < -1 || input >= static_cast<int>(DeviceSpec::kMaxChannels)) {
+                    error = spec.uid + ": channel map entry out of range";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+TopologyChanges DiffTopology(const std::vector<DeviceSpec>& from, const std::vector<DeviceSpec>& to) {
+    std::unordered_map<std::string, const DeviceSpec*> previous;
+    for (const DeviceSpec& spec : from) {
+        previous.emplace(spec.uid, &spec);
+    }
+    std::unordered_set<std::string> kept;
+    for (const DeviceSpec& spec : to) {
+        kept.insert(spec.uid);
+    }
+
+    TopologyChanges changes;
+    for (const DeviceSpec& spec : from) {
+        if (kept.count(spec.uid) == 0) {
+            changes.removed.push_back(spec.uid);
+        }
+    }
+    for (const DeviceSpec& spec : to) {
+        auto found = previous.find(spec.uid);
+        if (found == previous.end()) {
+            changes.added.push_back(spec);
+        } else if (!found->second->SameDevice(spec)) {
+            changes.removed.push_back(spec.uid);
+            changes.added.push_back(spec);
+        } else if (!found->second->SameRouting(spec)) {
+            changes.rerouted.push_back(spec);
+        }
+    }
+    return changes;
+}
+
+} // namespace Prezefren
@@ -0,0 +1,95 @@
+#include "../Headers/DriftEstimator.h"
+#include <algorithm>
+
+namespace Prezefren {
+
+DriftEstimator::DriftEstimator()
+    : outputRate_(0.0)
+    , hostTicksPerSecond_(0.0)
+    , targetFrames_(0.0)
+    , maxAdjustment_(0.0)
+    , anchored_(false)
+    , anchorHostTime_(0)
+    , lastHostTime_(0)
+    , producedFrames_(0.0)
+    , smoothedError_(0.0)
+    , drift_(0.0)
+    , adjustment_(1.0)
+    , driftPpm_(0.0)
+    , fillError_(0.0)
+{
+}
+
+void DriftEstimator::Configure(double outputRate, double hostTicksPerSecond, double targetFrames, double maxAdjustment) {
+    outputRate_ = outputRate;
+    hostTicksPerSecond_ = hostTicksPerSecond;
+    targetFrames_ = targetFrames;
+    maxAdjustment_ = maxAdjustment;
+    Reset();
+}
+
+void DriftEstimator::Reset() {
+    anchored_ = false;
+    anchorHostTime_ = 0;
+    lastHostTime_ = 0;
+    producedFrames_ = 0.0;
+    smoothedError_ = 0.0;
+    drift_ = 0.0;
+    adjustment_.store(1.0, std::memory_order_relaxed);
+    driftPpm_.store(0.0, std::memory_order_relaxed);
+    fillError_.store(0.0, std::memory_order_relaxed);
+}
+
+void DriftEstimator::UpdateTimeStamp(uint64_t hostTime, uint32_t producedFrames) {
+    if (outputRate_ <= 0.0 || hostTicksPerSecond_ <= 0.0) {
+        return;
+    }
+
+    // Re-anchor after a stall or a clock jump instead of chasing the gap; the
+    // drift learnt so far stays, only the fill reference restarts
+    double gap = (static_cast<double>(hostTime) - static_cast<double>(lastHostTime_)) / hostTicksPerSecond_;
+    if (!anchored_ || gap < 0.0 || gap > kMaxUpdateGapSeconds) {
+        anchored_ = true;
+        anchorHostTime_ = hostTime;
+        lastHostTime_ = hostTime;
+        producedFrames_ = producedFrames;
+        return;
+    }
+
+    // The consumer drains outputRate_ frames per host second; whatever was produced
+    // before this instant beyond that is backlog
+    double demanded = (hostTime - anchorHostTime_) / hostTicksPerSecond_ * outputRate_;
+    double backlog = producedFrames_ - demanded;
+    producedFrames_ += producedFrames;
+    lastHostTime_ = hostTime;
+
+    Step(backlog / outputRate_, gap);
+}
+
+void DriftEstimator::UpdateFillLevel(double queuedFrames, double elapsedSeconds) {
+    if (outputRate_ <= 0.0 || elapsedSeconds <= 0.0) {
+        return;
+    }
+    Step((queuedFrames - targetFrames_) / outputRate_, std::min(elapsedSeconds, kMaxUpdateGapSeconds));
+}
+
+void DriftEstimator::Step(double errorSeconds, double elapsedSeconds) {
+    // One-pole smoothing of the error, then PI: the fill behaves as an integrator of
+    // the rate mismatch, so tauI = 2 * tauP gives a critically damped loop
+    double alpha = std::min(1.0, elapsedSeconds / kSmoothingSeconds);
+    smoothedError_ += alpha * (errorSeconds - smoothedError_);
+
+    const double tauP = kProportionalSeconds;
+    const double tauI = 2.0 * kProportionalSeconds;
+    drift_ += smoothedError_ * elapsedSeconds / (tauI * tauI);
+    drift_ = std::min(std::max(drift_, -maxAdjustment_), maxAdjustment_);
+
+    double correction = drift_ + smoothedError_ / tauP;
+    correction = std::min(std::max(correction, -maxAdjustment_), maxAdjustment_);
+
+    adjustment_.store(1.0 + correction, std::memory_order_relaxed);
+    driftPpm_.store(drift_ * 1e6, std::memory_order_relaxed);
+    fillError_.store(smoothedError_, std::memory_order_relaxed);
+}
+
+} // namespace Prezefren
@@ -0,0 +1,304 @@
+#include "../Headers/DspChain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Prezefren {
+
+DspChain::Stage DspChain::Stage::MakeGain(float gain) {
+    Stage stage;
+    stage.type = StageType::Gain;
+    stage.gain = gain;
+    return stage;
+}
+
+DspChain::Stage DspChain::Stage::MakeHighPass(float frequency) {
+    Stage stage;
+    stage.type = StageType::HighPass;
+    stage.frequency = frequency;
+    return stage;
+}
+
+DspChain::Stage DspChain::Stage::MakeEmphasis(float amount) {
+    Stage stage;
+    stage.type = StageType::Emphasis;
+    stage.amount = amount;
+    return stage;
+}
+
+DspChain::Stage DspChain::Stage::MakeNoiseGate(float threshold, float attenuation) {
+    Stage stage;
+    stage.type = StageType::NoiseGate;
+    stage.threshold = threshold;
+    stage.attenuation = attenuation;
+    stage.attackMs = 1.0f;
+    stage.releaseMs = 50.0f;
+    return stage;
+}
+
+DspChain::Stage DspChain::Stage::MakeAgc(float level, float maxGain, float floor) {
+    Stage stage;
+    stage.type = StageType::Agc;
+    stage.level = level;
+    stage.maxGain = maxGain;
+    stage.threshold = floor;
+    stage.attackMs = 10.0f;
+    stage.releaseMs = 500.0f;
+    return stage;
+}
+
+DspChain::Stage DspChain::Stage::MakeLimiter(float ceiling) {
+    Stage stage;
+    stage.type = StageType::Limiter;
+    stage.ceiling = ceiling;
+    return stage;
+}
+
+std::vector<DspChain::Stage> DspChain::SingleEarbudPreset(bool bluetooth) {
+    std::vector<Stage> stages;
+    if (bluetooth) {
+        stages.push_back(Stage::MakeEmphasis(0.03f));           // compensateBluetoothCompression
+        stages.push_back(Stage::MakeNoiseGate(0.002f, 0.7f));   // applyBluetoothNoiseReduction
+    }
+    stages.push_back(Stage::MakeAgc(0.035f, 1.2f, 0.001f));     // Tiered quiet-signal boost
+    stages.push_back(Stage::MakeGain(bluetooth ? 1.05f : 1.03f));
+    stages.push_back(Stage::MakeNoiseGate(bluetooth ? 0.002f : 0.001f, 0.5f));
+    stages.push_back(Stage::MakeLimiter(1.0f));
+    return stages;
+}
+
+DspChain::DspChain()
+    : channels_(0)
+    , sampleRate_(0.0)
+{
+}
+
+bool DspChain::Configure(uint32_t channels, double sampleRate) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    if (channels == 0 || !(sampleRate > 0.0)) {
+        return false;
+    }
+
+    channels_ = channels;
+    sampleRate_ = sampleRate;
+    state_.assign(static_cast<size_t>(kMaxStages) * channels_, StageState());
+    for (auto& state : state_) {
+        ResetState(state, StageType::Gain);
+        state.valid = false;
+    }
+    program_.Publish(std::make_unique<Program>());
+    return true;
+}
+
+size_t DspChain::GetStageCount() const {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    const Program* program = program_.WriterGet();
+    return program ? program->stages.size() : 0;
+}
+
+float DspChain::OnePole(float milliseconds) const {
+    // Coefficient of a one-pole smoother reaching 1 - 1/e after the given time
+    if (milliseconds <= 0.0f) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::exp(-1000.0 / (milliseconds * sampleRate_)));
+}
+
+bool DspChain::Compile(const Stage& stage, CompiledStage& compiled) const {
+    std::memset(&compiled, 0, sizeof(compiled));
+    compiled.type = stage.type;
+    compiled.b0 = 1.0f;
+
+    switch (stage.type) {
+        case StageType::Gain:
+            compiled.gain = stage.gain;
+            return std::isfinite(stage.gain);
+
+        case StageType::HighPass: {
+            if (!(stage.frequency > 0.0f) || stage.frequency >= 0.5 * sampleRate_) {
+                return false;
+            }
+            // RBJ cookbook high-pass, Q = 1/sqrt(2)
+            double w0 = 2.0 * M_PI * stage.frequency / sampleRate_;
+            double alpha = std::sin(w0) / (2.0 * M_SQRT1_2);
+            double cosW0 = std::cos(w0);
+            double a0 = 1.0 + alpha;
+            compiled.b0 = static_cast<float>((1.0 + cosW0) / 2.0 / a0);
+            compiled.b1 = static_cast<float>(-(1.0 + cosW0) / a0);
+            compiled.b2 = compiled.b0;
+            compiled.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+            compiled.a2 = static_cast<float>((1.0 - alpha) / a0);
+            return true;
+        }
+
+        case StageType::Emphasis:
+            compiled.level = stage.amount;
+            return stage.amount >= 0.0f && stage.amount < 1.0f;
+
+        case StageType::NoiseGate:
+            compiled.threshold = stage.threshold;
+            compiled.gain = stage.attenuation;
+            compiled.attack = OnePole(stage.attackMs);
+            compiled.release = OnePole(stage.releaseMs);
+            compiled.smoothing = OnePole(5.0f);     // Gain ramp, avoids clicks at the edges
+            return stage.threshold >= 0.0f && stage.attenuation >= 0.0f && stage.attenuation <= 1.0f;
+
+        case StageType::Agc:
+            compiled.level = stage.level;
+            compiled.gain = stage.maxGain;
+            compiled.threshold = stage.threshold;
+            compiled.attack = OnePole(stage.attackMs);
+            compiled.release = OnePole(stage.releaseMs);
+            compiled.smoothing = compiled.release;
+            return stage.level > 0.0f && stage.maxGain >= 1.0f;
+
+        case StageType::Limiter:
+            compiled.gain = stage.ceiling;
+            return stage.ceiling > 0.0f;
+    }
+    return false;
+}
+
+bool DspChain::SetStages(const std::vector<Stage>& stages) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+
+    if (channels_ == 0 || stages.size() > kMaxStages) {
+        return false;
+    }
+
+    auto program = std::make_unique<Program>();
+    program->stages.resize(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (!Compile(stages[i], program->stages[i])) {
+            return false;
+        }
+    }
+
+    // The audio thread picks the new program up at its next Process() call
+    program_.Publish(std::move(program));
+    return true;
+}
+
+void DspChain::Reset() {
+    for (auto& state : state_) {
+        state.valid = false;
+    }
+}
+
+void DspChain::ResetState(StageState& state, StageType type) {
+    state.type = type;
+    state.valid = true;
+    state.x1 = state.x2 = state.y1 = state.y2 = 0.0f;
+    state.envelope = 0.0f;
+    state.gain = 1.0f;
+}
+
+void DspChain::Process(const float* const* input, float* const* output, uint32_t frames) {
+    RcuPointer<Program>::ReadGuard program(program_);
+    const size_t stageCount = program ? program->stages.size() : 0;
+
+    for (size_t s = 0; s < stageCount; ++s) {
+        for (uint32_t c = 0; c < channels_; ++c) {
+            StageState& state = state_[s * channels_ + c];
+            if (!state.valid || state.type != program->stages[s].type) {
+                ResetState(state, program->stages[s].type);
+            }
+        }
+    }
+
+    for (uint32_t c = 0; c < channels_; ++c) {
+        const float* source = input[c];
+        float* destination = output[c];
+        for (uint32_t offset = 0; offset < frames; offset += kTileFrames) {
+            uint32_t tile = std::min(kTileFrames, frames - offset);
+            float* samples = destination + offset;
+            if (source != destination) {
+                std::memcpy(samples, source + offset, tile * sizeof(float));
+            }
+            for (size_t s = 0; s < stageCount; ++s) {
+                RunStage(program->stages[s], state_[s * channels_ + c], samples, tile);
+            }
+        }
+    }
+}
+
+void DspChain::RunStage(const CompiledStage& stage, StageState& state, float* samples, uint32_t frames) {
+    switch (stage.type) {
+        case StageType::Gain:
+            for (uint32_t i = 0; i < frames; ++i) {
+                samples[i] *= stage.gain;
+            }
+            break;
+
+        case StageType::HighPass: {
+            float x1 = state.x1, x2 = state.x2, y1 = state.y1, y2 = state.y2;
+            for (uint32_t i = 0; i < frames; ++i) {
+                float x = samples[i];
+                float y = stage.b0 * x + stage.b1 * x1 + stage.b2 * x2 - stage.a1 * y1 - stage.a2 * y2;
+                x2 = x1; x1 = x;
+                y2 = y1; y1 = y;
+                samples[i] = y;
+            }
+            // Flush denormals so a silent input cannot stall the filter
+            state.x1 = x1; state.x2 = x2;
+            state.y1 = std::fabs(y1) < 1e-20f ? 0.0f : y1;
+            state.y2 = std::fabs(y2) < 1e-20f ? 0.0f : y2;
+            break;
+        }
+
+        case StageType::Emphasis: {
+            float previous = state.x1;
+            for (uint32_t i = 0; i < frames; ++i) {
+                float x = samples[i];
+                samples[i] = x + stage.level * (x - previous);
+                previous = x;
+            }
+            state.x1 = previous;
+            break;
+        }
+
+        case StageType::NoiseGate: {
+            float envelope = state.envelope;
+            float gain = state.gain;
+            for (uint32_t i = 0; i < frames; ++i) {
+                float magnitude = std::fabs(samples[i]);
+                float coefficient = magnitude > envelope ? stage.attack : stage.release;
+                envelope = magnitude + coefficient * (envelope - magnitude);
+                float target = envelope >= stage.threshold ? 1.0f : stage.gain;
+                gain = target + stage.smoothing * (gain - target);
+                samples[i] *= gain;
+            }
+            state.envelope = envelope;
+            state.gain = gain;
+            break;
+        }
+
+        case StageType::Agc: {
+            float envelope = state.envelope;
+            float gain = state.gain;
+            for (uint32_t i = 0; i < frames; ++i) {
+                float magnitude = std::fabs(samples[i]);
+                float coefficient = magnitude > envelope ? stage.attack : stage.release;
+                envelope = magnitude + coefficient * (envelope - magnitude);
+                // Hold the gain in silence instead of pumping up the noise floor
+                if (envelope > stage.threshold) {
+                    float target = std::min(stage.level / envelope, stage.gain);
+                    gain = target + stage.smoothing * (gain - target);
+                }
+                samples[i] *= gain;
+            }
+            state.envelope = envelope;
+            state.gain = gain;
+            break;
+        }
+
+        case StageType::Limiter:
+            for (uint32_t i = 0; i < frames; ++i) {
+                samples[i] = std::min(std::max(samples[i], -stage.gain), stage.gain);
+            }
+            break;
+    }
+}
+
+} // namespace Prezefren
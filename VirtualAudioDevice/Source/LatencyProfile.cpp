@@ -0,0 +1,45 @@
+#include "../Headers/LatencyProfile.h"
+
+namespace Prezefren {
+
+LatencyProfile LatencyProfile::LowLatency() {
+    LatencyProfile profile;
+    profile.name = "low-latency";
+    profile.ioBufferFrames = 256;
+    profile.converterBlockFrames = 256;
+    profile.deviceRingBuffers = 4;
+    profile.deviceLatencyBuffers = 1;
+    profile.clientBlockMilliseconds = 0.0;
+    profile.clientRingBlocks = 64;       // More, smaller blocks for the same headroom
+    return profile;
+}
+
+LatencyProfile LatencyProfile::Balanced() {
+    LatencyProfile profile;
+    profile.name = "balanced";
+    profile.ioBufferFrames = 512;
+    profile.converterBlockFrames = 1024;
+    profile.deviceRingBuffers = 8;
+    profile.deviceLatencyBuffers = 2;
+    profile.clientBlockMilliseconds = 20.0;
+    profile.clientRingBlocks = 32;
+    return profile;
+}
+
+double LatencyProfile::MaximumLatencySeconds(double captureRate, double deviceRate) const {
+    if (captureRate <= 0.0 || deviceRate <= 0.0) {
+        return 0.0;
+    }
+    return ioBufferFrames / captureRate + (deviceLatencyBuffers + 1.0) * ioBufferFrames / deviceRate;
+}
+
+bool LatencyProfile::operator==(const LatencyProfile& other) const {
+    return ioBufferFrames == other.ioBufferFrames &&
+           converterBlockFrames == other.converterBlockFrames &&
+           deviceRingBuffers == other.deviceRingBuffers &&
+           deviceLatencyBuffers == other.deviceLatencyBuffers &&
+           clientBlockMilliseconds == other.clientBlockMilliseconds &&
+           clientRingBlocks == other.clientRingBlocks;
+}
+
+} // namespace Prezefren
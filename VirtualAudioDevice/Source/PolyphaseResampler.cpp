@@ -0,0 +1,371 @@
+#include "../Headers/PolyphaseResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace Prezefren {
+
+namespace {
+
+// Dot product of n floats, n a multiple of 8. Inputs need not be aligned.
+inline float DotProduct(const float* a, const float* b, uint32_t n) {
+#if defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+#elif defined(__SSE__) || defined(_M_X64)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (uint32_t i = 0; i < n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (uint32_t i = 0; i < n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float32x4_t sum = vaddq_f32(acc0, acc1);
+#if defined(__aarch64__)
+    return vaddvq_f32(sum);
+#else
+    float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+#else
+    float acc[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < n; i += 8) {
+        for (uint32_t j = 0; j < 8; ++j) {
+            acc[j] += a[i + j] * b[i + j];
+        }
+    }
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+#endif
+}
+
+// Zeroth-order modified Bessel function of the first kind (Kaiser window)
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+void QualityParameters(PolyphaseResampler::Quality quality, uint32_t& taps, double& rolloff, double& kaiserBeta) {
+    switch (quality) {
+        case PolyphaseResampler::Quality::Low:    taps = 16; rolloff = 0.85; kaiserBeta = 6.0;  break;
+        case PolyphaseResampler::Quality::Medium: taps = 32; rolloff = 0.90; kaiserBeta = 8.0;  break;
+        case PolyphaseResampler::Quality::High:   taps = 64; rolloff = 0.94; kaiserBeta = 10.0; break;
+    }
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler()
+    : configured_(false)
+    , adaptive_(false)
+    , channels_(0)
+    , maxInputFrames_(0)
+    , upFactor_(1)
+    , downFactor_(1)
+    , tapsPerPhase_(0)
+    , historyStride_(0)
+    , inputIndex_(0)
+    , phase_(0)
+    , nominalStep_(1.0)
+    , ratioAdjustment_(1.0)
+    , position_(0.0)
+{
+}
+
+bool PolyphaseResampler::Configure(double inputRate, double outputRate, uint32_t channels,
+                                   uint32_t maxInputFrames, Quality quality) {
+    configured_ = false;
+    adaptive_ = false;
+
+    uint64_t inRate = static_cast<uint64_t>(std::llround(inputRate));
+    uint64_t outRate = static_cast<uint64_t>(std::llround(outputRate));
+    if (inRate == 0 || outRate == 0 || channels == 0 || maxInputFrames == 0 ||
+        std::fabs(inputRate - inRate) > 1e-6 || std::fabs(outputRate - outRate) > 1e-6) {
+        return false;
+    }
+
+    uint64_t divisor = std::gcd(inRate, outRate);
+    if (outRate / divisor > kMaxPhases) {
+        return false;
+    }
+
+    upFactor_ = static_cast<uint32_t>(outRate / divisor);
+    downFactor_ = static_cast<uint32_t>(inRate / divisor);
+
+    double rolloff = 0.90;
+    double kaiserBeta = 8.0;
+    QualityParameters(quality, tapsPerPhase_, rolloff, kaiserBeta);
+
+    if (upFactor_ == 1 && downFactor_ == 1) {
+        tapsPerPhase_ = 8;
+        bank_.clear();
+    } else {
+        // Cut off below the lower of the two Nyquist frequencies, in cycles per upsampled sample
+        DesignFilter(0.5 * rolloff / std::max(upFactor_, downFactor_), kaiserBeta, upFactor_);
+    }
+
+    AllocateHistory(channels, maxInputFrames);
+    configured_ = true;
+    return true;
+}
+
+bool PolyphaseResampler::ConfigureAdaptive(double inputRate, double outputRate, uint32_t channels,
+                                           uint32_t maxInputFrames, Quality quality) {
+    configured_ = false;
+    adaptive_ = false;
+
+    if (!(inputRate > 0.0) || !(outputRate > 0.0) || channels == 0 || maxInputFrames == 0) {
+        return false;
+    }
+
+    upFactor_ = kAdaptivePhases;
+    downFactor_ = 0;
+    nominalStep_ = inputRate / outputRate;
+    ratioAdjustment_ = 1.0;
+
+    double rolloff = 0.90;
+    double kaiserBeta = 8.0;
+    QualityParameters(quality, tapsPerPhase_, rolloff, kaiserBeta);
+
+    // One extra phase (the next input sample's phase 0) so phase p can always
+    // interpolate towards p + 1. Leave room for the largest adjustment when downsampling.
+    double decimation = std::max(1.0, nominalStep_ * (1.0 + kMaxRatioAdjustment));
+    DesignFilter(0.5 * rolloff / (kAdaptivePhases * decimation), kaiserBeta, kAdaptivePhases + 1);
+
+    AllocateHistory(channels, maxInputFrames);
+    adaptive_ = true;
+    configured_ = true;
+    return true;
+}
+
+void PolyphaseResampler::AllocateHistory(uint32_t channels, uint32_t maxInputFrames) {
+    channels_ = channels;
+    maxInputFrames_ = maxInputFrames;
+    historyStride_ = tapsPerPhase_ - 1 + maxInputFrames_;
+    history_.assign(static_cast<size_t>(historyStride_) * channels_, 0.0f);
+    inputIndex_ = 0;
+    phase_ = 0;
+    position_ = 0.0;
+}
+
+void PolyphaseResampler::DesignFilter(double cutoff, double kaiserBeta, uint32_t bankPhases) {
+    // Windowed-sinc prototype at the upsampled rate L * inputRate
+    uint32_t length = tapsPerPhase_ * upFactor_;
+    double center = (length - 1) / 2.0;
+    double windowNorm = BesselI0(kaiserBeta);
+
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (uint32_t n = 0; n < length; ++n) {
+        double x = n - center;
+        double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        double ratio = x / (center + 1.0);
+        double window = BesselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNorm;
+        prototype[n] = sinc * window;
+        sum += prototype[n];
+    }
+
+    // Unity passband gain after zero-stuffing by L
+    double gain = sum != 0.0 ? upFactor_ / sum : 0.0;
+
+    bank_.assign(static_cast<size_t>(bankPhases) * tapsPerPhase_, 0.0f);
+    for (uint32_t p = 0; p < bankPhases; ++p) {
+        float* phase = &bank_[static_cast<size_t>(p) * tapsPerPhase_];
+        for (uint32_t j = 0; j < tapsPerPhase_; ++j) {
+            size_t index = p + static_cast<size_t>(tapsPerPhase_ - 1 - j) * upFactor_;
+            phase[j] = index < length ? static_cast<float>(prototype[index] * gain) : 0.0f;
+        }
+    }
+}
+
+uint32_t PolyphaseResampler::Process(const float* const* input, uint32_t inputFrames,
+                                     float* const* output, uint32_t outputCapacity) {
+    if (!configured_ || inputFrames == 0) {
+        return 0;
+    }
+
+    if (IsPassthrough()) {
+        uint32_t frames = std::min(inputFrames, outputCapacity);
+        for (uint32_t c = 0; c < channels_; ++c) {
+            if (output[c] != input[c]) {
+                std::memcpy(output[c], input[c], frames * sizeof(float));
+            }
+        }
+        return frames;
+    }
+
+    uint32_t produced = 0;
+    for (uint32_t offset = 0; offset < inputFrames; ) {
+        uint32_t frames = std::min(inputFrames - offset, maxInputFrames_);
+        produced += adaptive_
+            ? ProcessAdaptivePass(input, offset, frames, output, produced, outputCapacity)
+            : ProcessPass(input, offset, frames, output, produced, outputCapacity);
+        offset += frames;
+    }
+    return std::min(produced, outputCapacity);
+}
+
+uint32_t PolyphaseResampler::ProcessPass(const float* const* input, uint32_t inputOffset, uint32_t inputFrames,
+                                         float* const* output, uint32_t outputOffset, uint32_t outputCapacity) {
+    const uint32_t taps = tapsPerPhase_;
+
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::memcpy(&history_[static_cast<size_t>(c) * historyStride_ + taps - 1],
+                    input[c] + inputOffset, inputFrames * sizeof(float));
+    }
+
+    int64_t index = inputIndex_;
+    uint32_t phase = phase_;
+    uint32_t produced = 0;
+
+    while (index < static_cast<int64_t>(inputFrames)) {
+        // Outputs past the caller's capacity are computed away so phase stays continuous
+        if (outputOffset + produced < outputCapacity) {
+            const float* coefficients = &bank_[static_cast<size_t>(phase) * taps];
+            for (uint32_t c = 0; c < channels_; ++c) {
+                const float* window = &history_[static_cast<size_t>(c) * historyStride_ + index];
+                output[c][outputOffset + produced] = DotProduct(coefficients, window, taps);
+            }
+        }
+        produced++;
+
+        phase += downFactor_;
+        index += phase / upFactor_;
+        phase %= upFactor_;
+    }
+
+    // Keep the last K-1 input samples as history for the next block
+    for (uint32_t c = 0; c < channels_; ++c) {
+        float* channelHistory = &history_[static_cast<size_t>(c) * historyStride_];
+        std::memmove(channelHistory, channelHistory + inputFrames, (taps - 1) * sizeof(float));
+    }
+
+    inputIndex_ = index - inputFrames;
+    phase_ = phase;
+    return produced;
+}
+
+uint32_t PolyphaseResampler::ProcessAdaptivePass(const float* const* input, uint32_t inputOffset, uint32_t inputFrames,
+                                                 float* const* output, uint32_t outputOffset, uint32_t outputCapacity) {
+    const uint32_t taps = tapsPerPhase_;
+
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::memcpy(&history_[static_cast<size_t>(c) * historyStride_ + taps - 1],
+                    input[c] + inputOffset, inputFrames * sizeof(float));
+    }
+
+    const double step = nominalStep_ * ratioAdjustment_;
+    double position = position_;
+    uint32_t produced = 0;
+
+    while (position < inputFrames) {
+        if (outputOffset + produced < outputCapacity) {
+            uint32_t index = static_cast<uint32_t>(position);
+            double phasePosition = (position - index) * kAdaptivePhases;
+            uint32_t phase = std::min(static_cast<uint32_t>(phasePosition), kAdaptivePhases - 1);
+            float blend = static_cast<float>(phasePosition - phase);
+
+            const float* lower = &bank_[static_cast<size_t>(phase) * taps];
+            const float* upper = lower + taps;
+            for (uint32_t c = 0; c < channels_; ++c) {
+                const float* window = &history_[static_cast<size_t>(c) * historyStride_ + index];
+                float a = DotProduct(lower, window, taps);
+                float b = DotProduct(upper, window, taps);
+                output[c][outputOffset + produced] = a + blend * (b - a);
+            }
+        }
+        produced++;
+        position += step;
+    }
+
+    for (uint32_t c = 0; c < channels_; ++c) {
+        float* channelHistory = &history_[static_cast<size_t>(c) * historyStride_];
+        std::memmove(channelHistory, channelHistory + inputFrames, (taps - 1) * sizeof(float));
+    }
+
+    position_ = position - inputFrames;
+    return produced;
+}
+
+void PolyphaseResampler::SetRatioAdjustment(double adjustment) {
+    ratioAdjustment_ = std::min(std::max(adjustment, 1.0 - kMaxRatioAdjustment), 1.0 + kMaxRatioAdjustment);
+}
+
+double PolyphaseResampler::GetInputStep() const {
+    if (adaptive_) {
+        return nominalStep_ * ratioAdjustment_;
+    }
+    return upFactor_ > 0 ? static_cast<double>(downFactor_) / upFactor_ : 0.0;
+}
+
+void PolyphaseResampler::Reset() {
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    inputIndex_ = 0;
+    phase_ = 0;
+    position_ = 0.0;
+}
+
+uint32_t PolyphaseResampler::MaxOutputFrames(uint32_t inputFrames) const {
+    if (!configured_) {
+        return 0;
+    }
+    if (adaptive_) {
+        double minimumStep = nominalStep_ * (1.0 - kMaxRatioAdjustment);
+        return static_cast<uint32_t>(std::ceil(inputFrames / minimumStep)) + 1;
+    }
+    return static_cast<uint32_t>((static_cast<uint64_t>(inputFrames) * upFactor_ + downFactor_ - 1) / downFactor_) + 1;
+}
+
+double PolyphaseResampler::GetDelayInputFrames() const {
+    if (!configured_ || IsPassthrough()) {
+        return 0.0;
+    }
+    return (static_cast<double>(tapsPerPhase_) * upFactor_ - 1.0) / (2.0 * upFactor_);
+}
+
+double PolyphaseResampler::GetNextOutputPosition() const {
+    if (!configured_ || IsPassthrough()) {
+        return 0.0;
+    }
+    // The next output sits at upsampled index inputIndex_ * L + phase_ of the coming
+    // block; the filter centre trails it by the group delay
+    if (adaptive_) {
+        return position_ - GetDelayInputFrames();
+    }
+    return static_cast<double>(inputIndex_) + static_cast<double>(phase_) / upFactor_ - GetDelayInputFrames();
+}
+
+} // namespace Prezefren
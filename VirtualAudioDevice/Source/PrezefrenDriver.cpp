@@ -1,8 +1,42 @@
 #include "../Headers/PrezefrenDriver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <memory>
+#include <mach/mach_time.h>
+#include <pthread.h>
 
 namespace Prezefren {
 
+namespace {
+
+double HostTicksPerSecond() {
+    mach_timebase_info_data_t timebaseInfo;
+    mach_timebase_info(&timebaseInfo);
+    return 1e9 * timebaseInfo.denom / timebaseInfo.numer;
+}
+
+// Device feeds are matrix destinations: planar float, one buffer per channel
+void WriteToRing(SharedAudioRing& ring, const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+    const float* planar[SharedAudioRing::kMaxChannels];
+    UInt32 channels = std::min<UInt32>(bufferList.mNumberBuffers, SharedAudioRing::kMaxChannels);
+    if (channels == 0) {
+        return;
+    }
+    
+    UInt32 frames = bufferList.mBuffers[0].mDataByteSize / sizeof(float);
+    for (UInt32 c = 0; c < channels; ++c) {
+        planar[c] = static_cast<const float*>(bufferList.mBuffers[c].mData);
+        frames = std::min<UInt32>(frames, bufferList.mBuffers[c].mDataByteSize / sizeof(float));
+    }
+    
+    double sampleTime = (timeStamp.mFlags & kAudioTimeStampSampleTimeValid) ? timeStamp.mSampleTime : NAN;
+    UInt64 hostTime = (timeStamp.mFlags & kAudioTimeStampHostTimeValid) ? timeStamp.mHostTime : 0;
+    ring.Write(planar, channels, frames, sampleTime, hostTime);
+}
+
+} // namespace
+
 Driver::Driver(const Configuration& config)
     : config_(config)
     , isInitialized_(false)
@@ -44,7 +78,7 @@ OSStatus Driver::Initialize() {
         isInitialized_ = true;
         
         NSLog(@"✅ PrezefrenDriver: Initialized successfully with %zu virtual devices", 
-              virtualDevices_.size());
+              devices_.size());
         
         return noErr;
         
@@ -88,20 +122,21 @@ bool Driver::EnableVirtualAudio() {
     
     try {
         // Start all virtual devices
-        for (auto& device : virtualDevices_) {
-            if (device) {
-                OSStatus result = device->StartIO();
-                if (result != noErr) {
-                    NSLog(@"⚠️ PrezefrenDriver: Failed to start device %s: %d", 
-                          device->GetDeviceName().c_str(), (int)result);
-                }
+        for (auto& entry : devices_) {
+            if (!entry.device) {
+                continue;
+            }
+            OSStatus result = entry.device->StartIO();
+            if (result != noErr) {
+                NSLog(@"⚠️ PrezefrenDriver: Failed to start device %s: %d", 
+                      entry.spec.name.c_str(), (int)result);
             }
         }
         
         virtualAudioEnabled_ = true;
         
         NSLog(@"✅ PrezefrenDriver: Virtual audio enabled with %zu active devices", 
-              virtualDevices_.size());
+              devices_.size());
         
         return true;
         
@@ -119,9 +154,9 @@ void Driver::DisableVirtualAudio() {
     }
     
     // Stop all virtual devices
-    for (auto& device : virtualDevices_) {
-        if (device) {
-            device->StopIO();
+    for (auto& entry : devices_) {
+        if (entry.device) {
+            entry.device->StopIO();
         }
     }
     
@@ -139,41 +174,136 @@ void Driver::SetAudioSplitter(std::shared_ptr<AudioSplitter> splitter) {
     }
 }
 
+bool Driver::SetInputFormat(AVAudioFormat* inputFormat, UInt32 maxFramesPerBuffer) {
+    std::lock_guard<std::mutex> lock(driverMutex_);
+    
+    if (!audioSplitter_) {
+        return false;
+    }
+    
+    UInt32 previousChannels = audioSplitter_->GetStatistics().inputChannels;
+    if (!audioSplitter_->Reconfigure(inputFormat, maxFramesPerBuffer)) {
+        NSLog(@"❌ PrezefrenDriver: Splitter kept its previous input format");
+        return false;
+    }
+    
+    // Channel maps select inputs by index: a wider input can now supply some
+    FollowInputChannels(previousChannels);
+    
+    // A new input rate changes the resampler delay each device reports
+    UpdateDeviceLatencies();
+    return true;
+}
+
 std::vector<std::shared_ptr<VirtualDevice>> Driver::GetVirtualDevices() const {
     std::lock_guard<std::mutex> lock(driverMutex_);
-    return virtualDevices_;
+    
+    std::vector<std::shared_ptr<VirtualDevice>> devices;
+    devices.reserve(devices_.size());
+    for (const auto& entry : devices_) {
+        if (entry.device) {
+            devices.push_back(entry.device);
+        }
+    }
+    return devices;
 }
 
-std::shared_ptr<VirtualDevice> Driver::GetDeviceByType(VirtualDevice::DeviceType type) const {
+std::shared_ptr<VirtualDevice> Driver::GetDevice(const std::string& uid) const {
     std::lock_guard<std::mutex> lock(driverMutex_);
     
-    for (const auto& device : virtualDevices_) {
-        if (device && device->GetDeviceType() == type) {
-            return device;
+    for (const auto& entry : devices_) {
+        if (entry.spec.uid == uid) {
+            return entry.device;
         }
     }
     
     return nullptr;
 }
 
-void Driver::SetTranscriptionCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+bool Driver::UpdateTopology(const std::vector<DeviceSpec>& devices) {
     std::lock_guard<std::mutex> lock(driverMutex_);
-    transcriptionCallback_ = std::move(callback);
     
-    // Connect to transcription device if it exists
-    if (transcriptionDevice_) {
-        transcriptionDevice_->SetAudioCallback(transcriptionCallback_);
+    Configuration newConfig = config_;
+    newConfig.devices = devices;
+    
+    std::string error;
+    if (!ValidateTopology(ResolveTopology(newConfig), error)) {
+        NSLog(@"❌ PrezefrenDriver: Topology rejected: %s", error.c_str());
+        return false;
+    }
+    
+    config_ = newConfig;
+    if (isInitialized_ && config_.enableVirtualAudio) {
+        ApplyTopology(ResolveTopology(config_));
     }
+    return true;
 }
 
-void Driver::SetPassthroughCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+std::vector<DeviceSpec> Driver::GetTopology() const {
     std::lock_guard<std::mutex> lock(driverMutex_);
-    passthroughCallback_ = std::move(callback);
     
-    // Connect to passthrough device if it exists
-    if (passthroughDevice_) {
-        passthroughDevice_->SetAudioCallback(passthroughCallback_);
+    std::vector<DeviceSpec> specs;
+    specs.reserve(devices_.size());
+    for (const auto& entry : devices_) {
+        specs.push_back(entry.spec);
     }
+    return specs;
+}
+
+std::vector<DeviceSpec> Driver::StandardTopology(const Configuration& config) {
+    std::vector<DeviceSpec> devices;
+    
+    // Mono downmix at a speech-recognition rate, also fed to the transcription callback
+    if (config.enableTranscriptionDevice) {
+        DeviceSpec spec;
+        spec.uid = "com.prezefren.virtualaudio.transcription";
+        spec.name = config.devicePrefix + " Transcription";
+        spec.sampleRate = config.transcriptionSampleRate;
+        spec.channels = 1;
+        spec.source = DeviceSpec::Source::Downmix;
+        spec.consumer = DeviceSpec::Consumer::Transcription;
+        devices.push_back(spec);
+    }
+    
+    // Stereo mirror of the input, also fed to the passthrough callback
+    if (config.enablePassthroughDevice) {
+        DeviceSpec spec;
+        spec.uid = "com.prezefren.virtualaudio.passthrough";
+        spec.name = config.devicePrefix + " Passthrough";
+        spec.sampleRate = config.passthroughSampleRate;
+        spec.channels = 2;
+        spec.consumer = DeviceSpec::Consumer::Passthrough;
+        devices.push_back(spec);
+    }
+    
+    if (config.enableStereoSeparation) {
+        DeviceSpec left;
+        left.uid = "com.prezefren.virtualaudio.left";
+        left.name = config.devicePrefix + " Left Channel";
+        left.sampleRate = config.passthroughSampleRate;
+        left.channelMap = {0};
+        devices.push_back(left);
+        
+        DeviceSpec right = left;
+        right.uid = "com.prezefren.virtualaudio.right";
+        right.name = config.devicePrefix + " Right Channel";
+        right.channelMap = {1};
+        devices.push_back(right);
+    }
+    
+    return devices;
+}
+
+void Driver::SetTranscriptionCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+    std::lock_guard<std::mutex> lock(driverMutex_);
+    transcriptionCallback_ = std::move(callback);
+    ReconnectConsumerFeeds(DeviceSpec::Consumer::Transcription);
+}
+
+void Driver::SetPassthroughCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
+    std::lock_guard<std::mutex> lock(driverMutex_);
+    passthroughCallback_ = std::move(callback);
+    ReconnectConsumerFeeds(DeviceSpec::Consumer::Passthrough);
 }
 
 Driver::DriverStatistics Driver::GetStatistics() const {
@@ -181,17 +311,32 @@ Driver::DriverStatistics Driver::GetStatistics() const {
     
     DriverStatistics stats;
     stats.virtualAudioActive = virtualAudioEnabled_;
-    stats.activeDevices = virtualDevices_.size();
+    stats.activeDevices = devices_.size();
+    stats.latencyProfile = config_.latencyProfile;
     
     if (audioSplitter_) {
         stats.splitterStats = audioSplitter_->GetStatistics();
     }
     
     // Collect device status
-    for (const auto& device : virtualDevices_) {
-        if (device) {
-            stats.deviceStatus.emplace_back(device->GetDeviceType(), device->IsActive());
+    AudioSplitter::DestinationStatistics destinationStats;
+    for (const auto& entry : devices_) {
+        const std::string& uid = entry.spec.uid;
+        if (entry.device) {
+            stats.deviceStatus.emplace_back(uid, entry.device->IsActive());
+            stats.deviceLatency.emplace_back(uid, entry.device->GetCaptureLatency());
+        }
+        
+        if (!audioSplitter_ || !audioSplitter_->GetDestinationStatistics(entry.feedId, destinationStats)) {
+            continue;
+        }
+        if (destinationStats.driftCompensated) {
+            stats.deviceDriftPpm.emplace_back(uid, destinationStats.driftPpm);
         }
+        stats.maximumLatency.emplace_back(uid,
+            config_.latencyProfile.MaximumLatencySeconds(stats.splitterStats.inputSampleRate,
+                                                          entry.spec.sampleRate) +
+            destinationStats.conversionLatency);
     }
     
     return stats;
@@ -212,13 +357,20 @@ void Driver::FeedAudioFromCurrentEngine(const AudioBufferList& bufferList, const
 void Driver::UpdateConfiguration(const Configuration& newConfig) {
     std::lock_guard<std::mutex> lock(driverMutex_);
     
+    std::string error;
+    if (!ValidateTopology(ResolveTopology(newConfig), error)) {
+        NSLog(@"❌ PrezefrenDriver: Configuration rejected: %s", error.c_str());
+        return;
+    }
+    
     Configuration oldConfig = config_;
     config_ = newConfig;
+    config_.transport = oldConfig.transport;
     
     // Handle configuration changes
     if (oldConfig.enableVirtualAudio != newConfig.enableVirtualAudio) {
         if (newConfig.enableVirtualAudio) {
-            if (isInitialized_ && virtualDevices_.empty()) {
+            if (isInitialized_ && devices_.empty()) {
                 CreateVirtualDevices();
                 SetupAudioSplitter();
                 ConnectDeviceCallbacks();
@@ -227,86 +379,70 @@ void Driver::UpdateConfiguration(const Configuration& newConfig) {
         } else {
             DisableVirtualAudio();
         }
+    } else if (oldConfig.latencyProfile != newConfig.latencyProfile) {
+        // Recreates every device, from the new topology
+        ApplyLatencyProfile();
+    } else if (isInitialized_ && newConfig.enableVirtualAudio) {
+        ApplyTopology(ResolveTopology(config_));
     }
     
     NSLog(@"✅ PrezefrenDriver: Configuration updated");
 }
 
+std::vector<DeviceSpec> Driver::ResolveTopology(const Configuration& config) const {
+    return config.devices.empty() ? StandardTopology(config) : config.devices;
+}
+
 void Driver::CreateVirtualDevices() {
-    virtualDevices_.clear();
+    devices_.clear();
     
-    try {
-        // Create transcription device if enabled
-        if (config_.enableTranscriptionDevice) {
-            transcriptionDevice_ = CreateTranscriptionDevice();
-            if (transcriptionDevice_) {
-                virtualDevices_.push_back(transcriptionDevice_);
-                AddDevice(transcriptionDevice_);
-            }
-        }
-        
-        // Create passthrough device if enabled
-        if (config_.enablePassthroughDevice) {
-            passthroughDevice_ = CreatePassthroughDevice();
-            if (passthroughDevice_) {
-                virtualDevices_.push_back(passthroughDevice_);
-                AddDevice(passthroughDevice_);
-            }
-        }
-        
-        // Create stereo separation devices if enabled
-        if (config_.enableStereoSeparation) {
-            leftChannelDevice_ = CreateChannelDevice(VirtualDevice::DeviceType::StereoLeft);
-            rightChannelDevice_ = CreateChannelDevice(VirtualDevice::DeviceType::StereoRight);
-            
-            if (leftChannelDevice_) {
-                virtualDevices_.push_back(leftChannelDevice_);
-                AddDevice(leftChannelDevice_);
-            }
-            
-            if (rightChannelDevice_) {
-                virtualDevices_.push_back(rightChannelDevice_);
-                AddDevice(rightChannelDevice_);
-            }
-        }
-        
-        NSLog(@"✅ PrezefrenDriver: Created %zu virtual devices", virtualDevices_.size());
-        
-    } catch (const std::exception& e) {
-        NSLog(@"❌ PrezefrenDriver: Failed to create virtual devices: %s", e.what());
+    std::vector<DeviceSpec> specs = ResolveTopology(config_);
+    std::string error;
+    if (!ValidateTopology(specs, error)) {
+        NSLog(@"❌ PrezefrenDriver: Invalid device topology: %s", error.c_str());
+        return;
+    }
+    
+    for (const DeviceSpec& spec : specs) {
+        AddDeviceEntry(spec);
     }
+    
+    NSLog(@"✅ PrezefrenDriver: Created %zu virtual devices", devices_.size());
 }
 
 void Driver::DestroyVirtualDevices() {
-    // Stop all devices first
-    for (auto& device : virtualDevices_) {
-        if (device) {
-            device->StopIO();
+    // Unhook and stop every device before unpublishing it
+    for (auto& entry : devices_) {
+        DisconnectDeviceEntry(entry);
+        entry.sharedFeed.reset();
+        if (entry.device) {
+            entry.device->StopIO();
+            RemoveDevice(entry.device);
         }
     }
-    
-    // Clear references
-    transcriptionDevice_.reset();
-    passthroughDevice_.reset();
-    leftChannelDevice_.reset();
-    rightChannelDevice_.reset();
-    virtualDevices_.clear();
+    devices_.clear();
     
     NSLog(@"✅ PrezefrenDriver: Virtual devices destroyed");
 }
 
 void Driver::SetupAudioSplitter() {
+    // The plugin half of a shared-memory transport has no capture to split
+    if (config_.transport == Configuration::Transport::SharedMemoryConsumer) {
+        return;
+    }
+    
     if (!audioSplitter_) {
         audioSplitter_ = std::make_shared<AudioSplitter>();
         
-        // Initialize with a default format (will be updated when audio starts)
+        // Initialize with a default format; SetInputFormat() renegotiates it once the
+        // real capture format is known
         AVAudioFormat* defaultFormat = [[AVAudioFormat alloc] 
             initWithCommonFormat:AVAudioPCMFormatFloat32
                       sampleRate:config_.passthroughSampleRate
                         channels:2
                      interleaved:NO];
         
-        if (audioSplitter_->Initialize(defaultFormat)) {
+        if (audioSplitter_->Initialize(defaultFormat, config_.latencyProfile.converterBlockFrames)) {
             NSLog(@"✅ PrezefrenDriver: Audio splitter initialized");
         } else {
             NSLog(@"❌ PrezefrenDriver: Failed to initialize audio splitter");
@@ -322,117 +458,434 @@ void Driver::ConnectDeviceCallbacks() {
         return;
     }
     
-    // Connect transcription device
-    if (transcriptionDevice_) {
-        int destinationId = audioSplitter_->CreateTranscriptionDestination(
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                if (transcriptionCallback_) {
-                    transcriptionCallback_(bufferList, timeStamp);
-                }
-                transcriptionDevice_->FeedAudioData(bufferList, timeStamp);
+    for (auto& entry : devices_) {
+        ConnectDeviceEntry(entry);
+    }
+    
+    UpdateDeviceLatencies();
+}
+
+bool Driver::ApplyTopology(const std::vector<DeviceSpec>& specs) {
+    std::vector<DeviceSpec> current;
+    current.reserve(devices_.size());
+    for (const auto& entry : devices_) {
+        current.push_back(entry.spec);
+    }
+    
+    TopologyChanges changes = DiffTopology(current, specs);
+    if (changes.removed.empty() && changes.added.empty() && changes.rerouted.empty()) {
+        return true;
+    }
+    
+    for (const std::string& uid : changes.removed) {
+        for (size_t i = 0; i < devices_.size(); ++i) {
+            if (devices_[i].spec.uid == uid) {
+                RemoveDeviceEntry(i);
+                break;
             }
-        );
-        
-        if (destinationId >= 0) {
-            NSLog(@"✅ PrezefrenDriver: Connected transcription device to splitter");
         }
     }
     
-    // Connect passthrough device
-    if (passthroughDevice_) {
-        int destinationId = audioSplitter_->CreatePassthroughDestination(
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                if (passthroughCallback_) {
-                    passthroughCallback_(bufferList, timeStamp);
-                }
-                passthroughDevice_->FeedAudioData(bufferList, timeStamp);
-            }
-        );
-        
-        if (destinationId >= 0) {
-            NSLog(@"✅ PrezefrenDriver: Connected passthrough device to splitter");
+    // Same device, new routing: only the feeds change, clients keep streaming
+    for (const DeviceSpec& spec : changes.rerouted) {
+        if (DeviceEntry* entry = FindDeviceEntry(spec.uid)) {
+            DisconnectDeviceEntry(*entry);
+            entry->spec = spec;
+            ConnectDeviceEntry(*entry);
         }
     }
     
-    // Connect channel devices
-    if (leftChannelDevice_) {
-        int destinationId = audioSplitter_->CreateChannelDestination(0, // Left channel
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                leftChannelDevice_->FeedAudioData(bufferList, timeStamp);
-            }
-        );
-        
-        if (destinationId >= 0) {
-            NSLog(@"✅ PrezefrenDriver: Connected left channel device to splitter");
+    bool allAdded = true;
+    for (const DeviceSpec& spec : changes.added) {
+        if (!AddDeviceEntry(spec)) {
+            allAdded = false;
+            continue;
+        }
+        DeviceEntry& entry = devices_.back();
+        ConnectDeviceEntry(entry);
+        if (virtualAudioEnabled_ && entry.device) {
+            entry.device->StartIO();
         }
     }
     
-    if (rightChannelDevice_) {
-        int destinationId = audioSplitter_->CreateChannelDestination(1, // Right channel
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                rightChannelDevice_->FeedAudioData(bufferList, timeStamp);
-            }
-        );
-        
-        if (destinationId >= 0) {
-            NSLog(@"✅ PrezefrenDriver: Connected right channel device to splitter");
+    // Keep the topology's order, which is the order devices are listed in
+    std::vector<DeviceEntry> ordered;
+    ordered.reserve(devices_.size());
+    for (const DeviceSpec& spec : specs) {
+        if (DeviceEntry* entry = FindDeviceEntry(spec.uid)) {
+            ordered.push_back(std::move(*entry));
+        }
+    }
+    devices_ = std::move(ordered);
+    
+    UpdateDeviceLatencies();
+    
+    NSLog(@"✅ PrezefrenDriver: Topology updated (%zu removed, %zu added, %zu rerouted, %zu devices)",
+          changes.removed.size(), changes.added.size(), changes.rerouted.size(), devices_.size());
+    return allAdded;
+}
+
+void Driver::FollowInputChannels(UInt32 previousChannels) {
+    UInt32 inputChannels = audioSplitter_->GetStatistics().inputChannels;
+    if (inputChannels == previousChannels) {
+        return;
+    }
+    
+    // The splitter adapts every matrix by itself; a feed only needs rebuilding
+    // where its spec asks for something the adapted matrix does not give
+    size_t rerouted = 0;
+    for (auto& entry : devices_) {
+        std::vector<float> adapted = RoutingMatrix::Adapt(entry.spec.RoutingFor(previousChannels),
+                                                          entry.spec.channels, previousChannels, inputChannels);
+        if (entry.feedId >= 0 && adapted == entry.spec.RoutingFor(inputChannels)) {
+            continue;
         }
+        DisconnectDeviceEntry(entry);
+        ConnectDeviceEntry(entry);
+        ++rerouted;
+    }
+    
+    if (rerouted > 0) {
+        NSLog(@"✅ PrezefrenDriver: Rerouted %zu devices for %u input channels", rerouted, (unsigned)inputChannels);
     }
 }
 
-std::shared_ptr<VirtualDevice> Driver::CreateTranscriptionDevice() {
+bool Driver::AddDeviceEntry(const DeviceSpec& spec) {
     try {
-        auto device = std::make_shared<VirtualDevice>(
+        DeviceEntry entry;
+        entry.spec = spec;
+        
+        // The app half of a shared-memory transport only fills the device's ring
+        if (config_.transport == Configuration::Transport::SharedMemoryProducer) {
+            entry.ring = SharedAudioRing::Create(SharedAudioRing::NameFor(spec.uid), spec.channels,
+                                                 config_.latencyProfile.DeviceRingFrames(), spec.sampleRate,
+                                                 HostTicksPerSecond());
+            if (!entry.ring) {
+                NSLog(@"❌ PrezefrenDriver: Failed to create shared ring for %s", spec.name.c_str());
+                return false;
+            }
+            devices_.push_back(std::move(entry));
+            
+            NSLog(@"✅ PrezefrenDriver: Created shared ring %s for %s", 
+                  devices_.back().ring->GetName().c_str(), spec.name.c_str());
+            return true;
+        }
+        
+        entry.device = std::make_shared<VirtualDevice>(
             GetContext(),
-            VirtualDevice::DeviceType::TranscriptionInput,
-            config_.transcriptionSampleRate,
-            1 // Mono for transcription
+            spec.name,
+            spec.uid,
+            spec.sampleRate,
+            spec.channels,
+            config_.latencyProfile
         );
         
-        NSLog(@"✅ PrezefrenDriver: Created transcription device");
-        return device;
+        // The client callback gets its own asynchronous feed (see ConnectConsumerFeed),
+        // never the device's: that would call it a second time, inline on the audio thread
+        AddDevice(entry.device);
+        if (config_.transport == Configuration::Transport::SharedMemoryConsumer) {
+            entry.sharedFeed = std::make_shared<SharedFeed>(spec, entry.device);
+        }
+        devices_.push_back(std::move(entry));
+        
+        NSLog(@"✅ PrezefrenDriver: Created device %s (%u ch @ %.0f Hz)",
+              spec.name.c_str(), (unsigned)spec.channels, spec.sampleRate);
+        return true;
         
     } catch (const std::exception& e) {
-        NSLog(@"❌ PrezefrenDriver: Failed to create transcription device: %s", e.what());
-        return nullptr;
+        NSLog(@"❌ PrezefrenDriver: Failed to create device %s: %s", spec.name.c_str(), e.what());
+        return false;
     }
 }
 
-std::shared_ptr<VirtualDevice> Driver::CreatePassthroughDevice() {
-    try {
-        auto device = std::make_shared<VirtualDevice>(
-            GetContext(),
-            VirtualDevice::DeviceType::PassthroughMirror,
-            config_.passthroughSampleRate,
-            2 // Stereo for passthrough
-        );
-        
-        NSLog(@"✅ PrezefrenDriver: Created passthrough device");
-        return device;
+void Driver::RemoveDeviceEntry(size_t index) {
+    DeviceEntry& entry = devices_[index];
+    DisconnectDeviceEntry(entry);
+    entry.sharedFeed.reset();
+    if (entry.device) {
+        entry.device->StopIO();
+        RemoveDevice(entry.device);
+    }
+    
+    NSLog(@"✅ PrezefrenDriver: Removed device %s", entry.spec.name.c_str());
+    devices_.erase(devices_.begin() + index);
+}
+
+void Driver::ConnectDeviceEntry(DeviceEntry& entry) {
+    if (!audioSplitter_) {
+        return;
+    }
+    
+    const DeviceSpec& spec = entry.spec;
+    std::vector<float> routing = spec.RoutingFor(audioSplitter_->GetStatistics().inputChannels);
+    
+    // Devices run on their own clock: each feed gets an adaptive conversion that
+    // tracks it, so long sessions neither overrun nor underrun. The device's ring
+    // backlog is the fill level the conversion holds at the clients' target latency;
+    // across processes it is the shared ring plus the backlog the plugin reports.
+    std::shared_ptr<VirtualDevice> device = entry.device;
+    std::shared_ptr<SharedAudioRing> ring = entry.ring;
+    AudioSplitter::DeliveryOptions deviceDelivery;
+    deviceDelivery.compensateDrift = config_.enableDriftCompensation;
+    if (deviceDelivery.compensateDrift && ring) {
+        double target = config_.latencyProfile.DeviceLatencyFrames();
+        deviceDelivery.fillLevel = [ring, target] {
+            double fill = ring->GetFillLevel();
+            return fill >= 0.0 ? fill : target;
+        };
+        deviceDelivery.targetFillFrames = config_.latencyProfile.DeviceLatencyFrames();
+    } else if (deviceDelivery.compensateDrift) {
+        deviceDelivery.fillLevel = [device] { return device->GetBufferedFrames(); };
+        deviceDelivery.targetFillFrames = device->GetTargetLatencyFrames();
+    }
+    
+    std::function<void(const AudioBufferList&, const AudioTimeStamp&)> feed;
+    if (ring) {
+        feed = [ring](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+            WriteToRing(*ring, bufferList, timeStamp);
+        };
+    } else {
+        feed = [device](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+            device->FeedAudioData(bufferList, timeStamp);
+        };
+    }
+    
+    // Every device is pinned to its spec's format while the input may be renegotiated
+    entry.feedId = audioSplitter_->CreateMatrixDestination(
+        spec.name,
+        spec.channels,
+        routing,
+        spec.sampleRate,
+        std::move(feed),
+        deviceDelivery
+    );
+    
+    if (entry.feedId < 0) {
+        NSLog(@"❌ PrezefrenDriver: Failed to connect device %s to splitter", spec.name.c_str());
+        return;
+    }
+    
+    ConnectConsumerFeed(entry);
+    
+    NSLog(@"✅ PrezefrenDriver: Connected device %s to splitter", spec.name.c_str());
+}
+
+void Driver::ConnectConsumerFeed(DeviceEntry& entry) {
+    const DeviceSpec& spec = entry.spec;
+    auto callback = ConsumerCallback(spec.consumer);
+    if (!audioSplitter_ || !callback) {
+        return;
+    }
+    
+    // Client callbacks (e.g. the Swift bridge building AVAudioPCMBuffers) are slow and
+    // run on their own delivery threads; device feeds stay inline on the audio thread.
+    // The delivery thread owns its copy of the callback: setting a new one rebuilds
+    // the destination instead of reassigning what that thread is calling.
+    const LatencyProfile& profile = config_.latencyProfile;
+    AudioSplitter::DeliveryOptions clientDelivery;
+    clientDelivery.asynchronous = true;
+    clientDelivery.overflowPolicy = AudioBlockRing::OverflowPolicy::OverwriteOldest;
+    clientDelivery.ringCapacityBlocks = profile.clientRingBlocks;
+    if (profile.clientBlockMilliseconds > 0.0) {
+        clientDelivery.blockFrames = AudioSplitter::FramesForDuration(spec.sampleRate, profile.clientBlockMilliseconds);
+    }
+    
+    const bool transcription = spec.consumer == DeviceSpec::Consumer::Transcription;
+    entry.consumerFeedId = audioSplitter_->CreateMatrixDestination(
+        spec.name + (transcription ? " (transcription)" : " (passthrough)"),
+        spec.channels,
+        spec.RoutingFor(audioSplitter_->GetStatistics().inputChannels),
+        spec.sampleRate,
+        std::move(callback),
+        clientDelivery
+    );
+}
+
+void Driver::ReconnectConsumerFeeds(DeviceSpec::Consumer consumer) {
+    for (auto& entry : devices_) {
+        if (entry.spec.consumer != consumer || (entry.feedId < 0 && entry.consumerFeedId < 0)) {
+            continue;
+        }
+        if (audioSplitter_ && entry.consumerFeedId >= 0) {
+            audioSplitter_->RemoveOutputDestination(entry.consumerFeedId);
+        }
+        entry.consumerFeedId = -1;
+        ConnectConsumerFeed(entry);
+    }
+}
+
+void Driver::DisconnectDeviceEntry(DeviceEntry& entry) {
+    if (audioSplitter_) {
+        if (entry.feedId >= 0) {
+            audioSplitter_->RemoveOutputDestination(entry.feedId);
+        }
+        if (entry.consumerFeedId >= 0) {
+            audioSplitter_->RemoveOutputDestination(entry.consumerFeedId);
+        }
+    }
+    entry.feedId = -1;
+    entry.consumerFeedId = -1;
+}
+
+Driver::DeviceEntry* Driver::FindDeviceEntry(const std::string& uid) {
+    for (auto& entry : devices_) {
+        if (entry.spec.uid == uid) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::function<void(const AudioBufferList&, const AudioTimeStamp&)> Driver::ConsumerCallback(DeviceSpec::Consumer consumer) const {
+    switch (consumer) {
+        case DeviceSpec::Consumer::Transcription:
+            return transcriptionCallback_;
+        case DeviceSpec::Consumer::Passthrough:
+            return passthroughCallback_;
+        case DeviceSpec::Consumer::None:
+            break;
+    }
+    return nullptr;
+}
+
+void Driver::ApplyLatencyProfile() {
+    // Caller holds driverMutex_. Device rings are sized at construction, so the
+    // devices are recreated; the splitter only resizes its conversion slices.
+    if (!isInitialized_ || devices_.empty()) {
+        return;
+    }
+    
+    bool running = virtualAudioEnabled_;
+    DestroyVirtualDevices();
+    if (audioSplitter_) {
+        audioSplitter_->Reconfigure(nullptr, config_.latencyProfile.converterBlockFrames);
+    }
+    CreateVirtualDevices();
+    ConnectDeviceCallbacks();
+    
+    if (running) {
+        for (auto& entry : devices_) {
+            if (entry.device) {
+                entry.device->StartIO();
+            }
+        }
+    }
+    
+    NSLog(@"✅ PrezefrenDriver: Switched to the %s latency profile (%u-frame buffers)",
+          config_.latencyProfile.name, config_.latencyProfile.ioBufferFrames);
+}
+
+void Driver::UpdateDeviceLatencies() {
+    if (!audioSplitter_) {
+        return;
+    }
+    
+    AudioSplitter::DestinationStatistics destinationStats;
+    for (auto& entry : devices_) {
+        if (!audioSplitter_->GetDestinationStatistics(entry.feedId, destinationStats)) {
+            continue;
+        }
+        // Across processes the plugin picks it up from the ring
+        if (entry.ring) {
+            entry.ring->SetConversionLatency(destinationStats.conversionLatency);
+        } else if (entry.device) {
+            entry.device->SetConversionLatency(destinationStats.conversionLatency);
+        }
+    }
+}
+
+Driver::SharedFeed::SharedFeed(const DeviceSpec& deviceSpec, std::shared_ptr<VirtualDevice> virtualDevice)
+    : ringName(SharedAudioRing::NameFor(deviceSpec.uid))
+    , spec(deviceSpec)
+    , device(std::move(virtualDevice))
+    , running(true)
+{
+    worker = std::thread([this] { Run(); });
+}
+
+Driver::SharedFeed::~SharedFeed() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void Driver::SharedFeed::Run() {
+    pthread_setname_np("com.prezefren.driver.sharedfeed");
+    
+    while (running.load(std::memory_order_acquire)) {
+        // The app may not be running yet, or may have restarted and replaced the ring
+        if (!ring || ring->IsClosed()) {
+            ring.reset();
+            if (!Attach()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+        }
         
-    } catch (const std::exception& e) {
-        NSLog(@"❌ PrezefrenDriver: Failed to create passthrough device: %s", e.what());
-        return nullptr;
+        // Timed wait so shutdown never depends on the app writing again
+        if (ring->Wait(100)) {
+            Drain();
+        }
     }
 }
 
-std::shared_ptr<VirtualDevice> Driver::CreateChannelDevice(VirtualDevice::DeviceType type) {
-    try {
-        auto device = std::make_shared<VirtualDevice>(
-            GetContext(),
-            type,
-            config_.passthroughSampleRate,
-            1 // Mono for single channel
-        );
+bool Driver::SharedFeed::Attach() {
+    std::unique_ptr<SharedAudioRing> candidate = SharedAudioRing::Open(ringName, SharedAudioRing::ExpectedProducer());
+    if (!candidate) {
+        return false;
+    }
+    
+    // Written by an app with a different topology: leave it until that app recreates it
+    if (candidate->GetChannels() != spec.channels || candidate->GetSampleRate() != spec.sampleRate) {
+        return false;
+    }
+    
+    ring = std::move(candidate);
+    NSLog(@"✅ PrezefrenDriver: %s attached to shared ring %s", spec.name.c_str(), ringName.c_str());
+    return true;
+}
+
+void Driver::SharedFeed::Drain() {
+    SharedAudioRing::Region region;
+    UInt32 frames = ring->Peek(region);
+    if (frames == 0) {
+        return;
+    }
+    
+    device->SetConversionLatency(ring->GetConversionLatency());
+    
+    // Hand the segment's frames to the device in place, one run at a time
+    static const double hostTicksPerSecond = HostTicksPerSecond();
+    const double hostTicksPerFrame = hostTicksPerSecond / spec.sampleRate;
+    UInt32 offset = 0;
+    for (int run = 0; run < 2; ++run) {
+        if (region.frames[run] == 0) {
+            continue;
+        }
         
-        NSLog(@"✅ PrezefrenDriver: Created channel device (%s)", 
-              type == VirtualDevice::DeviceType::StereoLeft ? "Left" : "Right");
-        return device;
+        AudioBufferList bufferList;
+        bufferList.mNumberBuffers = 1;
+        bufferList.mBuffers[0].mNumberChannels = spec.channels;
+        bufferList.mBuffers[0].mDataByteSize = region.frames[run] * spec.channels * sizeof(float);
+        bufferList.mBuffers[0].mData = const_cast<float*>(region.data[run]);
         
-    } catch (const std::exception& e) {
-        NSLog(@"❌ PrezefrenDriver: Failed to create channel device: %s", e.what());
-        return nullptr;
+        AudioTimeStamp timeStamp = {};
+        if (!std::isnan(region.sampleTime)) {
+            timeStamp.mSampleTime = region.sampleTime + offset;
+            timeStamp.mFlags |= kAudioTimeStampSampleTimeValid;
+        }
+        if (region.hostTime != 0) {
+            timeStamp.mHostTime = region.hostTime + static_cast<UInt64>(offset * hostTicksPerFrame);
+            timeStamp.mFlags |= kAudioTimeStampHostTimeValid;
+        }
+        
+        device->FeedAudioData(bufferList, timeStamp);
+        offset += region.frames[run];
     }
+    
+    ring->Consume(frames);
+    ring->SetConsumerBacklog(device->GetBufferedFrames());
 }
 
 // C interface for plugin factory
@@ -444,6 +897,7 @@ extern "C" void* PrezefrenDriverFactory(CFAllocatorRef allocator, CFUUIDRef type
         config.enableTranscriptionDevice = true;
         config.enablePassthroughDevice = true;
         config.enableStereoSeparation = false; // Disabled by default
+        config.transport = Driver::Configuration::Transport::SharedMemoryConsumer;  // Inside coreaudiod: the app feeds us
         
         auto driver = std::make_shared<Driver>(config);
         
@@ -1,24 +1,94 @@
 #include "../Headers/PrezefrenVirtualDevice.h"
 #include <CoreFoundation/CoreFoundation.h>
+#include <algorithm>
 #include <mach/mach_time.h>
 
 namespace Prezefren {
 
+namespace {
+
+Float64 HostTicksPerSecond() {
+    mach_timebase_info_data_t timebaseInfo;
+    mach_timebase_info(&timebaseInfo);
+    return 1.0e9 * timebaseInfo.denom / timebaseInfo.numer;
+}
+
+} // namespace
+
+/**
+ * @brief HAL side of the device's stream: one ring reader per client
+ *
+ * Clients are registered on the HAL's control thread; reads run on its IO thread
+ * and only copy out of the ring.
+ */
+class VirtualDevice::StreamIO : public aspl::ControlRequestHandler, public aspl::IORequestHandler {
+public:
+    StreamIO(VirtualDevice& device, std::shared_ptr<StreamRingBuffer> ring, std::string deviceName)
+        : device_(device), ring_(std::move(ring)), deviceName_(std::move(deviceName)) {}
+    
+    OSStatus OnAddClient(const std::shared_ptr<aspl::Client>& client) override {
+        if (!ring_->AddReader(client->GetClientID())) {
+            NSLog(@"❌ VirtualDevice: %s already serves %u clients", deviceName_.c_str(), StreamRingBuffer::kMaxReaders);
+            return kAudioHardwareIllegalOperationError;
+        }
+        return noErr;
+    }
+    
+    void OnRemoveClient(const std::shared_ptr<aspl::Client>& client) override {
+        ring_->RemoveReader(client->GetClientID());
+    }
+    
+    void OnReadClientInput(const std::shared_ptr<aspl::Client>& client,
+                           const std::shared_ptr<aspl::Stream>& stream,
+                           Float64 zeroTimestamp,
+                           Float64 timestamp,
+                           void* bytes,
+                           UInt32 bytesCount) override {
+        // The stream format is packed interleaved float32, the ring's own layout
+        UInt32 frames = bytesCount / (sizeof(Float32) * ring_->GetChannels());
+        UInt64 position;
+        if (ring_->Read(client->GetClientID(), static_cast<float*>(bytes), frames, &position)) {
+            device_.RecordReadLatency(position);
+        }
+    }
+    
+private:
+    VirtualDevice& device_;         // Owns this handler
+    std::shared_ptr<StreamRingBuffer> ring_;
+    std::string deviceName_;
+};
+
 VirtualDevice::VirtualDevice(
     std::shared_ptr<aspl::Context> context,
-    DeviceType type,
+    const std::string& name,
+    const std::string& uid,
     Float64 sampleRate,
-    UInt32 channelCount
+    UInt32 channelCount,
+    const LatencyProfile& latencyProfile
 ) : aspl::Device(context), 
-    deviceType_(type), 
+    name_(name), 
+    uid_(uid), 
     sampleRate_(sampleRate), 
-    channelCount_(channelCount) {
+    channelCount_(channelCount),
+    latencyProfile_(latencyProfile),
+    hostTicksPerFrame_(HostTicksPerSecond() / sampleRate),
+    streamRing_(std::make_shared<StreamRingBuffer>()) {
     
     // Initialize streams based on device type
     InitializeStreams();
     
-    NSLog(@"✅ VirtualDevice created: %s (%.0fHz, %uch)", 
-          GetDeviceName().c_str(), sampleRate_, channelCount_);
+    // Allocated up front: neither the feed nor client reads ever allocate
+    if (!streamRing_->Configure(channelCount_, latencyProfile_.DeviceRingFrames(), latencyProfile_.DeviceLatencyFrames())) {
+        NSLog(@"❌ VirtualDevice: Invalid ring for %s (%s profile)", GetDeviceName().c_str(), latencyProfile_.name);
+    }
+    // One zero timestamp per trip around the ring
+    clock_.Configure(sampleRate_, latencyProfile_.DeviceRingFrames(), HostTicksPerSecond());
+    streamIO_ = std::make_shared<StreamIO>(*this, streamRing_, GetDeviceName());
+    SetControlHandler(streamIO_);
+    SetIOHandler(streamIO_);
+    
+    NSLog(@"✅ VirtualDevice created: %s (%.0fHz, %uch, %s: %u-frame buffers)", 
+          GetDeviceName().c_str(), sampleRate_, channelCount_, latencyProfile_.name, latencyProfile_.ioBufferFrames);
 }
 
 OSStatus VirtualDevice::GetManufacturer(CFStringRef* outName) const {
@@ -61,8 +131,7 @@ OSStatus VirtualDevice::GetFirmwareVersion(CFStringRef* outName) const {
 OSStatus VirtualDevice::GetZeroTimeStampPeriod(UInt32* outPeriod) const {
     if (!outPeriod) return kAudioHardwareIllegalOperationError;
     
-    // Zero latency for virtual device
-    *outPeriod = 0;
+    *outPeriod = clock_.GetPeriod();
     return noErr;
 }
 
@@ -76,8 +145,34 @@ OSStatus VirtualDevice::GetIsRunning(Boolean* outIsRunning) const {
 OSStatus VirtualDevice::GetLatency(UInt32 inDirection, UInt32* outLatency) const {
     if (!outLatency) return kAudioHardwareIllegalOperationError;
     
-    // Minimal latency for virtual device
-    *outLatency = deviceType_ == DeviceType::TranscriptionInput ? 0 : 32; // Frames
+    // What the feed's conversion delays the audio by; the ring's backlog is the
+    // safety offset
+    *outLatency = conversionLatencyFrames_.load(std::memory_order_relaxed);
+    return noErr;
+}
+
+OSStatus VirtualDevice::GetSafetyOffset(UInt32 inDirection, UInt32* outOffset) const {
+    if (!outOffset) return kAudioHardwareIllegalOperationError;
+    
+    // Clients read this far behind the newest fed frame
+    *outOffset = streamRing_->GetTargetLatency();
+    return noErr;
+}
+
+OSStatus VirtualDevice::GetBufferFrameSize(UInt32* outFrames) const {
+    if (!outFrames) return kAudioHardwareIllegalOperationError;
+    
+    *outFrames = latencyProfile_.ioBufferFrames;
+    return noErr;
+}
+
+OSStatus VirtualDevice::GetBufferFrameSizeRange(AudioValueRange* outRange) const {
+    if (!outRange) return kAudioHardwareIllegalOperationError;
+    
+    // Anything from a small fraction of the IO buffer up to the largest read the
+    // ring serves without overrunning the backlog
+    outRange->mMinimum = std::min<UInt32>(latencyProfile_.ioBufferFrames, 64);
+    outRange->mMaximum = streamRing_->GetCapacity() - streamRing_->GetTargetLatency();
     return noErr;
 }
 
@@ -110,13 +205,17 @@ OSStatus VirtualDevice::StartIO() {
         return noErr; // Already running
     }
     
-    // Initialize timing
-    mach_timebase_info_data_t timebaseInfo;
-    mach_timebase_info(&timebaseInfo);
+    // Clients start over from fresh audio rather than whatever preceded the stop
+    streamRing_->Reset();
     
-    lastProcessedTime_.mFlags = kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid;
-    lastProcessedTime_.mSampleTime = 0;
-    lastProcessedTime_.mHostTime = mach_absolute_time();
+    // New timeline and seed, started before the feed can run (isRunning_ is still
+    // false): the clock and the feed mark have one writer
+    clock_.Start(mach_absolute_time());
+    feedMark_.Store({framesFed_, 0});
+    latencyTicksTotal_.store(0);
+    latencyTicksMinimum_.store(UINT64_MAX);
+    latencyTicksMaximum_.store(0);
+    latencyMeasurements_.store(0);
     
     isRunning_.store(true);
     frameCounter_.store(0);
@@ -134,37 +233,101 @@ OSStatus VirtualDevice::StopIO() {
     
     isRunning_.store(false);
     
-    NSLog(@"✅ VirtualDevice stopped: %s (processed %llu frames)", 
-          GetDeviceName().c_str(), frameCounter_.load());
+    NSLog(@"✅ VirtualDevice stopped: %s (processed %llu frames, %llu IO errors)", 
+          GetDeviceName().c_str(), frameCounter_.load(), ioErrors_.load());
     return noErr;
 }
 
 OSStatus VirtualDevice::GetCurrentTime(AudioTimeStamp* outTime) const {
     if (!outTime) return kAudioHardwareIllegalOperationError;
     
-    std::lock_guard<std::mutex> lock(deviceMutex_);
-    *outTime = lastProcessedTime_;
+    UInt64 now = mach_absolute_time();
+    *outTime = {};
+    outTime->mFlags = kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid | kAudioTimeStampRateScalarValid;
+    outTime->mSampleTime = clock_.GetSampleTime(now);
+    outTime->mHostTime = now;
+    outTime->mRateScalar = clock_.GetRateScalar();
+    return noErr;
+}
+
+OSStatus VirtualDevice::GetZeroTimeStamp(Float64* outSampleTime, UInt64* outHostTime, UInt64* outSeed) const {
+    if (!outSampleTime || !outHostTime || !outSeed) return kAudioHardwareIllegalOperationError;
+    
+    Float64 sampleTime;
+    UInt64 hostTime;
+    UInt64 seed;
+    clock_.GetZeroTimeStamp(mach_absolute_time(), sampleTime, hostTime, seed);
+    *outSampleTime = sampleTime;
+    *outHostTime = hostTime;
+    *outSeed = seed;
     return noErr;
 }
 
 void VirtualDevice::SetAudioCallback(std::function<void(const AudioBufferList&, const AudioTimeStamp&)> callback) {
     std::lock_guard<std::mutex> lock(deviceMutex_);
-    audioCallback_ = std::move(callback);
+    audioCallback_.Publish(std::make_unique<AudioCallback>(std::move(callback)));
 }
 
 void VirtualDevice::FeedAudioData(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-    if (!isRunning_.load()) {
+    if (!isRunning_.load(std::memory_order_acquire)) {
         return;
     }
     
-    // Process the audio buffer
+    // Process the audio buffer. The IO thread must not log: count instead, StopIO()
+    // and GetIOErrorCount() report it.
     OSStatus result = ProcessAudioBuffer(bufferList, timeStamp);
     if (result != noErr) {
-        NSLog(@"⚠️ VirtualDevice: Audio processing error %d for %s", 
-              (int)result, GetDeviceName().c_str());
+        ioErrors_.fetch_add(1, std::memory_order_relaxed);
+        lastIOError_.store(result, std::memory_order_relaxed);
+    }
+}
+
+void VirtualDevice::SetConversionLatency(Float64 seconds) {
+    conversionLatencyFrames_.store(static_cast<UInt32>(std::max(seconds, 0.0) * sampleRate_ + 0.5),
+                                   std::memory_order_relaxed);
+}
+
+VirtualDevice::LatencyStatistics VirtualDevice::GetCaptureLatency() const {
+    LatencyStatistics stats = {};
+    stats.measurements = latencyMeasurements_.load(std::memory_order_relaxed);
+    if (stats.measurements > 0) {
+        Float64 secondsPerTick = 1.0 / HostTicksPerSecond();
+        stats.averageSeconds = latencyTicksTotal_.load(std::memory_order_relaxed) * secondsPerTick / stats.measurements;
+        stats.minimumSeconds = latencyTicksMinimum_.load(std::memory_order_relaxed) * secondsPerTick;
+        stats.maximumSeconds = latencyTicksMaximum_.load(std::memory_order_relaxed) * secondsPerTick;
+    }
+    return stats;
+}
+
+void VirtualDevice::RecordReadLatency(UInt64 position) {
+    // HAL IO thread: atomics only
+    FeedMark mark = feedMark_.Load();
+    if (mark.captureEndHostTime == 0 || position > mark.position) {
+        return;
+    }
+    
+    Float64 captured = mark.captureEndHostTime - (mark.position - position) * hostTicksPerFrame_;
+    Float64 now = static_cast<Float64>(mach_absolute_time());
+    if (now <= captured) {
+        return;
+    }
+    UInt64 ticks = static_cast<UInt64>(now - captured);
+    
+    latencyTicksTotal_.fetch_add(ticks, std::memory_order_relaxed);
+    latencyMeasurements_.fetch_add(1, std::memory_order_relaxed);
+    UInt64 minimum = latencyTicksMinimum_.load(std::memory_order_relaxed);
+    while (ticks < minimum && !latencyTicksMinimum_.compare_exchange_weak(minimum, ticks, std::memory_order_relaxed)) {
+    }
+    UInt64 maximum = latencyTicksMaximum_.load(std::memory_order_relaxed);
+    while (ticks > maximum && !latencyTicksMaximum_.compare_exchange_weak(maximum, ticks, std::memory_order_relaxed)) {
     }
 }
 
+double VirtualDevice::GetBufferedFrames() const {
+    double fill = streamRing_->GetFillLevel();
+    return fill >= 0.0 ? fill : streamRing_->GetTargetLatency();
+}
+
 void VirtualDevice::InitializeStreams() {
     // Create input stream for this device type
     try {
@@ -194,62 +357,44 @@ void VirtualDevice::InitializeStreams() {
 }
 
 OSStatus VirtualDevice::ProcessAudioBuffer(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-    if (!isRunning_.load() || !audioCallback_) {
-        return noErr;
+    // IO thread: only atomics, the clock, the ring and an RCU read from here on
+    if (bufferList.mNumberBuffers == 0 || !bufferList.mBuffers[0].mData) {
+        return kAudioHardwareIllegalOperationError;
     }
     
-    // Update timing information
-    {
-        std::lock_guard<std::mutex> lock(deviceMutex_);
-        lastProcessedTime_ = timeStamp;
-        
-        // Update frame counter
-        if (bufferList.mNumberBuffers > 0) {
-            UInt32 frameCount = bufferList.mBuffers[0].mDataByteSize / (sizeof(Float32) * channelCount_);
-            frameCounter_.fetch_add(frameCount);
-        }
+    UInt32 written = streamRing_->Write(bufferList);
+    framesFed_ += written;
+    
+    // Update timing information. Frames are counted on the first buffer, which
+    // holds one channel for planar audio and all of them when interleaved.
+    UInt32 channelsPerBuffer = std::max<UInt32>(bufferList.mBuffers[0].mNumberChannels, 1);
+    UInt32 frames = bufferList.mBuffers[0].mDataByteSize / (sizeof(Float32) * channelsPerBuffer);
+    UInt64 fedFrames = frameCounter_.fetch_add(frames, std::memory_order_relaxed);
+    
+    // The timestamp's host time is when its first frame was captured
+    FeedMark mark = {framesFed_, 0};
+    if ((timeStamp.mFlags & kAudioTimeStampHostTimeValid) && timeStamp.mHostTime != 0) {
+        mark.captureEndHostTime = timeStamp.mHostTime + static_cast<UInt64>(written * hostTicksPerFrame_);
+    }
+    feedMark_.Store(mark);
+    
+    // The clock follows the capture timestamps; without them, the arrival of the
+    // frames is the best estimate and the loop filters its jitter
+    const UInt32 timed = kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid;
+    if ((timeStamp.mFlags & timed) == timed) {
+        clock_.Update(timeStamp.mSampleTime, timeStamp.mHostTime);
+    } else {
+        clock_.Update(static_cast<double>(fedFrames), mach_absolute_time());
     }
     
     // Call the audio callback
-    try {
-        audioCallback_(bufferList, timeStamp);
-    } catch (const std::exception& e) {
-        NSLog(@"❌ VirtualDevice: Audio callback exception for %s: %s", 
-              GetDeviceName().c_str(), e.what());
-        return kAudioHardwareUnspecifiedError;
+    RcuPointer<AudioCallback>::ReadGuard guard(audioCallback_);
+    const AudioCallback* callback = guard.get();
+    if (callback && *callback) {
+        (*callback)(bufferList, timeStamp);
     }
     
     return noErr;
 }
 
-std::string VirtualDevice::GetDeviceName() const {
-    switch (deviceType_) {
-        case DeviceType::TranscriptionInput:
-            return "Prezefren Transcription";
-        case DeviceType::PassthroughMirror:
-            return "Prezefren Passthrough";
-        case DeviceType::StereoLeft:
-            return "Prezefren Left Channel";
-        case DeviceType::StereoRight:
-            return "Prezefren Right Channel";
-        default:
-            return "Prezefren Virtual Device";
-    }
-}
-
-std::string VirtualDevice::GetDeviceUID() const {
-    switch (deviceType_) {
-        case DeviceType::TranscriptionInput:
-            return "com.prezefren.virtualaudio.transcription";
-        case DeviceType::PassthroughMirror:
-            return "com.prezefren.virtualaudio.passthrough";
-        case DeviceType::StereoLeft:
-            return "com.prezefren.virtualaudio.left";
-        case DeviceType::StereoRight:
-            return "com.prezefren.virtualaudio.right";
-        default:
-            return "com.prezefren.virtualaudio.device";
-    }
-}
-
 } // namespace Prezefren
\ No newline at end of file
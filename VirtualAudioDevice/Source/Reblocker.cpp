@@ -0,0 +1,145 @@
+#include "../Headers/Reblocker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace Prezefren {
+
+Reblocker::Reblocker()
+    : numberBuffers_(0)
+    , channelsPerBuffer_(1)
+    , blockFrames_(0)
+    , capacityFrames_(0)
+    , hostTicksPerFrame_(0.0)
+    , blockList_(nullptr)
+    , readFrame_(0)
+    , queuedFrames_(0)
+    , lastTimeStamp_()
+    , headSampleTime_(0.0)
+    , anchorSampleTime_(0.0)
+    , anchorHostTime_(0)
+    , hasHostAnchor_(false)
+{
+}
+
+bool Reblocker::Configure(uint32_t numberBuffers, uint32_t channelsPerBuffer, uint32_t blockFrames,
+                          uint32_t maxInputFrames, double hostTicksPerFrame) {
+    if (numberBuffers == 0 || channelsPerBuffer == 0 || blockFrames == 0) {
+        return false;
+    }
+
+    numberBuffers_ = numberBuffers;
+    channelsPerBuffer_ = channelsPerBuffer;
+    blockFrames_ = blockFrames;
+    capacityFrames_ = blockFrames + std::max<uint32_t>(maxInputFrames, 1);
+    hostTicksPerFrame_ = hostTicksPerFrame;
+
+    ring_.assign(static_cast<size_t>(numberBuffers_) * capacityFrames_ * channelsPerBuffer_, 0.0f);
+    blockStorage_.assign(static_cast<size_t>(numberBuffers_) * blockFrames_ * channelsPerBuffer_, 0.0f);
+    blockListStorage_.assign(offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * numberBuffers_, 0);
+    blockList_ = reinterpret_cast<AudioBufferList*>(blockListStorage_.data());
+    blockList_->mNumberBuffers = numberBuffers_;
+    for (uint32_t b = 0; b < numberBuffers_; ++b) {
+        blockList_->mBuffers[b].mNumberChannels = channelsPerBuffer_;
+        blockList_->mBuffers[b].mDataByteSize = blockFrames_ * channelsPerBuffer_ * sizeof(float);
+        blockList_->mBuffers[b].mData = &blockStorage_[static_cast<size_t>(b) * blockFrames_ * channelsPerBuffer_];
+    }
+
+    Reset();
+    return true;
+}
+
+uint32_t Reblocker::Write(const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp, uint32_t frameOffset) {
+    if (capacityFrames_ == 0 || bufferList.mNumberBuffers == 0) {
+        return 0;
+    }
+
+    uint32_t bytesPerFrame = channelsPerBuffer_ * sizeof(float);
+    uint32_t totalFrames = bufferList.mBuffers[0].mDataByteSize / bytesPerFrame;
+    if (frameOffset >= totalFrames) {
+        return 0;
+    }
+    uint32_t frames = std::min(totalFrames - frameOffset, capacityFrames_ - queuedFrames_);
+    if (frames == 0) {
+        return 0;
+    }
+
+    // Re-derive the head of the queue from every input that carries a sample time,
+    // so a discontinuity upstream cannot leave the blocks stamped on a stale timeline
+    lastTimeStamp_ = timeStamp;
+    if (timeStamp.mFlags & kAudioTimeStampSampleTimeValid) {
+        headSampleTime_ = timeStamp.mSampleTime + frameOffset - queuedFrames_;
+    }
+    if (timeStamp.mFlags & kAudioTimeStampHostTimeValid) {
+        anchorHostTime_ = timeStamp.mHostTime;
+        anchorSampleTime_ = (timeStamp.mFlags & kAudioTimeStampSampleTimeValid)
+            ? timeStamp.mSampleTime
+            : headSampleTime_ + queuedFrames_ - frameOffset;
+        hasHostAnchor_ = true;
+    }
+
+    uint32_t writeFrame = (readFrame_ + queuedFrames_) % capacityFrames_;
+    uint32_t firstPart = std::min(frames, capacityFrames_ - writeFrame);
+    uint32_t buffers = std::min(bufferList.mNumberBuffers, numberBuffers_);
+
+    for (uint32_t b = 0; b < numberBuffers_; ++b) {
+        float* ring = &ring_[static_cast<size_t>(b) * capacityFrames_ * channelsPerBuffer_];
+        const float* source = b < buffers && bufferList.mBuffers[b].mData
+            ? static_cast<const float*>(bufferList.mBuffers[b].mData) + static_cast<size_t>(frameOffset) * channelsPerBuffer_
+            : nullptr;
+        if (source) {
+            std::memcpy(ring + static_cast<size_t>(writeFrame) * channelsPerBuffer_, source, firstPart * bytesPerFrame);
+            std::memcpy(ring, source + static_cast<size_t>(firstPart) * channelsPerBuffer_, (frames - firstPart) * bytesPerFrame);
+        } else {
+            std::memset(ring + static_cast<size_t>(writeFrame) * channelsPerBuffer_, 0, firstPart * bytesPerFrame);
+            std::memset(ring, 0, (frames - firstPart) * bytesPerFrame);
+        }
+    }
+
+    queuedFrames_ += frames;
+    return frames;
+}
+
+bool Reblocker::Read(AudioTimeStamp& timeStamp) {
+    if (queuedFrames_ < blockFrames_ || blockFrames_ == 0) {
+        return false;
+    }
+
+    uint32_t bytesPerFrame = channelsPerBuffer_ * sizeof(float);
+    uint32_t firstPart = std::min(blockFrames_, capacityFrames_ - readFrame_);
+    for (uint32_t b = 0; b < numberBuffers_; ++b) {
+        const float* ring = &ring_[static_cast<size_t>(b) * capacityFrames_ * channelsPerBuffer_];
+        float* block = static_cast<float*>(blockList_->mBuffers[b].mData);
+        std::memcpy(block, ring + static_cast<size_t>(readFrame_) * channelsPerBuffer_, firstPart * bytesPerFrame);
+        std::memcpy(block + static_cast<size_t>(firstPart) * channelsPerBuffer_, ring, (blockFrames_ - firstPart) * bytesPerFrame);
+    }
+
+    timeStamp = lastTimeStamp_;
+    timeStamp.mSampleTime = headSampleTime_;
+    timeStamp.mFlags |= kAudioTimeStampSampleTimeValid;
+    if (hasHostAnchor_ && hostTicksPerFrame_ > 0.0) {
+        double ticks = static_cast<double>(anchorHostTime_) + (headSampleTime_ - anchorSampleTime_) * hostTicksPerFrame_;
+        timeStamp.mHostTime = ticks > 0.0 ? static_cast<uint64_t>(std::llround(ticks)) : 0;
+        timeStamp.mFlags |= kAudioTimeStampHostTimeValid;
+    } else {
+        timeStamp.mFlags &= ~kAudioTimeStampHostTimeValid;
+    }
+
+    readFrame_ = (readFrame_ + blockFrames_) % capacityFrames_;
+    queuedFrames_ -= blockFrames_;
+    headSampleTime_ += blockFrames_;
+    return true;
+}
+
+void Reblocker::Reset() {
+    readFrame_ = 0;
+    queuedFrames_ = 0;
+    std::memset(&lastTimeStamp_, 0, sizeof(lastTimeStamp_));
+    headSampleTime_ = 0.0;
+    anchorSampleTime_ = 0.0;
+    anchorHostTime_ = 0;
+    hasHostAnchor_ = false;
+}
+
+} // namespace Prezefren
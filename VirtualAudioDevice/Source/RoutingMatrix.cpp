@@ -0,0 +1,192 @@
+#include "../Headers/RoutingMatrix.h"
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define PREZEFREN_ROUTING_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PREZEFREN_ROUTING_NEON 1
+#endif
+
+namespace Prezefren {
+
+namespace {
+
+// out[i] = in[i] * g
+inline void Scale(float* out, const float* in, float g, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_ROUTING_SSE)
+    __m128 gain = _mm_set1_ps(g);
+    for (; i + 4 <= frames; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), gain));
+    }
+#elif defined(PREZEFREN_ROUTING_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        vst1q_f32(out + i, vmulq_n_f32(vld1q_f32(in + i), g));
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] = in[i] * g;
+    }
+}
+
+// out[i] = a[i] * ga + b[i] * gb
+inline void ScaleAdd2(float* out, const float* a, float ga, const float* b, float gb, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_ROUTING_SSE)
+    __m128 gainA = _mm_set1_ps(ga);
+    __m128 gainB = _mm_set1_ps(gb);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 mixed = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + i), gainA), _mm_mul_ps(_mm_loadu_ps(b + i), gainB));
+        _mm_storeu_ps(out + i, mixed);
+    }
+#elif defined(PREZEFREN_ROUTING_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        vst1q_f32(out + i, vmlaq_n_f32(vmulq_n_f32(vld1q_f32(a + i), ga), vld1q_f32(b + i), gb));
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] = a[i] * ga + b[i] * gb;
+    }
+}
+
+// out[i] += in[i] * g
+inline void Accumulate(float* out, const float* in, float g, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_ROUTING_SSE)
+    __m128 gain = _mm_set1_ps(g);
+    for (; i + 4 <= frames; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), gain)));
+    }
+#elif defined(PREZEFREN_ROUTING_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        vst1q_f32(out + i, vmlaq_n_f32(vld1q_f32(out + i), vld1q_f32(in + i), g));
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] += in[i] * g;
+    }
+}
+
+} // namespace
+
+RoutingMatrix::RoutingMatrix()
+    : inputs_(0)
+    , outputs_(0)
+    , isSelection_(false)
+    , kernel_(nullptr)
+{
+}
+
+bool RoutingMatrix::Configure(uint32_t inputs, uint32_t outputs, const std::vector<float>& gains) {
+    if (inputs == 0 || outputs == 0 || gains.size() != static_cast<size_t>(inputs) * outputs) {
+        return false;
+    }
+
+    inputs_ = inputs;
+    outputs_ = outputs;
+    gains_ = gains;
+
+    // A row with a single 1.0 and zeros elsewhere is a plain channel selection
+    selectedInputs_.assign(outputs_, -1);
+    isSelection_ = true;
+    for (uint32_t o = 0; o < outputs_; ++o) {
+        int selected = -1;
+        bool pure = true;
+        for (uint32_t i = 0; i < inputs_ && pure; ++i) {
+            float gain = gains_[o * inputs_ + i];
+            if (gain == 1.0f && selected < 0) {
+                selected = static_cast<int>(i);
+            } else if (gain != 0.0f) {
+                pure = false;
+            }
+        }
+        selectedInputs_[o] = pure ? selected : -1;
+        isSelection_ = isSelection_ && selectedInputs_[o] >= 0;
+    }
+
+    if (inputs_ == 2 && outputs_ == 1) {
+        kernel_ = &FixedKernel<2, 1>;
+    } else if (inputs_ == 2 && outputs_ == 2) {
+        kernel_ = &FixedKernel<2, 2>;
+    } else if (inputs_ == 1 && outputs_ == 2) {
+        kernel_ = &FixedKernel<1, 2>;
+    } else {
+        kernel_ = &GenericKernel;
+    }
+    return true;
+}
+
+std::vector<float> RoutingMatrix::Downmix(uint32_t inputs) {
+    return std::vector<float>(inputs, inputs > 0 ? 1.0f / inputs : 0.0f);
+}
+
+std::vector<float> RoutingMatrix::Extract(uint32_t inputs, uint32_t channel) {
+    std::vector<float> gains(inputs, 0.0f);
+    if (channel < inputs) {
+        gains[channel] = 1.0f;
+    }
+    return gains;
+}
+
+std::vector<float> RoutingMatrix::Map(uint32_t inputs, uint32_t outputs) {
+    std::vector<float> gains(static_cast<size_t>(inputs) * outputs, 0.0f);
+    for (uint32_t o = 0; o < outputs && inputs > 0; ++o) {
+        gains[o * inputs + std::min(o, inputs - 1)] = 1.0f;
+    }
+    return gains;
+}
+
+std::vector<float> RoutingMatrix::Adapt(const std::vector<float>& gains, uint32_t outputs,
+                                        uint32_t fromInputs, uint32_t toInputs) {
+    std::vector<float> adapted(static_cast<size_t>(outputs) * toInputs, 0.0f);
+    if (fromInputs == 0 || toInputs == 0 || gains.size() != static_cast<size_t>(outputs) * fromInputs) {
+        return adapted;
+    }
+    for (uint32_t o = 0; o < outputs; ++o) {
+        for (uint32_t i = 0; i < fromInputs; ++i) {
+            adapted[o * toInputs + std::min(i, toInputs - 1)] += gains[o * fromInputs + i];
+        }
+    }
+    return adapted;
+}
+
+void RoutingMatrix::Process(const float* const* input, float* const* output, uint32_t frames) const {
+    if (kernel_ && frames > 0) {
+        kernel_(*this, input, output, frames);
+    }
+}
+
+int RoutingMatrix::GetSelectedInput(uint32_t output) const {
+    return output < selectedInputs_.size() ? selectedInputs_[output] : -1;
+}
+
+template <uint32_t Inputs, uint32_t Outputs>
+void RoutingMatrix::FixedKernel(const RoutingMatrix& matrix, const float* const* input, float* const* output, uint32_t frames) {
+    static_assert(Inputs == 1 || Inputs == 2, "fixed kernels cover one or two inputs");
+    const float* gains = matrix.gains_.data();
+    for (uint32_t o = 0; o < Outputs; ++o) {
+        const float* row = gains + o * Inputs;
+        if (Inputs == 1) {
+            Scale(output[o], input[0], row[0], frames);
+        } else {
+            ScaleAdd2(output[o], input[0], row[0], input[1], row[Inputs - 1], frames);
+        }
+    }
+}
+
+void RoutingMatrix::GenericKernel(const RoutingMatrix& matrix, const float* const* input, float* const* output, uint32_t frames) {
+    const uint32_t inputs = matrix.inputs_;
+    for (uint32_t o = 0; o < matrix.outputs_; ++o) {
+        const float* row = &matrix.gains_[o * inputs];
+        Scale(output[o], input[0], row[0], frames);
+        for (uint32_t i = 1; i < inputs; ++i) {
+            if (row[i] != 0.0f) {
+                Accumulate(output[o], input[i], row[i], frames);
+            }
+        }
+    }
+}
+
+} // namespace Prezefren
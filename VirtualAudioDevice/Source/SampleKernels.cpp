@@ -0,0 +1,296 @@
+#include "../Headers/SampleKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PREZEFREN_KERNELS_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PREZEFREN_KERNELS_NEON 1
+#endif
+
+namespace Prezefren {
+
+namespace {
+
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+
+inline float ToFloat(float sample) { return sample; }
+inline float ToFloat(int16_t sample) { return sample * kInt16Scale; }
+
+// Same scale as ToFloat so int16 round-trips exactly; round to nearest, saturate
+inline int16_t ToInt16(float value) {
+    float scaled = std::min(std::max(value * 32768.0f, -32768.0f), 32767.0f);
+    return static_cast<int16_t>(std::nearbyint(scaled));
+}
+
+#if defined(PREZEFREN_KERNELS_SSE)
+// 8 int16 samples to two vectors of 4 floats
+inline void Int16x8ToFloat(const int16_t* in, __m128& low, __m128& high) {
+    __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128 scale = _mm_set1_ps(kInt16Scale);
+    low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)), scale);
+    high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)), scale);
+}
+
+// Two vectors of 4 floats to 8 saturated int16 samples
+inline void FloatToInt16x8(__m128 low, __m128 high, int16_t* out) {
+    __m128 scale = _mm_set1_ps(32768.0f);
+    __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(low, scale)),
+                                     _mm_cvtps_epi32(_mm_mul_ps(high, scale)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+}
+#endif
+
+// Contiguous run, sample type to float
+inline void Convert(const float* in, float* out, uint32_t frames) {
+    std::memcpy(out, in, frames * sizeof(float));
+}
+
+inline void Convert(const int16_t* in, float* out, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 8 <= frames; i += 8) {
+        __m128 low, high;
+        Int16x8ToFloat(in + i, low, high);
+        _mm_storeu_ps(out + i, low);
+        _mm_storeu_ps(out + i + 4, high);
+    }
+#elif defined(PREZEFREN_KERNELS_NEON)
+    for (; i + 8 <= frames; i += 8) {
+        int16x8_t samples = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), kInt16Scale));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), kInt16Scale));
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] = ToFloat(in[i]);
+    }
+}
+
+// Contiguous run, float to sample type
+inline void Convert(const float* in, int16_t* out, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 8 <= frames; i += 8) {
+        FloatToInt16x8(_mm_loadu_ps(in + i), _mm_loadu_ps(in + i + 4), out + i);
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[i] = ToInt16(in[i]);
+    }
+}
+
+// Interleaved stereo to two planar channels
+inline void Deinterleave(const float* in, float* left, float* right, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(PREZEFREN_KERNELS_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t frame = vld2q_f32(in + 2 * i);
+        vst1q_f32(left + i, frame.val[0]);
+        vst1q_f32(right + i, frame.val[1]);
+    }
+#endif
+    for (; i < frames; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+inline void Deinterleave(const int16_t* in, float* left, float* right, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a, b;
+        Int16x8ToFloat(in + 2 * i, a, b);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(PREZEFREN_KERNELS_NEON)
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x2_t frame = vld2q_s16(in + 2 * i);
+        vst1q_f32(left + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(frame.val[0]))), kInt16Scale));
+        vst1q_f32(left + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(frame.val[0]))), kInt16Scale));
+        vst1q_f32(right + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(frame.val[1]))), kInt16Scale));
+        vst1q_f32(right + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(frame.val[1]))), kInt16Scale));
+    }
+#endif
+    for (; i < frames; ++i) {
+        left[i] = ToFloat(in[2 * i]);
+        right[i] = ToFloat(in[2 * i + 1]);
+    }
+}
+
+// Two planar channels to interleaved stereo
+inline void Interleave(const float* left, const float* right, float* out, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(PREZEFREN_KERNELS_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t frame;
+        frame.val[0] = vld1q_f32(left + i);
+        frame.val[1] = vld1q_f32(right + i);
+        vst2q_f32(out + 2 * i, frame);
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+inline void Interleave(const float* left, const float* right, int16_t* out, uint32_t frames) {
+    uint32_t i = 0;
+#if defined(PREZEFREN_KERNELS_SSE)
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        FloatToInt16x8(_mm_unpacklo_ps(l, r), _mm_unpackhi_ps(l, r), out + 2 * i);
+    }
+#endif
+    for (; i < frames; ++i) {
+        out[2 * i] = ToInt16(left[i]);
+        out[2 * i + 1] = ToInt16(right[i]);
+    }
+}
+
+inline void Store(float value, float* out) { *out = value; }
+inline void Store(float value, int16_t* out) { *out = ToInt16(value); }
+
+// Channels == 0 means "any": the count comes from the runtime argument
+template <typename Sample, uint32_t Channels, bool Interleaved>
+void Read(const void* const* buffers, uint32_t channels, uint32_t offset, uint32_t frames, float* const* planar) {
+    const uint32_t n = Channels != 0 ? Channels : channels;
+
+    if constexpr (!Interleaved || Channels == 1) {
+        for (uint32_t c = 0; c < n; ++c) {
+            Convert(static_cast<const Sample*>(buffers[c]) + offset, planar[c], frames);
+        }
+    } else if constexpr (Channels == 2) {
+        Deinterleave(static_cast<const Sample*>(buffers[0]) + static_cast<size_t>(offset) * 2,
+                     planar[0], planar[1], frames);
+    } else {
+        const Sample* in = static_cast<const Sample*>(buffers[0]) + static_cast<size_t>(offset) * n;
+        for (uint32_t c = 0; c < n; ++c) {
+            float* out = planar[c];
+            for (uint32_t i = 0; i < frames; ++i) {
+                out[i] = ToFloat(in[static_cast<size_t>(i) * n + c]);
+            }
+        }
+    }
+}
+
+template <typename Sample, uint32_t Channels, bool Interleaved>
+void Write(const float* const* planar, uint32_t channels, uint32_t frames, void* const* buffers) {
+    const uint32_t n = Channels != 0 ? Channels : channels;
+
+    if constexpr (!Interleaved || Channels == 1) {
+        for (uint32_t c = 0; c < n; ++c) {
+            Convert(planar[c], static_cast<Sample*>(buffers[c]), frames);
+        }
+    } else if constexpr (Channels == 2) {
+        Interleave(planar[0], planar[1], static_cast<Sample*>(buffers[0]), frames);
+    } else {
+        Sample* out = static_cast<Sample*>(buffers[0]);
+        for (uint32_t c = 0; c < n; ++c) {
+            const float* in = planar[c];
+            for (uint32_t i = 0; i < frames; ++i) {
+                Store(in[i], &out[static_cast<size_t>(i) * n + c]);
+            }
+        }
+    }
+}
+
+template <typename Sample, bool Interleaved>
+SampleKernels::ReadKernel SelectReadFor(uint32_t channels) {
+    switch (channels) {
+        case 1: return &Read<Sample, 1, false>;
+        case 2: return &Read<Sample, 2, Interleaved>;
+        default: return &Read<Sample, 0, Interleaved>;
+    }
+}
+
+template <typename Sample, bool Interleaved>
+SampleKernels::WriteKernel SelectWriteFor(uint32_t channels) {
+    switch (channels) {
+        case 1: return &Write<Sample, 1, false>;
+        case 2: return &Write<Sample, 2, Interleaved>;
+        default: return &Write<Sample, 0, Interleaved>;
+    }
+}
+
+} // namespace
+
+SampleKernels::ReadKernel SampleKernels::SelectRead(const SampleLayout& layout) {
+    if (layout.channels == 0) {
+        return nullptr;
+    }
+    if (layout.type == SampleLayout::Type::Int16) {
+        return layout.interleaved ? SelectReadFor<int16_t, true>(layout.channels)
+                                  : SelectReadFor<int16_t, false>(layout.channels);
+    }
+    return layout.interleaved ? SelectReadFor<float, true>(layout.channels)
+                              : SelectReadFor<float, false>(layout.channels);
+}
+
+SampleKernels::WriteKernel SampleKernels::SelectWrite(const SampleLayout& layout) {
+    if (layout.channels == 0) {
+        return nullptr;
+    }
+    if (layout.type == SampleLayout::Type::Int16) {
+        return layout.interleaved ? SelectWriteFor<int16_t, true>(layout.channels)
+                                  : SelectWriteFor<int16_t, false>(layout.channels);
+    }
+    return layout.interleaved ? SelectWriteFor<float, true>(layout.channels)
+                              : SelectWriteFor<float, false>(layout.channels);
+}
+
+void SampleKernels::GenericRead(const SampleLayout& layout, const void* const* buffers, uint32_t offset,
+                                uint32_t frames, float* const* planar) {
+    const uint32_t stride = layout.ChannelsPerBuffer();
+    for (uint32_t c = 0; c < layout.channels; ++c) {
+        uint32_t buffer = layout.interleaved ? 0 : c;
+        uint32_t first = layout.interleaved ? c : 0;
+        for (uint32_t i = 0; i < frames; ++i) {
+            size_t index = static_cast<size_t>(offset + i) * stride + first;
+            planar[c][i] = layout.type == SampleLayout::Type::Int16
+                ? ToFloat(static_cast<const int16_t*>(buffers[buffer])[index])
+                : static_cast<const float*>(buffers[buffer])[index];
+        }
+    }
+}
+
+void SampleKernels::GenericWrite(const SampleLayout& layout, const float* const* planar, uint32_t frames,
+                                 void* const* buffers) {
+    const uint32_t stride = layout.ChannelsPerBuffer();
+    for (uint32_t c = 0; c < layout.channels; ++c) {
+        uint32_t buffer = layout.interleaved ? 0 : c;
+        uint32_t first = layout.interleaved ? c : 0;
+        for (uint32_t i = 0; i < frames; ++i) {
+            size_t index = static_cast<size_t>(i) * stride + first;
+            if (layout.type == SampleLayout::Type::Int16) {
+                static_cast<int16_t*>(buffers[buffer])[index] = ToInt16(planar[c][i]);
+            } else {
+                static_cast<float*>(buffers[buffer])[index] = planar[c][i];
+            }
+        }
+    }
+}
+
+} // namespace Prezefren
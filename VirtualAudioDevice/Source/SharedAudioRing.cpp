@@ -0,0 +1,471 @@
+#include "../Headers/SharedAudioRing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <grp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#elif defined(__APPLE__) && __has_include(<os/os_sync_wait_on_address.h>)
+#include <os/os_sync_wait_on_address.h>
+#include <os/clock.h>
+#define PREZEFREN_HAS_OS_SYNC 1
+#endif
+
+namespace Prezefren {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x5052525A;         // "PRRZ"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderBytes = 4096;           // Frames start on their own page
+constexpr uint32_t kMaxCapacityFrames = 1u << 22;
+constexpr uint32_t kMarks = 16;
+constexpr mode_t kSegmentMode = 0660;           // Producer's user and the consumer's group only
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Shared indices must be lock-free to work across processes");
+
+uint64_t DoubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double BitsDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#if !defined(__linux__)
+// Sleep until the word no longer holds expected, a wake or the timeout. Spurious
+// returns are fine: callers recheck their condition.
+void PollForChange(std::atomic<uint32_t>& word, uint32_t expected, uint32_t timeoutMilliseconds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+    while (word.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+#endif
+
+void WaitForChange(std::atomic<uint32_t>& word, uint32_t expected, uint32_t timeoutMilliseconds) {
+#if defined(__linux__)
+    timespec timeout = {static_cast<time_t>(timeoutMilliseconds / 1000),
+                        static_cast<long>(timeoutMilliseconds % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#elif defined(PREZEFREN_HAS_OS_SYNC)
+    if (__builtin_available(macOS 14.4, *)) {
+        os_sync_wait_on_address_with_timeout(&word, expected, sizeof(uint32_t), OS_SYNC_WAIT_ON_ADDRESS_SHARED,
+                                             OS_CLOCK_MACH_ABSOLUTE_TIME,
+                                             static_cast<uint64_t>(timeoutMilliseconds) * 1000000ull);
+        return;
+    }
+    PollForChange(word, expected, timeoutMilliseconds);
+#else
+    PollForChange(word, expected, timeoutMilliseconds);
+#endif
+}
+
+void WakeWaiters(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(PREZEFREN_HAS_OS_SYNC)
+    if (__builtin_available(macOS 14.4, *)) {
+        os_sync_wake_by_address_all(&word, sizeof(uint32_t), OS_SYNC_WAKE_BY_ADDRESS_SHARED);
+    }
+#else
+    (void)word;     // Pollers see the word change on their own
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Segment header, shared by both processes
+ *
+ * Timestamps are kept in a small ring of marks rather than a SeqLock: a reader of
+ * a SeqLock spins while a store is in progress, and a producer killed mid-store
+ * would leave the plugin spinning for good. A mark read here is retried a bounded
+ * number of times and otherwise extrapolated.
+ */
+struct SharedAudioRing::Header {
+    struct Mark {
+        std::atomic<uint64_t> frame;
+        std::atomic<uint64_t> sampleTimeBits;
+        std::atomic<uint64_t> hostTime;
+    };
+
+    std::atomic<uint32_t> magic;            // kMagic once everything else is initialized
+    uint32_t version;
+    uint32_t channels;
+    uint32_t capacityFrames;
+    double sampleRate;
+    double hostTicksPerFrame;
+    uint64_t session;                       // Tells one producer's segment from the next
+    std::atomic<uint32_t> closed;           // Set by the producer before it lets go of the segment
+
+    alignas(64) std::atomic<uint64_t> writeFrame;   // Producer
+    std::atomic<uint64_t> droppedFrames;
+    std::atomic<uint64_t> conversionLatencyBits;
+    std::atomic<uint64_t> markCount;
+    Mark marks[kMarks];                             // Mark of write n is marks[n % kMarks]
+
+    alignas(64) std::atomic<uint64_t> readFrame;    // Consumer
+    std::atomic<uint64_t> consumerBacklogBits;      // Negative until a consumer reports one
+
+    alignas(64) std::atomic<uint32_t> wakeSequence;
+    std::atomic<uint32_t> waiters;
+};
+
+SharedAudioRing::SharedAudioRing(const std::string& name, void* mapping, size_t mappingBytes, bool producer)
+    : name_(name)
+    , mapping_(mapping)
+    , mappingBytes_(mappingBytes)
+    , producer_(producer)
+    , header_(static_cast<Header*>(mapping))
+    , data_(reinterpret_cast<float*>(static_cast<uint8_t*>(mapping) + kHeaderBytes))
+    , channels_(header_->channels)
+    , capacity_(header_->capacityFrames)
+    , mask_(header_->capacityFrames - 1)
+    , sampleRate_(header_->sampleRate)
+    , hostTicksPerFrame_(header_->hostTicksPerFrame)
+{
+}
+
+SharedAudioRing::~SharedAudioRing() {
+    if (producer_) {
+        header_->closed.store(1, std::memory_order_release);
+        header_->wakeSequence.fetch_add(1, std::memory_order_release);
+        WakeWaiters(header_->wakeSequence);
+
+        // Unlink only if the name still refers to this segment, not a successor's
+        int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+        if (fd >= 0) {
+            void* named = mmap(nullptr, kHeaderBytes, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (named != MAP_FAILED) {
+                bool same = static_cast<const Header*>(named)->session == header_->session;
+                munmap(named, kHeaderBytes);
+                if (same) {
+                    shm_unlink(name_.c_str());
+                }
+            }
+        }
+    }
+    munmap(mapping_, mappingBytes_);
+}
+
+std::string SharedAudioRing::NameFor(const std::string& uid) {
+    // FNV-1a: uids are far longer than a portable shared-memory name may be
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : uid) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "/prezefren.%016llx", static_cast<unsigned long long>(hash));
+    return name;
+}
+
+gid_t SharedAudioRing::ConsumerGroup() {
+#if defined(__APPLE__)
+    const group* coreaudiod = getgrnam("_coreaudiod");
+    return coreaudiod ? coreaudiod->gr_gid : static_cast<gid_t>(-1);
+#else
+    return getegid();
+#endif
+}
+
+uid_t SharedAudioRing::ExpectedProducer() {
+#if defined(__APPLE__)
+    // The app runs in the logged-in GUI session, whose user owns the console
+    struct stat console;
+    return stat("/dev/console", &console) == 0 ? console.st_uid : static_cast<uid_t>(-1);
+#else
+    return geteuid();
+#endif
+}
+
+std::unique_ptr<SharedAudioRing> SharedAudioRing::Create(const std::string& name, uint32_t channels, uint32_t capacityFrames,
+                                                         double sampleRate, double hostTicksPerSecond) {
+    if (channels == 0 || channels > kMaxChannels || capacityFrames == 0 || capacityFrames > kMaxCapacityFrames ||
+        sampleRate <= 0.0) {
+        return nullptr;
+    }
+    uint32_t capacity = 1;
+    while (capacity < capacityFrames) {
+        capacity <<= 1;
+    }
+    const size_t bytes = kHeaderBytes + static_cast<size_t>(capacity) * channels * sizeof(float);
+    static_assert(sizeof(Header) <= kHeaderBytes, "Header must fit its page");
+
+    const gid_t group = ConsumerGroup();
+    if (group == static_cast<gid_t>(-1)) {
+        return nullptr;
+    }
+
+    // Retire a segment an earlier producer of this user left behind so its consumer reopens
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd >= 0) {
+        struct stat existing;
+        if (fstat(fd, &existing) == 0 && existing.st_uid == geteuid() &&
+            static_cast<size_t>(existing.st_size) >= kHeaderBytes) {
+            void* old = mmap(nullptr, kHeaderBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (old != MAP_FAILED) {
+                Header* header = static_cast<Header*>(old);
+                if (header->magic.load(std::memory_order_acquire) == kMagic) {
+                    header->closed.store(1, std::memory_order_release);
+                    header->wakeSequence.fetch_add(1, std::memory_order_release);
+                    WakeWaiters(header->wakeSequence);
+                }
+                munmap(old, kHeaderBytes);
+            }
+        }
+        close(fd);
+        shm_unlink(name.c_str());
+    }
+
+    // Exclusive: a name squatted by another user fails here rather than being reused
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, kSegmentMode);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // The consumer is another user: hand it the segment through the group, and set
+    // the mode past the umask
+    if ((group != getegid() && fchown(fd, static_cast<uid_t>(-1), group) != 0) ||
+        fchmod(fd, kSegmentMode) != 0 ||
+        ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    Header* header = new (mapping) Header;
+    header->version = kVersion;
+    header->channels = channels;
+    header->capacityFrames = capacity;
+    header->sampleRate = sampleRate;
+    header->hostTicksPerFrame = hostTicksPerSecond / sampleRate;
+    header->session = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                      (static_cast<uint64_t>(getpid()) << 32);
+    header->closed.store(0, std::memory_order_relaxed);
+    header->writeFrame.store(0, std::memory_order_relaxed);
+    header->droppedFrames.store(0, std::memory_order_relaxed);
+    header->conversionLatencyBits.store(DoubleBits(0.0), std::memory_order_relaxed);
+    header->markCount.store(0, std::memory_order_relaxed);
+    header->readFrame.store(0, std::memory_order_relaxed);
+    header->consumerBacklogBits.store(DoubleBits(-1.0), std::memory_order_relaxed);
+    header->wakeSequence.store(0, std::memory_order_relaxed);
+    header->waiters.store(0, std::memory_order_relaxed);
+    header->magic.store(kMagic, std::memory_order_release);
+
+    return std::unique_ptr<SharedAudioRing>(new SharedAudioRing(name, mapping, bytes, true));
+}
+
+std::unique_ptr<SharedAudioRing> SharedAudioRing::Open(const std::string& name, uid_t producer) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // Only the expected producer's segment: anyone else could feed the device audio
+    // of their choosing, or indices that stall it
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_uid != producer || (info.st_mode & S_IRWXO) != 0 ||
+        static_cast<size_t>(info.st_size) < kHeaderBytes) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t bytes = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // The producer is another process: check everything the bounds depend on
+    const Header* header = static_cast<const Header*>(mapping);
+    bool valid = header->magic.load(std::memory_order_acquire) == kMagic &&
+                 header->version == kVersion &&
+                 header->channels > 0 && header->channels <= kMaxChannels &&
+                 header->capacityFrames > 0 && header->capacityFrames <= kMaxCapacityFrames &&
+                 (header->capacityFrames & (header->capacityFrames - 1)) == 0 &&
+                 header->sampleRate > 0.0 &&
+                 kHeaderBytes + static_cast<size_t>(header->capacityFrames) * header->channels * sizeof(float) == bytes;
+    // A retired segment may still be reachable between being closed and unlinked
+    if (!valid || header->closed.load(std::memory_order_acquire)) {
+        munmap(mapping, bytes);
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedAudioRing> ring(new SharedAudioRing(name, mapping, bytes, false));
+    ring->header_->readFrame.store(ring->header_->writeFrame.load(std::memory_order_acquire), std::memory_order_release);
+    return ring;
+}
+
+uint32_t SharedAudioRing::Write(const float* const* planar, uint32_t planarChannels, uint32_t frames,
+                                double sampleTime, uint64_t hostTime) {
+    if (!producer_ || planarChannels == 0 || frames == 0) {
+        return 0;
+    }
+
+    const uint64_t write = header_->writeFrame.load(std::memory_order_relaxed);
+    const uint64_t read = header_->readFrame.load(std::memory_order_acquire);
+    const uint64_t buffered = write - std::min(read, write);
+    const uint32_t space = buffered >= capacity_ ? 0 : capacity_ - static_cast<uint32_t>(buffered);
+    const uint32_t count = std::min(frames, space);
+    if (count < frames) {
+        header_->droppedFrames.fetch_add(frames - count, std::memory_order_relaxed);
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    for (uint32_t c = 0; c < channels_; ++c) {
+        const float* source = planar[std::min(c, planarChannels - 1)];
+        uint64_t position = write;
+        for (uint32_t f = 0; f < count; ++f, ++position) {
+            data_[static_cast<size_t>(position & mask_) * channels_ + c] = source[f];
+        }
+    }
+
+    const uint64_t markIndex = header_->markCount.load(std::memory_order_relaxed);
+    Header::Mark& mark = header_->marks[markIndex % kMarks];
+    mark.frame.store(write, std::memory_order_relaxed);
+    mark.sampleTimeBits.store(DoubleBits(sampleTime), std::memory_order_relaxed);
+    mark.hostTime.store(hostTime, std::memory_order_relaxed);
+    header_->markCount.store(markIndex + 1, std::memory_order_release);
+    header_->writeFrame.store(write + count, std::memory_order_release);
+
+    // Pairs with the fence in Wait(): either the waiter sees the frames or we see it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->waiters.load(std::memory_order_relaxed) > 0) {
+        header_->wakeSequence.fetch_add(1, std::memory_order_release);
+        WakeWaiters(header_->wakeSequence);
+    }
+    return count;
+}
+
+uint32_t SharedAudioRing::Peek(Region& region) const {
+    const uint64_t write = header_->writeFrame.load(std::memory_order_acquire);
+    const uint64_t read = header_->readFrame.load(std::memory_order_relaxed);
+    if (producer_ || write <= read) {
+        return 0;
+    }
+
+    // An honest producer never gets more than capacity_ ahead; the mask keeps a
+    // broken one inside the mapping regardless
+    const uint32_t available = static_cast<uint32_t>(std::min<uint64_t>(write - read, capacity_));
+    const uint32_t start = static_cast<uint32_t>(read & mask_);
+    const uint32_t first = std::min(available, capacity_ - start);
+    region.data[0] = data_ + static_cast<size_t>(start) * channels_;
+    region.frames[0] = first;
+    region.data[1] = data_;
+    region.frames[1] = available - first;
+    region.position = read;
+
+    // Extrapolate from the newest mark that reads back consistently
+    region.sampleTime = static_cast<double>(read);
+    region.hostTime = 0;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        const uint64_t count = header_->markCount.load(std::memory_order_acquire);
+        if (count == 0) {
+            break;
+        }
+        const Header::Mark& mark = header_->marks[(count - 1) % kMarks];
+        const uint64_t frame = mark.frame.load(std::memory_order_relaxed);
+        const double sampleTime = BitsDouble(mark.sampleTimeBits.load(std::memory_order_relaxed));
+        const uint64_t hostTime = mark.hostTime.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->markCount.load(std::memory_order_relaxed) - count >= kMarks - 1) {
+            continue;   // Lapped while copying
+        }
+        const double offset = static_cast<double>(static_cast<int64_t>(read - frame));
+        region.sampleTime = sampleTime + offset;
+        if (hostTime != 0) {
+            region.hostTime = static_cast<uint64_t>(std::max(static_cast<double>(hostTime) + offset * hostTicksPerFrame_, 0.0));
+        }
+        break;
+    }
+    return available;
+}
+
+void SharedAudioRing::Consume(uint32_t frames) {
+    const uint64_t write = header_->writeFrame.load(std::memory_order_acquire);
+    const uint64_t read = header_->readFrame.load(std::memory_order_relaxed);
+    if (producer_ || write <= read) {
+        return;
+    }
+    header_->readFrame.store(read + std::min<uint64_t>(frames, write - read), std::memory_order_release);
+}
+
+bool SharedAudioRing::Wait(uint32_t timeoutMilliseconds) {
+    auto readable = [this] {
+        return header_->writeFrame.load(std::memory_order_acquire) > header_->readFrame.load(std::memory_order_relaxed);
+    };
+    if (readable()) {
+        return true;
+    }
+
+    const uint32_t sequence = header_->wakeSequence.load(std::memory_order_acquire);
+    header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!readable() && !IsClosed()) {
+        WaitForChange(header_->wakeSequence, sequence, timeoutMilliseconds);
+    }
+    header_->waiters.fetch_sub(1, std::memory_order_relaxed);
+    return readable();
+}
+
+bool SharedAudioRing::IsClosed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+void SharedAudioRing::SetConsumerBacklog(double frames) {
+    header_->consumerBacklogBits.store(DoubleBits(std::max(frames, 0.0)), std::memory_order_relaxed);
+}
+
+double SharedAudioRing::GetFillLevel() const {
+    const double backlog = BitsDouble(header_->consumerBacklogBits.load(std::memory_order_relaxed));
+    if (!(backlog >= 0.0)) {
+        return -1.0;
+    }
+    const uint64_t write = header_->writeFrame.load(std::memory_order_relaxed);
+    const uint64_t read = header_->readFrame.load(std::memory_order_acquire);
+    return static_cast<double>(write - std::min(read, write)) + backlog;
+}
+
+void SharedAudioRing::SetConversionLatency(double seconds) {
+    header_->conversionLatencyBits.store(DoubleBits(seconds), std::memory_order_relaxed);
+}
+
+double SharedAudioRing::GetConversionLatency() const {
+    return BitsDouble(header_->conversionLatencyBits.load(std::memory_order_relaxed));
+}
+
+SharedAudioRing::Statistics SharedAudioRing::GetStatistics() const {
+    Statistics stats;
+    stats.framesWritten = header_->writeFrame.load(std::memory_order_relaxed);
+    stats.framesRead = header_->readFrame.load(std::memory_order_relaxed);
+    stats.droppedFrames = header_->droppedFrames.load(std::memory_order_relaxed);
+    stats.bufferedFrames = static_cast<uint32_t>(std::min<uint64_t>(
+        stats.framesWritten - std::min(stats.framesRead, stats.framesWritten), capacity_));
+    return stats;
+}
+
+} // namespace Prezefren
@@ -0,0 +1,230 @@
+#include "../Headers/StreamRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Prezefren {
+
+StreamRingBuffer::StreamRingBuffer()
+    : channels_(0)
+    , capacity_(0)
+    , mask_(0)
+    , targetLatency_(0)
+    , writeFrame_(0)
+    , writeLimit_(0)
+    , generation_(0)
+    , underruns_(0)
+    , overruns_(0)
+{
+    for (Reader& reader : readers_) {
+        reader.active.store(false, std::memory_order_relaxed);
+        reader.id.store(0, std::memory_order_relaxed);
+        reader.cursor.store(0, std::memory_order_relaxed);
+        reader.primed.store(false, std::memory_order_relaxed);
+        reader.generation = 0;
+    }
+}
+
+bool StreamRingBuffer::Configure(uint32_t channels, uint32_t capacityFrames, uint32_t targetLatencyFrames) {
+    if (channels == 0 || capacityFrames == 0) {
+        return false;
+    }
+
+    uint32_t capacity = 1;
+    while (capacity < capacityFrames) {
+        capacity <<= 1;
+    }
+    // A primed reader holds the target plus one read; leave room for both
+    if (targetLatencyFrames >= capacity / 2) {
+        return false;
+    }
+
+    channels_ = channels;
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    targetLatency_ = targetLatencyFrames;
+    data_.assign(static_cast<size_t>(capacity_) * channels_, 0.0f);
+    writeFrame_.store(0, std::memory_order_relaxed);
+    writeLimit_.store(0, std::memory_order_relaxed);
+    Reset();
+    return true;
+}
+
+uint32_t StreamRingBuffer::Write(const AudioBufferList& bufferList) {
+    if (capacity_ == 0 || bufferList.mNumberBuffers == 0) {
+        return 0;
+    }
+
+    const uint32_t firstChannels = std::max<uint32_t>(bufferList.mBuffers[0].mNumberChannels, 1);
+    uint32_t frames = bufferList.mBuffers[0].mDataByteSize / (sizeof(float) * firstChannels);
+    for (uint32_t b = 1; b < bufferList.mNumberBuffers; ++b) {
+        uint32_t channels = std::max<uint32_t>(bufferList.mBuffers[b].mNumberChannels, 1);
+        frames = std::min<uint32_t>(frames, bufferList.mBuffers[b].mDataByteSize / (sizeof(float) * channels));
+    }
+
+    // More than the ring holds: only the newest capacity_ frames can survive
+    uint32_t skip = frames > capacity_ ? frames - capacity_ : 0;
+    uint64_t write = writeFrame_.load(std::memory_order_relaxed) + skip;
+
+    // Announce the frames about to be overwritten before touching them (seqlock
+    // style), so a reader copying them can tell afterwards
+    writeLimit_.store(write + (frames - skip), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Map each ring channel to (buffer, channel within the buffer) once
+    const bool interleaved = bufferList.mNumberBuffers == 1 && firstChannels > 1;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        const float* source;
+        uint32_t stride;
+        if (interleaved) {
+            source = static_cast<const float*>(bufferList.mBuffers[0].mData) + std::min(c, firstChannels - 1);
+            stride = firstChannels;
+        } else {
+            const AudioBuffer& buffer = bufferList.mBuffers[std::min(c, bufferList.mNumberBuffers - 1)];
+            source = static_cast<const float*>(buffer.mData);
+            stride = std::max<uint32_t>(buffer.mNumberChannels, 1);
+        }
+        source += static_cast<size_t>(skip) * stride;
+
+        uint64_t position = write;
+        for (uint32_t f = skip; f < frames; ++f, ++position, source += stride) {
+            data_[static_cast<size_t>(position & mask_) * channels_ + c] = *source;
+        }
+    }
+
+    writeFrame_.store(write + (frames - skip), std::memory_order_release);
+    return frames;
+}
+
+bool StreamRingBuffer::Read(uint32_t readerId, float* interleaved, uint32_t frames, uint64_t* position) {
+    Reader* reader = FindReader(readerId);
+    if (!reader || frames == 0 || frames > capacity_ - targetLatency_) {
+        std::memset(interleaved, 0, static_cast<size_t>(frames) * channels_ * sizeof(float));
+        return false;
+    }
+
+    const uint64_t write = writeFrame_.load(std::memory_order_acquire);
+    uint32_t generation = generation_.load(std::memory_order_acquire);
+    if (reader->generation != generation) {
+        reader->generation = generation;
+        reader->primed.store(false, std::memory_order_relaxed);
+        reader->cursor.store(write, std::memory_order_relaxed);
+    }
+
+    const uint64_t needed = static_cast<uint64_t>(targetLatency_) + frames;
+    uint64_t cursor = reader->cursor.load(std::memory_order_relaxed);
+    if (!reader->primed.load(std::memory_order_relaxed)) {
+        if (write - cursor < needed) {
+            std::memset(interleaved, 0, static_cast<size_t>(frames) * channels_ * sizeof(float));
+            return false;
+        }
+        // Start exactly the target behind, whatever accumulated while priming
+        cursor = write - needed;
+        reader->primed.store(true, std::memory_order_relaxed);
+    } else if (write - cursor > capacity_ - frames) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+        cursor = write - needed;
+    }
+
+    uint64_t available = write - cursor;
+    uint32_t copied = static_cast<uint32_t>(std::min<uint64_t>(available, frames));
+    CopyOut(cursor, interleaved, copied);
+
+    // The writer may have lapped the frames while they were copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (writeLimit_.load(std::memory_order_relaxed) - cursor > capacity_) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+        std::memset(interleaved, 0, static_cast<size_t>(frames) * channels_ * sizeof(float));
+        reader->primed.store(false, std::memory_order_relaxed);
+        reader->cursor.store(write, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (copied < frames) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        std::memset(interleaved + static_cast<size_t>(copied) * channels_, 0,
+                    static_cast<size_t>(frames - copied) * channels_ * sizeof(float));
+        reader->primed.store(false, std::memory_order_relaxed);
+        reader->cursor.store(write, std::memory_order_relaxed);
+        return false;
+    }
+
+    reader->cursor.store(cursor + frames, std::memory_order_relaxed);
+    if (position) {
+        *position = cursor;
+    }
+    return true;
+}
+
+bool StreamRingBuffer::AddReader(uint32_t readerId) {
+    if (FindReader(readerId)) {
+        return true;
+    }
+    for (Reader& reader : readers_) {
+        if (!reader.active.load(std::memory_order_acquire)) {
+            reader.id.store(readerId, std::memory_order_relaxed);
+            reader.primed.store(false, std::memory_order_relaxed);
+            reader.cursor.store(writeFrame_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            reader.generation = generation_.load(std::memory_order_relaxed);
+            reader.active.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+void StreamRingBuffer::RemoveReader(uint32_t readerId) {
+    if (Reader* reader = FindReader(readerId)) {
+        reader->active.store(false, std::memory_order_release);
+    }
+}
+
+void StreamRingBuffer::Reset() {
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+double StreamRingBuffer::GetFillLevel() const {
+    const uint64_t write = writeFrame_.load(std::memory_order_acquire);
+    double fill = -1.0;
+    for (const Reader& reader : readers_) {
+        if (reader.active.load(std::memory_order_acquire) && reader.primed.load(std::memory_order_relaxed)) {
+            uint64_t cursor = reader.cursor.load(std::memory_order_relaxed);
+            fill = std::max(fill, static_cast<double>(write - std::min(cursor, write)));
+        }
+    }
+    return fill;
+}
+
+StreamRingBuffer::Statistics StreamRingBuffer::GetStatistics() const {
+    Statistics stats;
+    stats.framesWritten = writeFrame_.load(std::memory_order_relaxed);
+    stats.underruns = underruns_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.readers = 0;
+    for (const Reader& reader : readers_) {
+        stats.readers += reader.active.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    return stats;
+}
+
+StreamRingBuffer::Reader* StreamRingBuffer::FindReader(uint32_t readerId) {
+    for (Reader& reader : readers_) {
+        if (reader.active.load(std::memory_order_acquire) && reader.id.load(std::memory_order_relaxed) == readerId) {
+            return &reader;
+        }
+    }
+    return nullptr;
+}
+
+void StreamRingBuffer::CopyOut(uint64_t position, float* interleaved, uint32_t frames) const {
+    // At most two contiguous runs around the wrap
+    uint32_t start = static_cast<uint32_t>(position & mask_);
+    uint32_t first = std::min(frames, capacity_ - start);
+    std::memcpy(interleaved, &data_[static_cast<size_t>(start) * channels_],
+                static_cast<size_t>(first) * channels_ * sizeof(float));
+    if (first < frames) {
+        std::memcpy(interleaved + static_cast<size_t>(first) * channels_, data_.data(),
+                    static_cast<size_t>(frames - first) * channels_ * sizeof(float));
+    }
+}
+
+} // namespace Prezefren
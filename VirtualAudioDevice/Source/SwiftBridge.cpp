@@ -12,6 +12,8 @@ struct VirtualAudioStatistics {
     uint64_t buffersProcessed;
     double averageLatency;
     bool hasErrors;
+    double captureLatencyMs;        // Measured capture-to-device-client latency
+    double maximumLatencyMs;        // Bound the active profile sets on it
 };
 
 /**
@@ -181,11 +183,21 @@ void updateConfigurationC(
     }
 }
 
+/**
+ * @brief Tap buffer size to request for the configured latency profile
+ */
+uint32_t getPreferredBufferFrameSizeC(void* integration) {
+    if (!integration) {
+        return 0;
+    }
+    return static_cast<VirtualAudioIntegration*>(integration)->GetPreferredBufferFrameSize();
+}
+
 /**
  * @brief Get statistics
  */
 VirtualAudioStatistics getStatisticsC(void* integration) {
-    VirtualAudioStatistics stats = {false, 0, 0.0, false};
+    VirtualAudioStatistics stats = {false, 0, 0.0, false, 0.0, 0.0};
     
     if (!integration) {
         return stats;
@@ -199,6 +211,8 @@ VirtualAudioStatistics getStatisticsC(void* integration) {
         stats.buffersProcessed = simpleStats.buffersProcessed;
         stats.averageLatency = simpleStats.averageLatency;
         stats.hasErrors = simpleStats.hasErrors;
+        stats.captureLatencyMs = simpleStats.captureLatencyMs;
+        stats.maximumLatencyMs = simpleStats.maximumLatencyMs;
         
     } catch (const std::exception& e) {
         NSLog(@"❌ getStatisticsC: Exception: %s", e.what());
@@ -1,11 +1,16 @@
 #include "../Headers/VirtualAudioIntegration.h"
 #include "../Headers/PrezefrenDriver.h"
 #include "../Headers/AudioSplitter.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <pthread.h>
 
 VirtualAudioIntegration::VirtualAudioIntegration()
     : enabled_(false)
     , initialized_(false)
+    , inputFormat_(nullptr)
+    , requestedFormatGeneration_(0)
     , buffersProcessed_(0)
     , totalLatency_(0.0)
     , hasErrors_(false)
@@ -76,20 +81,30 @@ bool VirtualAudioIntegration::ProcessAudioBuffer(AVAudioPCMBuffer* buffer, const
     auto startTime = std::chrono::high_resolution_clock::now();
     
     try {
-        // Convert AVAudioPCMBuffer to AudioBufferList
-        AudioBufferList bufferList;
-        bufferList.mNumberBuffers = buffer.format.channelCount;
+        // A new input device shows up as a new tap format. The splitter is renegotiated
+        // on the control thread instead of tearing the driver down, once per format: a
+        // rejected one is not retried every buffer. The conversion slice size stays the
+        // latency profile's whatever the tap delivers.
+        if (formatControl_ && ![buffer.format isEqual:inputFormat_]) {
+            [inputFormat_ release];
+            inputFormat_ = [buffer.format retain];
+            formatControl_->Request(inputFormat_, ++requestedFormatGeneration_);
+        }
         
-        // For simplicity, assume non-interleaved format
-        for (UInt32 i = 0; i < buffer.format.channelCount; ++i) {
-            bufferList.mBuffers[i].mNumberChannels = 1;
-            bufferList.mBuffers[i].mDataByteSize = buffer.frameLength * sizeof(Float32);
-            bufferList.mBuffers[i].mData = buffer.floatChannelData[i];
+        if (formatControl_) {
+            // Until the new graph is published, buffers would be converted as the old format
+            if (formatControl_->appliedGeneration.load(std::memory_order_acquire) != requestedFormatGeneration_) {
+                return true;
+            }
+            if (!formatControl_->supported.load(std::memory_order_relaxed)) {
+                return false;
+            }
         }
         
-        // Process through virtual audio system
+        // The buffer's own list describes any layout (interleaved, int16) correctly,
+        // with mDataByteSize matching frameLength
         if (driver_) {
-            driver_->FeedAudioFromCurrentEngine(bufferList, timeStamp);
+            driver_->FeedAudioFromCurrentEngine(*buffer.audioBufferList, timeStamp);
         }
         
         // Update statistics
@@ -127,8 +142,8 @@ void VirtualAudioIntegration::SetTranscriptionCallback(std::function<void(AVAudi
     if (driver_ && transcriptionCallback_) {
         // Set up bridge callback that converts AudioBufferList back to AVAudioPCMBuffer
         driver_->SetTranscriptionCallback(
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                if (transcriptionCallback_) {
+            [this, callback = transcriptionCallback_](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+                if (callback) {
                     // Create AVAudioFormat for the transcription audio (16kHz mono)
                     AVAudioFormat* format = [[AVAudioFormat alloc] 
                         initWithCommonFormat:AVAudioPCMFormatFloat32
@@ -139,7 +154,7 @@ void VirtualAudioIntegration::SetTranscriptionCallback(std::function<void(AVAudi
                     // Convert AudioBufferList back to AVAudioPCMBuffer
                     AVAudioPCMBuffer* buffer = ConvertAudioBufferList(bufferList, format);
                     if (buffer) {
-                        transcriptionCallback_(buffer, timeStamp);
+                        callback(buffer, timeStamp);
                         [buffer release];
                     }
                     
@@ -156,8 +171,8 @@ void VirtualAudioIntegration::SetPassthroughCallback(std::function<void(AVAudioP
     if (driver_ && passthroughCallback_) {
         // Set up bridge callback that converts AudioBufferList back to AVAudioPCMBuffer
         driver_->SetPassthroughCallback(
-            [this](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
-                if (passthroughCallback_) {
+            [this, callback = passthroughCallback_](const AudioBufferList& bufferList, const AudioTimeStamp& timeStamp) {
+                if (callback) {
                     // Create AVAudioFormat for the passthrough audio (48kHz stereo)
                     AVAudioFormat* format = [[AVAudioFormat alloc] 
                         initWithCommonFormat:AVAudioPCMFormatFloat32
@@ -168,7 +183,7 @@ void VirtualAudioIntegration::SetPassthroughCallback(std::function<void(AVAudioP
                     // Convert AudioBufferList back to AVAudioPCMBuffer
                     AVAudioPCMBuffer* buffer = ConvertAudioBufferList(bufferList, format);
                     if (buffer) {
-                        passthroughCallback_(buffer, timeStamp);
+                        callback(buffer, timeStamp);
                         [buffer release];
                     }
                     
@@ -190,6 +205,11 @@ void VirtualAudioIntegration::UpdateConfig(const Config& newConfig) {
         driverConfig.enableTranscriptionDevice = config_.useForTranscription;
         driverConfig.enablePassthroughDevice = config_.useForPassthrough;
         driverConfig.enableStereoSeparation = config_.enableStereoSeparation;
+        driverConfig.devices = config_.devices;
+        driverConfig.transport = config_.feedInstalledPlugin
+            ? Prezefren::Driver::Configuration::Transport::SharedMemoryProducer
+            : Prezefren::Driver::Configuration::Transport::InProcess;
+        driverConfig.latencyProfile = LatencyProfileFor(config_);
         
         driver_->UpdateConfiguration(driverConfig);
     }
@@ -209,6 +229,23 @@ void VirtualAudioIntegration::UpdateConfig(const Config& newConfig) {
     }
 }
 
+bool VirtualAudioIntegration::UpdateDeviceTopology(const std::vector<Prezefren::DeviceSpec>& devices) {
+    if (driver_) {
+        if (!driver_->UpdateTopology(devices)) {
+            return false;
+        }
+    } else {
+        std::string error;
+        if (!Prezefren::ValidateTopology(devices, error)) {
+            NSLog(@"❌ VirtualAudioIntegration: Invalid device topology: %s", error.c_str());
+            return false;
+        }
+    }
+    
+    config_.devices = devices;
+    return true;
+}
+
 VirtualAudioIntegration::SimpleStats VirtualAudioIntegration::GetStatistics() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
     
@@ -217,10 +254,36 @@ VirtualAudioIntegration::SimpleStats VirtualAudioIntegration::GetStatistics() co
     stats.buffersProcessed = buffersProcessed_;
     stats.averageLatency = buffersProcessed_ > 0 ? totalLatency_ / buffersProcessed_ : 0.0;
     stats.hasErrors = hasErrors_;
+    stats.clockDriftPpm = 0.0;
+    stats.captureLatencyMs = 0.0;
+    stats.maximumLatencyMs = 0.0;
+    
+    if (driver_) {
+        auto driverStats = driver_->GetStatistics();
+        for (const auto& device : driverStats.deviceDriftPpm) {
+            if (std::fabs(device.second) > std::fabs(stats.clockDriftPpm)) {
+                stats.clockDriftPpm = device.second;
+            }
+        }
+        for (const auto& device : driverStats.deviceLatency) {
+            stats.captureLatencyMs = std::max(stats.captureLatencyMs, device.second.averageSeconds * 1000.0);
+        }
+        for (const auto& device : driverStats.maximumLatency) {
+            stats.maximumLatencyMs = std::max(stats.maximumLatencyMs, device.second * 1000.0);
+        }
+    }
     
     return stats;
 }
 
+UInt32 VirtualAudioIntegration::GetPreferredBufferFrameSize() const {
+    return LatencyProfileFor(config_).ioBufferFrames;
+}
+
+Prezefren::LatencyProfile VirtualAudioIntegration::LatencyProfileFor(const Config& config) {
+    return config.enableLowLatencyMode ? Prezefren::LatencyProfile::LowLatency() : Prezefren::LatencyProfile::Balanced();
+}
+
 bool VirtualAudioIntegration::IsVirtualAudioSupported() {
     // Check macOS version and other system requirements
     NSProcessInfo* processInfo = [NSProcessInfo processInfo];
@@ -249,11 +312,13 @@ bool VirtualAudioIntegration::InitializeVirtualAudioSystem() {
         driverConfig.enableTranscriptionDevice = config_.useForTranscription;
         driverConfig.enablePassthroughDevice = config_.useForPassthrough;
         driverConfig.enableStereoSeparation = config_.enableStereoSeparation;
+        driverConfig.devices = config_.devices;
+        driverConfig.transport = config_.feedInstalledPlugin
+            ? Prezefren::Driver::Configuration::Transport::SharedMemoryProducer
+            : Prezefren::Driver::Configuration::Transport::InProcess;
         driverConfig.enableStatistics = config_.enableStatistics;
         
-        if (config_.enableLowLatencyMode) {
-            driverConfig.bufferFrameSize = 256; // Smaller buffer for lower latency
-        }
+        driverConfig.latencyProfile = LatencyProfileFor(config_);
         
         // Create driver
         driver_ = std::make_unique<Prezefren::Driver>(driverConfig);
@@ -274,7 +339,7 @@ bool VirtualAudioIntegration::InitializeVirtualAudioSystem() {
                         channels:2
                      interleaved:NO];
         
-        if (!splitter_->Initialize(defaultFormat)) {
+        if (!splitter_->Initialize(defaultFormat, driverConfig.latencyProfile.converterBlockFrames)) {
             NSLog(@"❌ VirtualAudioIntegration: Failed to initialize audio splitter");
             [defaultFormat release];
             driver_.reset();
@@ -295,6 +360,8 @@ bool VirtualAudioIntegration::InitializeVirtualAudioSystem() {
             return false;
         }
         
+        formatControl_ = std::make_unique<FormatControl>(driver_.get());
+        
         NSLog(@"✅ VirtualAudioIntegration: Virtual audio system initialized successfully");
         return true;
         
@@ -305,6 +372,9 @@ bool VirtualAudioIntegration::InitializeVirtualAudioSystem() {
 }
 
 void VirtualAudioIntegration::ShutdownVirtualAudioSystem() {
+    // Stop following formats before the driver it reconfigures goes away
+    formatControl_.reset();
+    
     if (driver_) {
         driver_->DisableVirtualAudio();
         driver_->Teardown();
@@ -313,9 +383,80 @@ void VirtualAudioIntegration::ShutdownVirtualAudioSystem() {
     
     splitter_.reset();
     
+    if (inputFormat_) {
+        [inputFormat_ release];
+        inputFormat_ = nullptr;
+    }
+    
     NSLog(@"✅ VirtualAudioIntegration: Virtual audio system shutdown");
 }
 
+VirtualAudioIntegration::FormatControl::FormatControl(Prezefren::Driver* target)
+    : driver(target)
+    , pending(nullptr)
+    , pendingGeneration(0)
+    , appliedGeneration(0)
+    , supported(true)
+    , running(true)
+    , wakeup(dispatch_semaphore_create(0))
+{
+    worker = std::thread([this] { Run(); });
+}
+
+VirtualAudioIntegration::FormatControl::~FormatControl() {
+    running.store(false, std::memory_order_release);
+    dispatch_semaphore_signal(wakeup);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    [pending release];
+    dispatch_release(wakeup);
+}
+
+void VirtualAudioIntegration::FormatControl::Request(AVAudioFormat* format, uint64_t generation) {
+    // Tap thread: a pointer swap under a lock the worker only holds for the same
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        [pending release];
+        pending = [format retain];
+        pendingGeneration = generation;
+    }
+    dispatch_semaphore_signal(wakeup);
+}
+
+void VirtualAudioIntegration::FormatControl::Run() {
+    pthread_setname_np("com.prezefren.integration.format");
+    
+    while (running.load(std::memory_order_acquire)) {
+        dispatch_semaphore_wait(wakeup, dispatch_time(DISPATCH_TIME_NOW, 100 * NSEC_PER_MSEC));
+        
+        // Formats requested while the last one was applied collapse into the latest
+        AVAudioFormat* format = nullptr;
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            format = pending;
+            pending = nullptr;
+            generation = pendingGeneration;
+        }
+        if (!format) {
+            continue;
+        }
+        
+        bool accepted = driver->SetInputFormat(format);
+        if (accepted) {
+            NSLog(@"✅ VirtualAudioIntegration: Following input format %.0fHz, %u channels",
+                  format.sampleRate, format.channelCount);
+        } else {
+            NSLog(@"⚠️ VirtualAudioIntegration: Input format %.0fHz, %u channels not supported",
+                  format.sampleRate, format.channelCount);
+        }
+        supported.store(accepted, std::memory_order_relaxed);
+        appliedGeneration.store(generation, std::memory_order_release);
+        [format release];
+    }
+}
+
 AVAudioPCMBuffer* VirtualAudioIntegration::ConvertAudioBufferList(const AudioBufferList& bufferList, AVAudioFormat* format) {
     if (bufferList.mNumberBuffers == 0 || !format) {
         return nullptr;
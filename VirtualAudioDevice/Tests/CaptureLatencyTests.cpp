@@ -0,0 +1,107 @@
+#include "PrezefrenVirtualDevice.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cmath>
+#include <mach/mach_time.h>
+#include <vector>
+
+using Prezefren::LatencyProfile;
+using Prezefren::Test::Check;
+using Prezefren::VirtualDevice;
+
+namespace {
+
+const uint64_t kStartHostTime = 1000000000ull;     // Host ticks are nanoseconds in the stub
+const int kBuffers = 200;
+
+/**
+ * @brief Feeds tap buffers and serves one client on an exact timeline
+ * @param readPhase Where in each IO period the client reads, as a fraction of it
+ * @param readFrames Frames per client read, at most the IO buffer size
+ * @return The device's measured capture-to-client latency
+ *
+ * A tap buffer is fed the moment its last frame is captured, stamped with the host
+ * time of its first frame, as the capture tap delivers them. The client reads
+ * readFrames at the device rate, starting readPhase into the first period.
+ */
+VirtualDevice::LatencyStatistics Measure(const LatencyProfile& profile, double sampleRate,
+                                         double readPhase, uint32_t readFrames) {
+    std::atomic<uint64_t>& hostTime = prezefren_test_host_time();
+    hostTime.store(kStartHostTime);
+
+    VirtualDevice device(std::make_shared<aspl::Context>(), "Latency Test", "com.prezefren.test.latency",
+                         sampleRate, 1, profile);
+    auto client = std::make_shared<aspl::Client>(1);
+    device.GetControlHandler()->OnAddClient(client);
+    device.StartIO();
+
+    const double ticksPerFrame = 1.0e9 / sampleRate;
+    const uint32_t bufferFrames = profile.ioBufferFrames;
+    std::vector<float> buffer(bufferFrames, 0.25f);
+    std::vector<float> clientBuffer(readFrames);
+    AudioBufferList bufferList = { 1, { { 1, static_cast<UInt32>(bufferFrames * sizeof(float)), buffer.data() } } };
+
+    uint64_t fed = 0;
+    uint64_t read = 0;
+    const uint64_t totalFrames = static_cast<uint64_t>(kBuffers) * bufferFrames;
+    const double readOffset = readPhase * bufferFrames * ticksPerFrame;
+    while (fed < totalFrames) {
+        // Next event on the timeline: the tap completing a buffer or the client's IO cycle
+        double feedTime = kStartHostTime + (fed + bufferFrames) * ticksPerFrame;
+        double readTime = kStartHostTime + readOffset + (read + readFrames) * ticksPerFrame;
+        if (feedTime <= readTime) {
+            hostTime.store(static_cast<uint64_t>(feedTime));
+            AudioTimeStamp timeStamp = {};
+            timeStamp.mFlags = kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid;
+            timeStamp.mSampleTime = static_cast<Float64>(fed);
+            timeStamp.mHostTime = static_cast<UInt64>(feedTime - bufferFrames * ticksPerFrame);
+            device.FeedAudioData(bufferList, timeStamp);
+            fed += bufferFrames;
+        } else {
+            hostTime.store(static_cast<uint64_t>(readTime));
+            device.GetIOHandler()->OnReadClientInput(client, device.GetStreamByIndex(0), 0.0,
+                                                     static_cast<Float64>(read), clientBuffer.data(),
+                                                     static_cast<UInt32>(clientBuffer.size() * sizeof(float)));
+            read += readFrames;
+        }
+    }
+
+    device.StopIO();
+    VirtualDevice::LatencyStatistics statistics = device.GetCaptureLatency();
+    hostTime.store(0);
+    return statistics;
+}
+
+void TestProfile(const LatencyProfile& profile, double sampleRate) {
+    std::printf("\n⏱️ %s at %.0f Hz\n", profile.name, sampleRate);
+    const double bound = profile.MaximumLatencySeconds(sampleRate, sampleRate);
+    const double tolerance = 1.0e-6;    // Host-tick rounding of the timeline
+
+    double worst = 0.0;
+    bool measured = true;
+    bool bounded = true;
+    for (uint32_t readFrames : { profile.ioBufferFrames, profile.ioBufferFrames / 2 }) {
+        for (double readPhase : { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 0.999 }) {
+            VirtualDevice::LatencyStatistics statistics = Measure(profile, sampleRate, readPhase, readFrames);
+            measured = measured && statistics.measurements > 0;
+            bounded = bounded && statistics.maximumSeconds <= bound + tolerance;
+            worst = std::max(worst, statistics.maximumSeconds);
+        }
+    }
+
+    std::printf("   bound %.2f ms, worst measured %.2f ms\n", bound * 1000.0, worst * 1000.0);
+    Check(measured, "Client reads are timed at every read phase", 0);
+    Check(bounded, "Measured latency stays within MaximumLatencySeconds", worst * 1000.0);
+    // A read just before a feed sees the whole tap buffer on top of the backlog
+    Check(worst > 0.95 * bound, "The bound is reached by the worst read phase", worst / bound);
+}
+
+} // namespace
+
+int main() {
+    TestProfile(LatencyProfile::LowLatency(), 48000.0);
+    TestProfile(LatencyProfile::LowLatency(), 16000.0);
+    TestProfile(LatencyProfile::Balanced(), 48000.0);
+    TestProfile(LatencyProfile::Balanced(), 16000.0);
+    return Prezefren::Test::Finish("CaptureLatencyTests");
+}
@@ -0,0 +1,71 @@
+#include "PolyphaseResampler.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <vector>
+
+using Prezefren::PolyphaseResampler;
+
+namespace {
+
+/**
+ * @brief Resamples ten seconds of noise in tap-sized blocks and reports throughput
+ */
+void Run(const char* name, double inputRate, double outputRate, uint32_t channels,
+         PolyphaseResampler::Quality quality, bool adaptive) {
+    const uint32_t blockFrames = 512;
+    const uint32_t totalFrames = static_cast<uint32_t>(inputRate * 10);
+
+    PolyphaseResampler resampler;
+    bool configured = adaptive
+        ? resampler.ConfigureAdaptive(inputRate, outputRate, channels, blockFrames, quality)
+        : resampler.Configure(inputRate, outputRate, channels, blockFrames, quality);
+    if (!configured) {
+        std::printf("❌ %s: configuration rejected\n", name);
+        return;
+    }
+
+    std::vector<std::vector<float>> input(channels, std::vector<float>(blockFrames));
+    std::vector<std::vector<float>> output(channels, std::vector<float>(resampler.MaxOutputFrames(blockFrames)));
+    uint32_t seed = 1;
+    for (auto& channel : input) {
+        for (float& sample : channel) {
+            seed = seed * 1664525u + 1013904223u;
+            sample = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+        }
+    }
+    std::vector<const float*> in;
+    std::vector<float*> out;
+    for (uint32_t c = 0; c < channels; ++c) {
+        in.push_back(input[c].data());
+        out.push_back(output[c].data());
+    }
+
+    uint64_t produced = 0;
+    double seconds = Prezefren::Test::BestTime(5, [&] {
+        resampler.Reset();
+        produced = 0;
+        for (uint32_t done = 0; done < totalFrames; done += blockFrames) {
+            produced += resampler.Process(in.data(), blockFrames, out.data(), static_cast<uint32_t>(output[0].size()));
+        }
+    });
+
+    double audioSeconds = static_cast<double>(totalFrames) / inputRate;
+    std::printf("%-36s %4u taps  %8.1fx real time  %6.1f ns/output frame\n", name, resampler.GetTapsPerPhase(),
+                audioSeconds / seconds, seconds * 1e9 / static_cast<double>(produced));
+}
+
+} // namespace
+
+int main() {
+    using Quality = PolyphaseResampler::Quality;
+    std::printf("Polyphase resampler, 512-frame blocks, best of 5 x 10 s\n\n");
+    Run("48k -> 16k mono (low)", 48000, 16000, 1, Quality::Low, false);
+    Run("48k -> 16k mono (medium)", 48000, 16000, 1, Quality::Medium, false);
+    Run("48k -> 16k mono (high)", 48000, 16000, 1, Quality::High, false);
+    Run("48k -> 16k stereo (medium)", 48000, 16000, 2, Quality::Medium, false);
+    Run("44.1k -> 16k mono (medium)", 44100, 16000, 1, Quality::Medium, false);
+    Run("44.1k -> 48k stereo (medium)", 44100, 48000, 2, Quality::Medium, false);
+    Run("48k -> 16k mono adaptive (medium)", 48000, 16000, 1, Quality::Medium, true);
+    Run("48k -> 48k stereo adaptive (medium)", 48000, 48000, 2, Quality::Medium, true);
+    return 0;
+}
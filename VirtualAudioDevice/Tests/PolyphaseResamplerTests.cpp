@@ -0,0 +1,155 @@
+#include "PolyphaseResampler.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using Prezefren::PolyphaseResampler;
+using Prezefren::Test::Check;
+
+namespace {
+
+std::vector<float> Sine(double rate, double frequency, double amplitude, uint32_t frames) {
+    std::vector<float> samples(frames);
+    for (uint32_t i = 0; i < frames; ++i) {
+        samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / rate));
+    }
+    return samples;
+}
+
+// Feeds the input through in blocks cycling over blockSizes, the way the tap delivers it
+std::vector<float> Resample(PolyphaseResampler& resampler, const std::vector<float>& input,
+                            const std::vector<uint32_t>& blockSizes) {
+    std::vector<float> output;
+    std::vector<float> block(resampler.MaxOutputFrames(*std::max_element(blockSizes.begin(), blockSizes.end())));
+    size_t offset = 0;
+    for (size_t i = 0; offset < input.size(); ++i) {
+        uint32_t frames = static_cast<uint32_t>(std::min<size_t>(blockSizes[i % blockSizes.size()], input.size() - offset));
+        const float* in[] = { input.data() + offset };
+        float* out[] = { block.data() };
+        uint32_t produced = resampler.Process(in, frames, out, static_cast<uint32_t>(block.size()));
+        output.insert(output.end(), block.begin(), block.begin() + produced);
+        offset += frames;
+    }
+    return output;
+}
+
+double Rms(const std::vector<float>& samples, size_t skip) {
+    double sum = 0.0;
+    for (size_t i = skip; i < samples.size(); ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return samples.size() > skip ? std::sqrt(sum / (samples.size() - skip)) : 0.0;
+}
+
+double GainDb(double inputRate, double outputRate, double frequency) {
+    PolyphaseResampler resampler;
+    resampler.Configure(inputRate, outputRate, 1, 512);
+    std::vector<float> output = Resample(resampler, Sine(inputRate, frequency, 0.5, static_cast<uint32_t>(inputRate)), { 512 });
+    return 20.0 * std::log10(Rms(output, output.size() / 4) / (0.5 / std::sqrt(2.0)));
+}
+
+void TestRatio() {
+    std::printf("\n📏 Ratio\n");
+    struct Case { double in; double out; uint32_t up; uint32_t down; };
+    for (const Case& c : { Case{ 48000, 16000, 1, 3 }, Case{ 44100, 16000, 160, 441 }, Case{ 16000, 48000, 3, 1 } }) {
+        PolyphaseResampler resampler;
+        Check(resampler.Configure(c.in, c.out, 1, 1024), "Configure accepts the rate pair", c.in);
+        Check(resampler.GetUpFactor() == c.up && resampler.GetDownFactor() == c.down,
+              "Ratio reduces to L/M", resampler.GetUpFactor());
+
+        // Ten seconds, in irregular block sizes: output count must track the ratio exactly
+        std::vector<float> input = Sine(c.in, 440.0, 0.5, static_cast<uint32_t>(c.in * 10));
+        std::vector<float> chunked = Resample(resampler, input, { 512, 37, 1024, 441, 1 });
+        double expected = input.size() * c.out / c.in;
+        Check(std::fabs(chunked.size() - expected) <= 1.0, "Output frames match the ratio", chunked.size() - expected);
+
+        // Block boundaries must not change the signal
+        resampler.Reset();
+        std::vector<float> whole = Resample(resampler, input, { 1024 });
+        double difference = whole.size() == chunked.size() ? 0.0 : 1.0;
+        for (size_t i = 0; i < std::min(whole.size(), chunked.size()); ++i) {
+            difference = std::max(difference, static_cast<double>(std::fabs(whole[i] - chunked[i])));
+        }
+        Check(difference < 1e-6, "Chunked output equals single-block output", difference);
+    }
+
+    PolyphaseResampler rejected;
+    Check(!rejected.Configure(48000, 44101, 1, 512), "Ratios needing more than kMaxPhases are rejected", 44101);
+
+    // Adaptive mode: the trimmed step has to show up in the output count
+    PolyphaseResampler adaptive;
+    adaptive.ConfigureAdaptive(48000, 16000, 1, 512);
+    adaptive.SetRatioAdjustment(1.002);
+    std::vector<float> input = Sine(48000, 440.0, 0.5, 480000);
+    std::vector<float> output = Resample(adaptive, input, { 512, 100 });
+    double expected = input.size() / (3.0 * 1.002);
+    Check(std::fabs(output.size() - expected) <= 2.0, "Adaptive output follows the adjusted ratio", output.size() - expected);
+
+    adaptive.SetRatioAdjustment(1.1);
+    Check(adaptive.GetRatioAdjustment() == 1.0 + PolyphaseResampler::kMaxRatioAdjustment,
+          "Ratio adjustment is clamped", adaptive.GetRatioAdjustment());
+}
+
+// Output n has to be the input signal sampled at GetNextOutputPosition() + n * GetInputStep()
+void CheckDelay(PolyphaseResampler& resampler, double inputRate, const char* what) {
+    const double frequency = 440.0;
+    double start = resampler.GetNextOutputPosition();
+    double step = resampler.GetInputStep();
+    std::vector<float> output = Resample(resampler, Sine(inputRate, frequency, 0.5, static_cast<uint32_t>(inputRate)), { 480 });
+
+    // Skip the filter warm-up, where the history is still zeros
+    size_t skip = static_cast<size_t>(std::ceil(2.0 * resampler.GetDelayInputFrames() / step)) + 1;
+    double error = 0.0;
+    for (size_t n = skip; n < output.size(); ++n) {
+        double expected = 0.5 * std::sin(2.0 * M_PI * frequency * (start + n * step) / inputRate);
+        error = std::max(error, std::fabs(output[n] - expected));
+    }
+    Check(error < 5e-3, what, error);
+}
+
+void TestDelay() {
+    std::printf("\n⏱️ Delay\n");
+    PolyphaseResampler fixed;
+    fixed.Configure(48000, 16000, 1, 512);
+    Check(fixed.GetNextOutputPosition() == -fixed.GetDelayInputFrames(), "First output sits one group delay back",
+          fixed.GetDelayInputFrames());
+    CheckDelay(fixed, 48000, "48k -> 16k output lines up with the reported delay");
+
+    PolyphaseResampler fractional;
+    fractional.Configure(44100, 16000, 1, 512);
+    CheckDelay(fractional, 44100, "44.1k -> 16k output lines up with the reported delay");
+
+    PolyphaseResampler adaptive;
+    adaptive.ConfigureAdaptive(48000, 16000, 1, 512);
+    CheckDelay(adaptive, 48000, "Adaptive output lines up with the reported delay");
+
+    PolyphaseResampler passthrough;
+    passthrough.Configure(16000, 16000, 1, 512);
+    Check(passthrough.IsPassthrough() && passthrough.GetDelayInputFrames() == 0.0, "Equal rates pass through without delay", 0.0);
+}
+
+void TestPassband() {
+    std::printf("\n📶 Passband\n");
+    for (double frequency : { 100.0, 1000.0, 3000.0 }) {
+        double gain = GainDb(48000, 16000, frequency);
+        Check(std::fabs(gain) < 0.5, "48k -> 16k passband gain within 0.5 dB", gain);
+    }
+    double edge = GainDb(44100, 16000, 3000.0);
+    Check(std::fabs(edge) < 0.5, "44.1k -> 16k passband gain within 0.5 dB at 3 kHz", edge);
+
+    // Above the output Nyquist: would alias into the speech band, must be rejected
+    for (double frequency : { 12000.0, 16000.0 }) {
+        double gain = GainDb(48000, 16000, frequency);
+        Check(gain < -60.0, "48k -> 16k stopband attenuated by at least 60 dB", gain);
+    }
+}
+
+} // namespace
+
+int main() {
+    TestRatio();
+    TestDelay();
+    TestPassband();
+    return Prezefren::Test::Finish("PolyphaseResamplerTests");
+}
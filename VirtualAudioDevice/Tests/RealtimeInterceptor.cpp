@@ -0,0 +1,131 @@
+#include "RealtimeInterceptor.h"
+#include <cstddef>
+#include <dlfcn.h>
+#include <pthread.h>
+
+// The allocator is replaced outright (malloc and friends forward to glibc's own
+// entry points), the lock functions are forwarded to the next definition found by
+// the dynamic linker. Both only count while the calling thread is watched.
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace {
+
+thread_local bool watching = false;
+thread_local uint64_t allocations = 0;
+thread_local uint64_t locks = 0;
+
+void CountAllocation() {
+    if (watching) {
+        ++allocations;
+    }
+}
+
+void CountLock() {
+    if (watching) {
+        ++locks;
+    }
+}
+
+template <typename Function>
+Function Next(const char* name) {
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+using MutexFunction = int (*)(pthread_mutex_t*);
+using RwlockFunction = int (*)(pthread_rwlock_t*);
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    CountAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    CountAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    CountAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    CountAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    CountAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) {
+    CountAllocation();
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer ? 0 : 12;   // ENOMEM
+}
+
+void free(void* pointer) {
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    static const MutexFunction next = Next<MutexFunction>("pthread_mutex_lock");
+    CountLock();
+    return next(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex) {
+    static const MutexFunction next = Next<MutexFunction>("pthread_mutex_trylock");
+    CountLock();
+    return next(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock) {
+    static const RwlockFunction next = Next<RwlockFunction>("pthread_rwlock_rdlock");
+    CountLock();
+    return next(rwlock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock) {
+    static const RwlockFunction next = Next<RwlockFunction>("pthread_rwlock_wrlock");
+    CountLock();
+    return next(rwlock);
+}
+
+} // extern "C"
+
+namespace Prezefren {
+namespace Test {
+
+RealtimeWatch::RealtimeWatch() {
+    allocations = 0;
+    locks = 0;
+    watching = true;
+}
+
+RealtimeWatch::~RealtimeWatch() {
+    watching = false;
+}
+
+uint64_t RealtimeWatch::Allocations() const {
+    return allocations;
+}
+
+uint64_t RealtimeWatch::Locks() const {
+    return locks;
+}
+
+} // namespace Test
+} // namespace Prezefren
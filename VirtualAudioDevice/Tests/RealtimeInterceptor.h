@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Prezefren {
+namespace Test {
+
+/**
+ * @brief Counts heap allocations and lock acquisitions on the calling thread
+ *
+ * While a watch is alive, every malloc-family call and every pthread mutex or
+ * rwlock acquisition made by the thread that created it is counted. Other threads
+ * are not watched. The interceptor interposes the libc symbols, so it needs an ELF
+ * platform with glibc.
+ */
+class RealtimeWatch {
+public:
+    RealtimeWatch();
+    ~RealtimeWatch();
+
+    RealtimeWatch(const RealtimeWatch&) = delete;
+    RealtimeWatch& operator=(const RealtimeWatch&) = delete;
+
+    uint64_t Allocations() const;
+    uint64_t Locks() const;
+};
+
+} // namespace Test
+} // namespace Prezefren
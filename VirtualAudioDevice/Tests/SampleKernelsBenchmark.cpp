@@ -0,0 +1,127 @@
+#include "SampleKernels.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using Prezefren::SampleKernels;
+using Prezefren::SampleLayout;
+
+namespace {
+
+const uint32_t kFrames = 512;
+const int kBlocks = 2000;
+
+struct Buffers {
+    std::vector<std::vector<uint8_t>> storage;
+    std::vector<void*> pointers;
+
+    explicit Buffers(const SampleLayout& layout) {
+        for (uint32_t b = 0; b < layout.BufferCount(); ++b) {
+            storage.emplace_back(static_cast<size_t>(kFrames) * layout.BytesPerFrame());
+            pointers.push_back(storage.back().data());
+        }
+    }
+};
+
+struct Planar {
+    std::vector<std::vector<float>> storage;
+    std::vector<float*> pointers;
+
+    explicit Planar(uint32_t channels) : storage(channels, std::vector<float>(kFrames)) {
+        for (auto& channel : storage) {
+            pointers.push_back(channel.data());
+        }
+    }
+};
+
+const char* Describe(const SampleLayout& layout, char* text, size_t size) {
+    std::snprintf(text, size, "%s %u ch %s", layout.type == SampleLayout::Type::Int16 ? "int16  " : "float32",
+                  layout.channels, layout.interleaved ? "interleaved" : "planar     ");
+    return text;
+}
+
+/**
+ * @brief Times the selected and generic kernels for one layout, both directions
+ * @return false if the two disagree on the converted samples
+ */
+bool Run(const SampleLayout& layout) {
+    Planar source(layout.channels);
+    uint32_t seed = 1;
+    for (auto& channel : source.storage) {
+        for (float& sample : channel) {
+            seed = seed * 1664525u + 1013904223u;
+            sample = static_cast<float>(seed >> 8) / 16777216.0f - 0.5f;
+        }
+    }
+
+    Buffers specializedBuffers(layout);
+    Buffers genericBuffers(layout);
+    SampleKernels::WriteKernel write = SampleKernels::SelectWrite(layout);
+    SampleKernels::ReadKernel read = SampleKernels::SelectRead(layout);
+
+    double specializedWrite = Prezefren::Test::BestTime(5, [&] {
+        for (int i = 0; i < kBlocks; ++i) {
+            write(source.pointers.data(), layout.channels, kFrames, specializedBuffers.pointers.data());
+        }
+    });
+    double genericWrite = Prezefren::Test::BestTime(5, [&] {
+        for (int i = 0; i < kBlocks; ++i) {
+            SampleKernels::GenericWrite(layout, source.pointers.data(), kFrames, genericBuffers.pointers.data());
+        }
+    });
+
+    Planar specializedPlanar(layout.channels);
+    Planar genericPlanar(layout.channels);
+    const void* const* input = specializedBuffers.pointers.data();
+    double specializedRead = Prezefren::Test::BestTime(5, [&] {
+        for (int i = 0; i < kBlocks; ++i) {
+            read(input, layout.channels, 0, kFrames, specializedPlanar.pointers.data());
+        }
+    });
+    double genericRead = Prezefren::Test::BestTime(5, [&] {
+        for (int i = 0; i < kBlocks; ++i) {
+            SampleKernels::GenericRead(layout, input, 0, kFrames, genericPlanar.pointers.data());
+        }
+    });
+
+    bool matches = true;
+    for (uint32_t b = 0; b < layout.BufferCount(); ++b) {
+        matches = matches && specializedBuffers.storage[b] == genericBuffers.storage[b];
+    }
+    for (uint32_t c = 0; c < layout.channels; ++c) {
+        matches = matches && specializedPlanar.storage[c] == genericPlanar.storage[c];
+    }
+
+    char text[64];
+    double samples = static_cast<double>(kFrames) * kBlocks * layout.channels;
+    std::printf("%s  write %6.2f / %6.2f ns/sample (%4.1fx)   read %6.2f / %6.2f ns/sample (%4.1fx)%s\n",
+                Describe(layout, text, sizeof(text)),
+                specializedWrite * 1e9 / samples, genericWrite * 1e9 / samples, genericWrite / specializedWrite,
+                specializedRead * 1e9 / samples, genericRead * 1e9 / samples, genericRead / specializedRead,
+                matches ? "" : "   ❌ output differs from generic");
+    return matches;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Sample kernels, %u-frame blocks: specialized / generic, best of 5 x %d blocks\n\n", kFrames, kBlocks);
+
+    bool ok = true;
+    for (SampleLayout::Type type : { SampleLayout::Type::Float32, SampleLayout::Type::Int16 }) {
+        for (uint32_t channels : { 1u, 2u, 6u }) {
+            for (bool interleaved : { true, false }) {
+                if (channels == 1 && !interleaved) {
+                    continue;    // Same layout as mono interleaved
+                }
+                SampleLayout layout;
+                layout.type = type;
+                layout.channels = channels;
+                layout.interleaved = interleaved;
+                ok = Run(layout) && ok;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SharedAudioRing.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace Prezefren {
+namespace Benchmark {
+
+// What SharedAudioRingProducer and SharedAudioRingConsumer agree on
+const char* const kDeviceUid = "com.prezefren.benchmark.sharedring";
+const uint32_t kChannels = 2;
+const uint32_t kCapacityFrames = 16384;
+const double kSampleRate = 48000.0;
+
+/**
+ * @brief Host time in nanoseconds, comparable between the two processes
+ */
+inline uint64_t HostTime() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Sample the producer writes at a frame position: exact in float32, wraps at 2^24
+ */
+inline float RampSample(uint64_t position) {
+    return static_cast<float>(position & 0xFFFFFF);
+}
+
+} // namespace Benchmark
+} // namespace Prezefren
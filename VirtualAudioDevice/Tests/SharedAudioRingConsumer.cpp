@@ -0,0 +1,79 @@
+// Consumer half of the shared ring benchmark: attaches to SharedAudioRingProducer's
+// ring, reads in place the way the plugin's shared feed does, checks every frame and
+// reports how long the oldest readable frame had waited since it was written.
+//
+// Usage: SharedAudioRingConsumer [attach timeout seconds=10]
+// Exits 1 if no producer appeared or any frame arrived wrong.
+
+#include "SharedAudioRingBenchmark.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Prezefren::SharedAudioRing;
+using namespace Prezefren::Benchmark;
+
+int main(int argc, char** argv) {
+    const double timeout = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const std::string name = SharedAudioRing::NameFor(kDeviceUid);
+
+    std::unique_ptr<SharedAudioRing> ring;
+    const uint64_t deadline = HostTime() + static_cast<uint64_t>(timeout * 1.0e9);
+    while (!(ring = SharedAudioRing::Open(name, SharedAudioRing::ExpectedProducer()))) {
+        if (HostTime() > deadline) {
+            std::printf("❌ consumer: no producer ring %s\n", name.c_str());
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+    uint64_t frames = 0;
+    uint64_t wakes = 0;
+    uint64_t mismatches = 0;
+    uint64_t gaps = 0;
+    double expected = -1.0;
+    while (!ring->IsClosed() || ring->Wait(0)) {
+        if (!ring->Wait(100)) {
+            continue;
+        }
+        ++wakes;
+        SharedAudioRing::Region region;
+        uint32_t available = ring->Peek(region);
+        if (available == 0) {
+            continue;
+        }
+        if (region.hostTime != 0) {
+            latencies.push_back((HostTime() - region.hostTime) / 1000.0);
+        }
+
+        double sampleTime = region.sampleTime;
+        if (expected >= 0.0 && sampleTime != expected) {
+            ++gaps;
+        }
+        for (int run = 0; run < 2; ++run) {
+            for (uint32_t f = 0; f < region.frames[run]; ++f, sampleTime += 1.0) {
+                const float* frame = region.data[run] + static_cast<size_t>(f) * kChannels;
+                if (frame[0] != RampSample(static_cast<uint64_t>(sampleTime)) || frame[1] != -frame[0]) {
+                    ++mismatches;
+                }
+            }
+        }
+        expected = sampleTime;
+        ring->Consume(available);
+        frames += available;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    std::printf("consumer: %llu frames in %llu wakes, %llu mismatched, %llu timeline gaps\n",
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(wakes),
+                static_cast<unsigned long long>(mismatches), static_cast<unsigned long long>(gaps));
+    std::printf("cross-process latency of the oldest frame: p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                percentile(0.5), percentile(0.99), percentile(1.0));
+    return frames > 0 && mismatches == 0 ? 0 : 1;
+}
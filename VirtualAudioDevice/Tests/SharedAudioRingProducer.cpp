@@ -0,0 +1,72 @@
+// Producer half of the shared ring benchmark: writes a ramp into a SharedAudioRing
+// for SharedAudioRingConsumer, running as another process, to read.
+//
+// Usage (start the consumer first, or within a second):
+//   SharedAudioRingProducer [seconds=10] [paced|max]
+//   paced: 256-frame blocks at 48 kHz, as the capture tap delivers them (latency)
+//   max:   1024-frame blocks as fast as the consumer keeps up (throughput; the
+//          consumer's latencies are then meaningless, since the ring extrapolates
+//          host times at the nominal rate)
+
+#include "SharedAudioRingBenchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using Prezefren::SharedAudioRing;
+using namespace Prezefren::Benchmark;
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const bool paced = argc <= 2 || std::strcmp(argv[2], "max") != 0;
+    const uint32_t blockFrames = paced ? 256 : 1024;
+
+    std::unique_ptr<SharedAudioRing> ring = SharedAudioRing::Create(
+        SharedAudioRing::NameFor(kDeviceUid), kChannels, kCapacityFrames, kSampleRate, 1.0e9);
+    if (!ring) {
+        std::perror("❌ SharedAudioRing::Create");
+        return 1;
+    }
+
+    // Left carries the frame position, right its negation: the consumer checks both
+    std::vector<float> left(blockFrames);
+    std::vector<float> right(blockFrames);
+    const float* planar[] = { left.data(), right.data() };
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));   // Consumer attaches
+    const uint64_t start = HostTime();
+    auto next = std::chrono::steady_clock::now();
+    const auto period = std::chrono::nanoseconds(static_cast<int64_t>(blockFrames * 1.0e9 / kSampleRate));
+    uint64_t position = 0;
+    while (HostTime() - start < seconds * 1.0e9) {
+        for (uint32_t f = 0; f < blockFrames; ++f) {
+            left[f] = RampSample(position + f);
+            right[f] = -left[f];
+        }
+        uint32_t written = ring->Write(planar, kChannels, blockFrames, static_cast<double>(position), HostTime());
+        // Paced, a full ring drops frames as it would in the app; flat out, wait for room
+        while (!paced && written < blockFrames) {
+            std::this_thread::yield();
+            const float* rest[] = { left.data() + written, right.data() + written };
+            written += ring->Write(rest, kChannels, blockFrames - written, static_cast<double>(position + written),
+                                   HostTime());
+        }
+        position += blockFrames;
+        if (paced) {
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    const double elapsed = (HostTime() - start) / 1.0e9;
+    SharedAudioRing::Statistics stats = ring->GetStatistics();
+    std::printf("producer: %llu frames in %.2f s = %.2f Mframes/s (%.0fx real time), %llu %s\n",
+                static_cast<unsigned long long>(stats.framesWritten), elapsed, stats.framesWritten / elapsed / 1.0e6,
+                stats.framesWritten / elapsed / kSampleRate, static_cast<unsigned long long>(stats.droppedFrames),
+                paced ? "dropped" : "retried on a full ring");
+
+    // Let the consumer drain before closing the segment
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    return 0;
+}
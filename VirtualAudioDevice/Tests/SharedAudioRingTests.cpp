@@ -0,0 +1,107 @@
+#include "SharedAudioRing.h"
+#include "TestSupport.h"
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Prezefren::SharedAudioRing;
+using Prezefren::Test::Check;
+
+namespace {
+
+// Unique per run, so concurrent test runs and leftovers do not collide
+std::string TestName() {
+    return SharedAudioRing::NameFor("com.prezefren.test.sharedring." + std::to_string(getpid()));
+}
+
+bool Stat(const std::string& name, struct stat& info) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fstat(fd, &info) == 0;
+    close(fd);
+    return ok;
+}
+
+void TestAccess() {
+    std::printf("\n🔒 Access\n");
+    const std::string name = TestName();
+    std::unique_ptr<SharedAudioRing> producer = SharedAudioRing::Create(name, 2, 1024, 48000.0, 1.0e9);
+    Check(producer != nullptr, "Producer creates the segment", 0);
+    if (!producer) {
+        return;
+    }
+
+    struct stat info;
+    Check(Stat(name, info), "Segment exists under its name", 0);
+    Check((info.st_mode & 0777) == 0660, "Segment is owner and group only", info.st_mode & 0777);
+    Check(info.st_uid == geteuid(), "Segment belongs to the producer's user", info.st_uid);
+    Check(info.st_gid == SharedAudioRing::ConsumerGroup(), "Segment belongs to the consumer's group", info.st_gid);
+
+    Check(SharedAudioRing::Open(name, geteuid() + 1) == nullptr, "Consumer rejects another user's segment", geteuid() + 1);
+    std::unique_ptr<SharedAudioRing> consumer = SharedAudioRing::Open(name, SharedAudioRing::ExpectedProducer());
+    Check(consumer != nullptr, "Consumer opens the expected producer's segment", SharedAudioRing::ExpectedProducer());
+
+    // A segment anyone can write may carry anything: refuse it even from the right owner
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    fchmod(fd, 0666);
+    close(fd);
+    Check(SharedAudioRing::Open(name, geteuid()) == nullptr, "Consumer rejects a world-accessible segment", 0666);
+
+    producer.reset();
+    Check(!Stat(name, info), "Producer unlinks the segment when destroyed", 0);
+    Check(consumer && consumer->IsClosed(), "Consumer sees the producer close", 0);
+}
+
+void TestTransfer() {
+    std::printf("\n🔁 Transfer\n");
+    const std::string name = TestName();
+    std::unique_ptr<SharedAudioRing> producer = SharedAudioRing::Create(name, 2, 1000, 48000.0, 1.0e9);
+    std::unique_ptr<SharedAudioRing> consumer = SharedAudioRing::Open(name, geteuid());
+    if (!producer || !consumer) {
+        Check(false, "Ring pair opens", 0);
+        return;
+    }
+    Check(producer->GetCapacity() == 1024, "Capacity rounds up to a power of two", producer->GetCapacity());
+
+    float left[300];
+    float right[300];
+    for (int i = 0; i < 300; ++i) {
+        left[i] = static_cast<float>(i);
+        right[i] = -static_cast<float>(i);
+    }
+    const float* planar[] = { left, right };
+    uint32_t written = 0;
+    for (int block = 0; block < 4; ++block) {
+        written += producer->Write(planar, 2, 300, block * 300.0, 1000000 + block);
+    }
+    Check(written == 1024, "A full ring accepts up to its capacity", written);
+    Check(producer->GetStatistics().droppedFrames == 176, "The rest is dropped and counted",
+          producer->GetStatistics().droppedFrames);
+
+    SharedAudioRing::Region region;
+    uint32_t available = consumer->Peek(region);
+    bool intact = available == 1024 && region.frames[0] + region.frames[1] == available;
+    for (uint32_t f = 0; intact && f < region.frames[0]; ++f) {
+        float expected = static_cast<float>(f % 300);
+        intact = region.data[0][f * 2] == expected && region.data[0][f * 2 + 1] == -expected;
+    }
+    Check(intact, "Consumer reads the frames in place, interleaved", available);
+    consumer->Consume(available);
+    Check(consumer->GetStatistics().bufferedFrames == 0, "Consume releases them", consumer->GetStatistics().bufferedFrames);
+
+    // A restarted producer retires the old segment: its consumer must move over
+    std::unique_ptr<SharedAudioRing> successor = SharedAudioRing::Create(name, 2, 1000, 48000.0, 1.0e9);
+    Check(successor != nullptr && consumer->IsClosed(), "A new producer closes the segment it replaces", 0);
+}
+
+} // namespace
+
+int main() {
+    TestAccess();
+    TestTransfer();
+    return Prezefren::Test::Finish("SharedAudioRingTests");
+}
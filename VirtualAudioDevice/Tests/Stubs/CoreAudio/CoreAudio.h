@@ -0,0 +1,15 @@
+#pragma once
+
+// Test stub: the HAL error codes on top of the shared types
+
+#include <CoreAudio/CoreAudioTypes.h>
+#include <CoreFoundation/CoreFoundation.h>
+#include <cstdlib>
+
+enum {
+    kAudioHardwareUnspecifiedError = 0x77686174,    // 'what'
+    kAudioHardwareUnsupportedOperationError = 0x756E6F70,    // 'unop'
+    kAudioHardwareBadObjectError = 0x216F626A,    // '!obj'
+    kAudioHardwareIllegalOperationError = 0x6E6F7065,    // 'nope'
+    kAudioHardwareNoMemoryError = 0x216D656D    // '!mem'
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+// Test stub: the CoreAudio types and constants the device's IO path uses, with the
+// framework's layouts, so VirtualDevice builds and runs without macOS.
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint8_t Boolean;
+typedef int16_t SInt16;
+typedef int32_t SInt32;
+typedef uint32_t UInt32;
+typedef uint64_t UInt64;
+typedef float Float32;
+typedef double Float64;
+typedef SInt32 OSStatus;
+
+struct AudioBuffer {
+    UInt32 mNumberChannels;
+    UInt32 mDataByteSize;
+    void* mData;
+};
+
+struct AudioBufferList {
+    UInt32 mNumberBuffers;
+    AudioBuffer mBuffers[1];    // Variable length, as in CoreAudio
+};
+
+struct SMPTETime {
+    SInt16 mSubframes;
+    SInt16 mSubframeDivisor;
+    UInt32 mCounter;
+    UInt32 mType;
+    UInt32 mFlags;
+    SInt16 mHours;
+    SInt16 mMinutes;
+    SInt16 mSeconds;
+    SInt16 mFrames;
+};
+
+struct AudioTimeStamp {
+    Float64 mSampleTime;
+    UInt64 mHostTime;
+    Float64 mRateScalar;
+    UInt64 mWordClockTime;
+    SMPTETime mSMPTETime;
+    UInt32 mFlags;
+    UInt32 mReserved;
+};
+
+struct AudioValueRange {
+    Float64 mMinimum;
+    Float64 mMaximum;
+};
+
+enum {
+    kAudioTimeStampSampleTimeValid = 1u << 0,
+    kAudioTimeStampHostTimeValid = 1u << 1,
+    kAudioTimeStampRateScalarValid = 1u << 2
+};
+
+enum {
+    kAudioFormatLinearPCM = 0x6C70636D    // 'lpcm'
+};
+
+enum {
+    kAudioFormatFlagIsFloat = 1u << 0,
+    kAudioFormatFlagIsSignedInteger = 1u << 2,
+    kAudioFormatFlagIsPacked = 1u << 3,
+    kAudioFormatFlagIsNonInterleaved = 1u << 5
+};
+
+enum {
+    noErr = 0
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+// Test stub: CFString creation for the device's identification properties, and
+// NSLog, which the plugin's sources get from Foundation. The test build rewrites
+// their @"..." literals to plain C strings.
+
+#include <cstdint>
+#include <cstdio>
+
+typedef const struct __CFAllocator* CFAllocatorRef;
+typedef const struct __CFString* CFStringRef;
+typedef uint32_t CFStringEncoding;
+
+#define kCFAllocatorDefault static_cast<CFAllocatorRef>(nullptr)
+#define kCFStringEncodingUTF8 static_cast<CFStringEncoding>(0x08000100)
+
+inline CFStringRef CFStringCreateWithCString(CFAllocatorRef, const char*, CFStringEncoding) {
+    return nullptr;
+}
+
+#define NSLog(format, ...) std::fprintf(stderr, format "\n", ##__VA_ARGS__)
@@ -0,0 +1,114 @@
+#pragma once
+
+// Test stub: the slice of libASPL that VirtualDevice builds on. Objects are plain
+// data; tests drive the device's handlers directly, the way the HAL would.
+
+#include <CoreAudio/CoreAudio.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace aspl {
+
+struct Context {};
+
+enum class Direction {
+    Output,
+    Input
+};
+
+struct StreamFormat {
+    Float64 sampleRate;
+    UInt32 formatID;
+    UInt32 formatFlags;
+    UInt32 bytesPerPacket;
+    UInt32 framesPerPacket;
+    UInt32 bytesPerFrame;
+    UInt32 channelsPerFrame;
+    UInt32 bitsPerChannel;
+};
+
+class Stream {
+public:
+    Stream(std::shared_ptr<Context> context, Direction direction, const StreamFormat& format)
+        : direction_(direction), format_(format) {}
+
+    Direction GetDirection() const { return direction_; }
+    const StreamFormat& GetPhysicalFormat() const { return format_; }
+
+private:
+    Direction direction_;
+    StreamFormat format_;
+};
+
+class Client {
+public:
+    explicit Client(UInt32 clientID) : clientID_(clientID) {}
+
+    UInt32 GetClientID() const { return clientID_; }
+
+private:
+    UInt32 clientID_;
+};
+
+class ControlRequestHandler {
+public:
+    virtual ~ControlRequestHandler() = default;
+
+    virtual OSStatus OnAddClient(const std::shared_ptr<Client>& client) { return noErr; }
+    virtual void OnRemoveClient(const std::shared_ptr<Client>& client) {}
+};
+
+class IORequestHandler {
+public:
+    virtual ~IORequestHandler() = default;
+
+    virtual void OnReadClientInput(const std::shared_ptr<Client>& client,
+                                   const std::shared_ptr<Stream>& stream,
+                                   Float64 zeroTimestamp,
+                                   Float64 timestamp,
+                                   void* bytes,
+                                   UInt32 bytesCount) {}
+};
+
+class Device {
+public:
+    explicit Device(std::shared_ptr<Context> context) : context_(std::move(context)) {}
+    virtual ~Device() = default;
+
+    std::shared_ptr<Context> GetContext() const { return context_; }
+
+    void AddStream(std::shared_ptr<Stream> stream) { stream_ = std::move(stream); }
+    std::shared_ptr<Stream> GetStreamByIndex(UInt32 index) const { return index == 0 ? stream_ : nullptr; }
+
+    void SetControlHandler(std::shared_ptr<ControlRequestHandler> handler) { controlHandler_ = std::move(handler); }
+    void SetIOHandler(std::shared_ptr<IORequestHandler> handler) { ioHandler_ = std::move(handler); }
+    ControlRequestHandler* GetControlHandler() const { return controlHandler_.get(); }
+    IORequestHandler* GetIOHandler() const { return ioHandler_.get(); }
+
+    virtual OSStatus GetManufacturer(CFStringRef* outName) const { return noErr; }
+    virtual OSStatus GetModelName(CFStringRef* outName) const { return noErr; }
+    virtual OSStatus GetSerialNumber(CFStringRef* outName) const { return noErr; }
+    virtual OSStatus GetFirmwareVersion(CFStringRef* outName) const { return noErr; }
+    virtual OSStatus GetZeroTimeStampPeriod(UInt32* outPeriod) const { return noErr; }
+    virtual OSStatus GetIsRunning(Boolean* outIsRunning) const { return noErr; }
+    virtual OSStatus GetLatency(UInt32 inDirection, UInt32* outLatency) const { return noErr; }
+    virtual OSStatus GetSafetyOffset(UInt32 inDirection, UInt32* outOffset) const { return noErr; }
+    virtual OSStatus GetBufferFrameSize(UInt32* outFrames) const { return noErr; }
+    virtual OSStatus GetBufferFrameSizeRange(AudioValueRange* outRange) const { return noErr; }
+    virtual OSStatus GetStreamConfiguration(UInt32 inDirection, AudioBufferList** outBufferList) const { return noErr; }
+    virtual OSStatus StartIO() { return noErr; }
+    virtual OSStatus StopIO() { return noErr; }
+    virtual OSStatus GetCurrentTime(AudioTimeStamp* outTime) const { return noErr; }
+    virtual OSStatus GetZeroTimeStamp(Float64* outSampleTime, UInt64* outHostTime, UInt64* outSeed) const { return noErr; }
+
+private:
+    std::shared_ptr<Context> context_;
+    std::shared_ptr<Stream> stream_;
+    std::shared_ptr<ControlRequestHandler> controlHandler_;
+    std::shared_ptr<IORequestHandler> ioHandler_;
+};
+
+} // namespace aspl
@@ -0,0 +1,37 @@
+#pragma once
+
+// Test stub: host time in nanoseconds from the monotonic clock, unless a test has
+// set a timeline of its own
+
+#include <atomic>
+#include <cstdint>
+#include <time.h>
+
+struct mach_timebase_info_data_t {
+    uint32_t numer;
+    uint32_t denom;
+};
+
+inline int mach_timebase_info(mach_timebase_info_data_t* info) {
+    info->numer = 1;
+    info->denom = 1;
+    return 0;
+}
+
+/**
+ * @brief Host time returned by mach_absolute_time() while nonzero (tests only)
+ */
+inline std::atomic<uint64_t>& prezefren_test_host_time() {
+    static std::atomic<uint64_t> hostTime(0);
+    return hostTime;
+}
+
+inline uint64_t mach_absolute_time() {
+    uint64_t steered = prezefren_test_host_time().load(std::memory_order_relaxed);
+    if (steered != 0) {
+        return steered;
+    }
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
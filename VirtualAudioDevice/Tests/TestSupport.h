@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @brief Minimal check/report helpers shared by the portable test executables
+ *
+ * No framework: each test is a plain executable that prints one line per check and
+ * returns non-zero from main() if any check failed, which is all CTest needs.
+ */
+namespace Prezefren {
+namespace Test {
+
+inline int& FailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+inline bool Check(bool condition, const char* what, double value = 0.0) {
+    if (condition) {
+        std::printf("✅ %s (%g)\n", what, value);
+    } else {
+        std::printf("❌ %s (%g)\n", what, value);
+        ++FailureCount();
+    }
+    return condition;
+}
+
+inline int Finish(const char* suite) {
+    if (FailureCount() > 0) {
+        std::printf("❌ %s: %d check(s) failed\n", suite, FailureCount());
+        return 1;
+    }
+    std::printf("✅ %s: all checks passed\n", suite);
+    return 0;
+}
+
+/**
+ * @brief Best-of-N wall time of a callable, in seconds (benchmarks only)
+ */
+template <typename Function>
+double BestTime(int repetitions, Function&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = elapsed.count() < best ? elapsed.count() : best;
+    }
+    return best;
+}
+
+} // namespace Test
+} // namespace Prezefren
@@ -0,0 +1,153 @@
+#include "PrezefrenVirtualDevice.h"
+#include "RealtimeInterceptor.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <mach/mach_time.h>
+#include <mutex>
+#include <vector>
+
+using Prezefren::LatencyProfile;
+using Prezefren::Test::Check;
+using Prezefren::Test::RealtimeWatch;
+using Prezefren::VirtualDevice;
+
+namespace {
+
+const Float64 kSampleRate = 48000.0;
+const UInt32 kChannels = 2;
+const int kBlocks = 400;
+
+// Variable-length AudioBufferList, the way the splitter allocates them
+struct BufferList {
+    std::vector<uint8_t> storage;
+
+    explicit BufferList(UInt32 buffers)
+        : storage(offsetof(AudioBufferList, mBuffers) + sizeof(AudioBuffer) * buffers) {
+        list().mNumberBuffers = buffers;
+    }
+
+    AudioBufferList& list() { return *reinterpret_cast<AudioBufferList*>(storage.data()); }
+};
+
+struct Feed {
+    std::vector<std::vector<float>> planar;
+    std::vector<float> interleaved;
+    BufferList planarList;
+    BufferList interleavedList;
+
+    explicit Feed(UInt32 frames)
+        : planar(kChannels, std::vector<float>(frames)), interleaved(frames * kChannels),
+          planarList(kChannels), interleavedList(1) {
+        for (UInt32 i = 0; i < frames; ++i) {
+            for (UInt32 c = 0; c < kChannels; ++c) {
+                float sample = static_cast<float>(0.25 * std::sin(2.0 * M_PI * 440.0 * (c + 1) * i / kSampleRate));
+                planar[c][i] = sample;
+                interleaved[i * kChannels + c] = sample;
+            }
+        }
+        for (UInt32 c = 0; c < kChannels; ++c) {
+            planarList.list().mBuffers[c] = { 1, static_cast<UInt32>(frames * sizeof(float)), planar[c].data() };
+        }
+        interleavedList.list().mBuffers[0] = { kChannels, static_cast<UInt32>(interleaved.size() * sizeof(float)),
+                                             interleaved.data() };
+    }
+};
+
+AudioTimeStamp Timed(Float64 sampleTime) {
+    AudioTimeStamp timeStamp = {};
+    timeStamp.mFlags = kAudioTimeStampSampleTimeValid | kAudioTimeStampHostTimeValid;
+    timeStamp.mSampleTime = sampleTime;
+    timeStamp.mHostTime = mach_absolute_time();
+    return timeStamp;
+}
+
+void TestInterceptor() {
+    std::printf("\n🔎 Interceptor\n");
+    // Through volatile pointers, so the compiler cannot elide the calls
+    void* (*volatile allocate)(size_t) = std::malloc;
+    void (*volatile release)(void*) = std::free;
+    std::mutex mutex;
+
+    RealtimeWatch watch;
+    release(allocate(64));
+    mutex.lock();
+    mutex.unlock();
+    Check(watch.Allocations() == 1, "An allocation on the watched thread is counted", watch.Allocations());
+    Check(watch.Locks() == 1, "A mutex lock on the watched thread is counted", watch.Locks());
+}
+
+/**
+ * @brief One HAL IO cycle: the feed, a client read, and the clock queries the HAL makes
+ */
+void Cycle(VirtualDevice& device, const AudioBufferList& bufferList, Float64 sampleTime,
+           const std::shared_ptr<aspl::Client>& client, std::vector<float>& clientBuffer) {
+    device.FeedAudioData(bufferList, Timed(sampleTime));
+    device.GetIOHandler()->OnReadClientInput(client, device.GetStreamByIndex(0), 0.0, sampleTime,
+                                             clientBuffer.data(),
+                                             static_cast<UInt32>(clientBuffer.size() * sizeof(float)));
+    AudioTimeStamp now;
+    device.GetCurrentTime(&now);
+    Float64 zeroSampleTime;
+    UInt64 zeroHostTime;
+    UInt64 seed;
+    device.GetZeroTimeStamp(&zeroSampleTime, &zeroHostTime, &seed);
+    device.GetBufferedFrames();
+}
+
+void TestIOPath(const LatencyProfile& profile) {
+    std::printf("\n🎚️ IO path (%s)\n", profile.name);
+    const UInt32 frames = profile.ioBufferFrames;
+
+    // Control thread: everything that may allocate or lock happens here
+    VirtualDevice device(std::make_shared<aspl::Context>(), "IO Test", "com.prezefren.test.io", kSampleRate,
+                         kChannels, profile);
+    auto client = std::make_shared<aspl::Client>(1);
+    Check(device.GetControlHandler()->OnAddClient(client) == noErr, "Client registers", 1);
+    UInt64 callbacks = 0;
+    device.SetAudioCallback([&callbacks](const AudioBufferList&, const AudioTimeStamp&) { ++callbacks; });
+    device.StartIO();
+
+    Feed feed(frames);
+    std::vector<float> clientBuffer(frames * kChannels);
+    AudioBufferList empty = {};
+    double peak = 0.0;
+    UInt64 allocations;
+    UInt64 locks;
+    {
+        // IO thread: from the first buffer on, planar and interleaved feeds, reads and a reject
+        RealtimeWatch watch;
+        for (int block = 0; block < kBlocks; ++block) {
+            const AudioBufferList& bufferList = block % 2 ? feed.interleavedList.list() : feed.planarList.list();
+            Cycle(device, bufferList, static_cast<Float64>(block) * frames, client, clientBuffer);
+            for (float sample : clientBuffer) {
+                peak = std::max(peak, static_cast<double>(std::fabs(sample)));
+            }
+        }
+        device.FeedAudioData(empty, Timed(static_cast<Float64>(kBlocks) * frames));
+        allocations = watch.Allocations();
+        locks = watch.Locks();
+    }
+
+    Check(allocations == 0, "FeedAudioData and client reads do not allocate", allocations);
+    Check(locks == 0, "FeedAudioData and client reads take no locks", locks);
+    Check(callbacks == kBlocks, "Every accepted buffer reaches the audio callback", callbacks);
+    Check(device.GetStreamStatistics().framesWritten == static_cast<uint64_t>(kBlocks) * frames,
+          "Every accepted frame reaches the ring", device.GetStreamStatistics().framesWritten);
+    Check(peak > 0.2, "Clients read the fed audio", peak);
+    Check(device.GetIOErrorCount() == 1, "The malformed buffer is rejected and counted", device.GetIOErrorCount());
+    Check(device.GetCaptureLatency().measurements > 0, "Client reads are timed", device.GetCaptureLatency().measurements);
+
+    device.StopIO();
+    device.GetControlHandler()->OnRemoveClient(client);
+}
+
+} // namespace
+
+int main() {
+    TestInterceptor();
+    TestIOPath(LatencyProfile::LowLatency());
+    TestIOPath(LatencyProfile::Balanced());
+    return Prezefren::Test::Finish("VirtualDeviceIOTests");
+}
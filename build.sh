@@ -124,6 +124,16 @@ install_name_tool -change @rpath/libggml-blas.dylib @executable_path/libggml-bla
 # Copy model file to app bundle Resources (use multilingual model for language support)
 cp ggml-base.bin build/Prezefren.app/Contents/Resources/
 
+# Copy calibration clip and reference transcript used for quantized model calibration
+# (Harvard sentences list 1; the clip is spoken from the transcript unless a recording is provided)
+cp Resources/calibration_clip.txt build/Prezefren.app/Contents/Resources/
+if [ -f Resources/calibration_clip.wav ]; then
+    cp Resources/calibration_clip.wav build/Prezefren.app/Contents/Resources/
+else
+    say -f Resources/calibration_clip.txt -o build/Prezefren.app/Contents/Resources/calibration_clip.wav \
+        --file-format=WAVE --data-format=LEI16@16000 || echo "⚠️  Could not synthesize calibration clip - model calibration disabled"
+fi
+
 # Copy Python scripts to app bundle Resources
 mkdir -p build/Prezefren.app/Contents/Resources/Scripts
 cp Scripts/nllb_translator.py build/Prezefren.app/Contents/Resources/Scripts/
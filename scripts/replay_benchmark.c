@@ -0,0 +1,110 @@
+// Huge-page replay benchmark: decodes the same clip with huge pages off and on and prints the
+// decode throughput of both, so the effect of whisper_bridge_hugepage_mode can be measured.
+// Huge pages are only available on Linux; elsewhere both runs use normal pages.
+//
+// Build (from the repository root, after building Vendor/whisper.cpp):
+//   cc -O2 -I. -I Vendor/whisper.cpp/include -I Vendor/whisper.cpp/ggml/include
+//      scripts/replay_benchmark.c whisper_bridge.c
+//      -L Vendor/whisper.cpp/build/src -lwhisper -lpthread -o build/replay_benchmark
+//   (one command)
+//
+// Usage:
+//   build/replay_benchmark <model.bin> <clip.wav> [iterations=5] [hugepage_mode=2] [language=en]
+//   The clip must be 16 kHz mono 16-bit PCM (e.g. the bundled calibration_clip.wav).
+
+#include "whisper_bridge.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Reads a 16 kHz mono 16-bit PCM WAV into floats. Returns the sample count, 0 on failure.
+static int read_wav(const char* path, float** out_samples) {
+    *out_samples = NULL;
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    unsigned char header[12];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        fclose(file);
+        return 0;
+    }
+
+    int format_ok = 0;
+    int n_samples = 0;
+    unsigned char chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), file) == sizeof(chunk)) {
+        uint32_t size = (uint32_t)chunk[4] | ((uint32_t)chunk[5] << 8) | ((uint32_t)chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            unsigned char fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), file) != sizeof(fmt)) {
+                break;
+            }
+            uint16_t audio_format = (uint16_t)(fmt[0] | (fmt[1] << 8));
+            uint16_t channels = (uint16_t)(fmt[2] | (fmt[3] << 8));
+            uint32_t rate = (uint32_t)fmt[4] | ((uint32_t)fmt[5] << 8) | ((uint32_t)fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            uint16_t bits = (uint16_t)(fmt[14] | (fmt[15] << 8));
+            format_ok = audio_format == 1 && channels == 1 && rate == 16000 && bits == 16;
+            fseek(file, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0 && format_ok) {
+            int16_t* pcm = (int16_t*)malloc(size);
+            float* samples = (float*)malloc((size / 2) * sizeof(float));
+            if (pcm && samples && fread(pcm, 1, size, file) == size) {
+                n_samples = (int)(size / 2);
+                for (int i = 0; i < n_samples; ++i) {
+                    samples[i] = (float)pcm[i] / 32768.0f;
+                }
+                *out_samples = samples;
+                samples = NULL;
+            }
+            free(pcm);
+            free(samples);
+            break;
+        } else {
+            fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fclose(file);
+    return n_samples;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <model.bin> <clip.wav> [iterations=5] [hugepage_mode=2] [language=en]\n", argv[0]);
+        return 2;
+    }
+
+    const char* model_path = argv[1];
+    int iterations = argc > 3 ? atoi(argv[3]) : 5;
+    int hugepage_mode = argc > 4 ? atoi(argv[4]) : WHISPER_BRIDGE_HUGEPAGES_COLLAPSE;
+    const char* language = argc > 5 ? argv[5] : "en";
+
+    float* samples = NULL;
+    int n_samples = read_wav(argv[2], &samples);
+    if (n_samples == 0) {
+        fprintf(stderr, "❌ %s is not a 16 kHz mono 16-bit PCM WAV\n", argv[2]);
+        return 1;
+    }
+
+    double baseline = 0.0;
+    double huge = 0.0;
+    double hugepage_mb = 0.0;
+    if (whisper_bridge_replay_benchmark(model_path, samples, n_samples, language, WHISPER_BRIDGE_HUGEPAGES_OFF,
+                                        iterations, &baseline, NULL) != 0 ||
+        whisper_bridge_replay_benchmark(model_path, samples, n_samples, language, hugepage_mode,
+                                        iterations, &huge, &hugepage_mb) != 0) {
+        free(samples);
+        return 1;
+    }
+    free(samples);
+
+    printf("\nclip %.1fs, %d decodes per mode\n", n_samples / 16000.0, iterations);
+    printf("huge pages off:      %7.2fx real time\n", baseline);
+    printf("huge pages mode %d:   %7.2fx real time (%.1f MB huge-page backed)\n", hugepage_mode, huge, hugepage_mb);
+    printf("change:              %+6.1f%%\n", baseline > 0.0 ? (huge / baseline - 1.0) * 100.0 : 0.0);
+    return 0;
+}
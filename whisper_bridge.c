@@ -1,22 +1,98 @@
+#if !defined(__APPLE__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // sched_setaffinity, CPU_SET
+#endif
+
 #include "whisper_bridge.h"
 #include "Vendor/whisper.cpp/include/whisper.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#include <sys/qos.h>
+#include <sys/sysctl.h>
+#else
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+#endif
+
+// v1.2.0 ENHANCEMENT: Inference worker placement, carried by the thread that runs whisper_full
+typedef struct {
+    int configured;
+    int n_threads;
+    unsigned long long core_mask;
+    int nice_level;
+    int qos;
+    int reserved_core;
+} bridge_worker_config;
+
+// Written by whisper_bridge_configure_workers, read by every decode: only ever copied out under the lock
+static pthread_mutex_t g_worker_config_lock = PTHREAD_MUTEX_INITIALIZER;
+static bridge_worker_config g_worker_config = { 0, 4, 0, 0, WHISPER_BRIDGE_QOS_UNCHANGED, -1 };
+
+static bridge_worker_config bridge_get_worker_config(void);
+static int bridge_whisper_full(struct whisper_context* ctx, struct whisper_full_params params, const float* samples, int n_samples);
+
+// v1.2.0 ENHANCEMENT: Huge-page advice for buffers allocated inside whisper init
+typedef struct {
+    unsigned long start;
+    unsigned long end;
+} bridge_region;
+
+typedef struct {
+    bridge_region* items;
+    int count;
+} bridge_region_list;
+
+static void bridge_collect_anonymous_regions(bridge_region_list* list);
+static void bridge_advise_hugepages(const bridge_region_list* before, int mode, double* out_advised_mb, double* out_hugepage_mb);
 
 struct whisper_context* whisper_bridge_init_context(const char* model_path) {
+    return whisper_bridge_init_context_with_hugepages(model_path, WHISPER_BRIDGE_HUGEPAGES_OFF, NULL, NULL);
+}
+
+struct whisper_context* whisper_bridge_init_context_with_hugepages(const char* model_path, int hugepage_mode,
+                                                                   double* out_advised_mb, double* out_hugepage_mb) {
     printf("🎤 Real Whisper: Initializing with model: %s\n", model_path);
     
     struct whisper_context_params cparams = whisper_context_default_params();
     cparams.use_gpu = false; // Use CPU for compatibility
     
+    // Snapshot the anonymous mappings so the ones created by whisper init can be found afterwards
+    bridge_region_list regions_before = { NULL, 0 };
+    if (hugepage_mode != WHISPER_BRIDGE_HUGEPAGES_OFF) {
+        bridge_collect_anonymous_regions(&regions_before);
+    }
+    
     struct whisper_context* ctx = whisper_init_from_file_with_params(model_path, cparams);
     
     if (ctx == NULL) {
         printf("❌ Real Whisper: Failed to initialize context from %s\n", model_path);
+        free(regions_before.items);
         return NULL;
     }
     
+    double advised_mb = 0.0;
+    double hugepage_mb = 0.0;
+    if (hugepage_mode != WHISPER_BRIDGE_HUGEPAGES_OFF) {
+        bridge_advise_hugepages(&regions_before, hugepage_mode, &advised_mb, &hugepage_mb);
+        free(regions_before.items);
+    }
+    if (out_advised_mb) *out_advised_mb = advised_mb;
+    if (out_hugepage_mb) *out_hugepage_mb = hugepage_mb;
+    
     printf("✅ Real Whisper: Context initialized successfully\n");
     return ctx;
 }
@@ -61,10 +137,9 @@ char* whisper_bridge_transcribe_with_language(struct whisper_context* ctx, const
     wparams.no_context = true;
     wparams.single_segment = true;
     wparams.suppress_blank = true;
-    wparams.n_threads = 4; // Use more threads for medium model
     
     // Run transcription with error handling
-    int transcription_result = whisper_full(ctx, wparams, samples, n_samples);
+    int transcription_result = bridge_whisper_full(ctx, wparams, samples, n_samples);
     
     if (transcription_result != 0) {
         printf("❌ Real Whisper: Transcription failed with code %d\n", transcription_result);
@@ -163,10 +238,9 @@ whisper_timestamped_result* whisper_bridge_transcribe_with_timestamps(struct whi
     wparams.no_context = false; // Enable context for better accuracy
     wparams.single_segment = false; // Allow multiple segments for timestamp accuracy
     wparams.suppress_blank = true;
-    wparams.n_threads = 4;
     
     // Run transcription with error handling
-    int transcription_result = whisper_full(ctx, wparams, samples, n_samples);
+    int transcription_result = bridge_whisper_full(ctx, wparams, samples, n_samples);
     
     if (transcription_result != 0) {
         printf("❌ Real Whisper: Timestamped transcription failed with code %d\n", transcription_result);
@@ -312,4 +386,1134 @@ char* whisper_bridge_get_segment_text(struct whisper_context* ctx, int segment_i
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+// v1.2.0 ENHANCEMENT: Quantized model support
+int whisper_bridge_get_model_ftype(struct whisper_context* ctx) {
+    if (!ctx) {
+        return -1;
+    }
+    return whisper_model_ftype(ctx);
+}
+
+const char* whisper_bridge_get_model_ftype_name(struct whisper_context* ctx) {
+    switch (whisper_bridge_get_model_ftype(ctx)) {
+        case 0:  return "f32";
+        case 1:  return "f16";
+        case 2:  return "q4_0";
+        case 3:  return "q4_1";
+        case 7:  return "q8_0";
+        case 8:  return "q5_0";
+        case 9:  return "q5_1";
+        default: return "unknown";
+    }
+}
+
+// v1.2.0 ENHANCEMENT: Calibration helpers
+static double bridge_now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Current resident footprint of the process in bytes (0 if unavailable)
+static double bridge_resident_bytes(void) {
+#ifdef __APPLE__
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return (double)info.phys_footprint;
+    }
+    return 0.0;
+#else
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0.0;
+    }
+    long pages_total = 0;
+    long pages_resident = 0;
+    if (fscanf(statm, "%ld %ld", &pages_total, &pages_resident) != 2) {
+        pages_resident = 0;
+    }
+    fclose(statm);
+    return (double)pages_resident * (double)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// Lowercase, strip punctuation and split on whitespace. Returns word count;
+// *out_words points into *out_storage, both must be freed by the caller.
+static int bridge_split_words(const char* text, char*** out_words, char** out_storage) {
+    *out_words = NULL;
+    *out_storage = NULL;
+    if (!text) {
+        return 0;
+    }
+
+    size_t len = strlen(text);
+    char* storage = (char*)malloc(len + 1);
+    char** words = (char**)malloc((len / 2 + 1) * sizeof(char*));
+    if (!storage || !words) {
+        free(storage);
+        free(words);
+        return 0;
+    }
+
+    int n_words = 0;
+    size_t w = 0;
+    int in_word = 0;
+    for (size_t i = 0; i < len; ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (isspace(c)) {
+            if (in_word) {
+                storage[w++] = '\0';
+                in_word = 0;
+            }
+            continue;
+        }
+        if (c < 0x80 && ispunct(c) && c != '\'') {
+            continue;
+        }
+        if (!in_word) {
+            words[n_words++] = &storage[w];
+            in_word = 1;
+        }
+        storage[w++] = (char)tolower(c);
+    }
+    storage[w] = '\0';
+
+    *out_words = words;
+    *out_storage = storage;
+    return n_words;
+}
+
+float whisper_bridge_word_error_rate(const char* reference_text, const char* hypothesis_text) {
+    char** ref_words = NULL;
+    char** hyp_words = NULL;
+    char* ref_storage = NULL;
+    char* hyp_storage = NULL;
+
+    int n_ref = bridge_split_words(reference_text, &ref_words, &ref_storage);
+    int n_hyp = bridge_split_words(hypothesis_text, &hyp_words, &hyp_storage);
+
+    float wer = -1.0f;
+    if (n_ref == 0) {
+        wer = n_hyp == 0 ? 0.0f : 1.0f;
+    } else {
+        // Word-level Levenshtein distance with two rolling rows
+        int* prev = (int*)malloc((n_hyp + 1) * sizeof(int));
+        int* curr = (int*)malloc((n_hyp + 1) * sizeof(int));
+        if (prev && curr) {
+            for (int j = 0; j <= n_hyp; ++j) {
+                prev[j] = j;
+            }
+            for (int i = 1; i <= n_ref; ++i) {
+                curr[0] = i;
+                for (int j = 1; j <= n_hyp; ++j) {
+                    int substitution = prev[j - 1] + (strcmp(ref_words[i - 1], hyp_words[j - 1]) != 0);
+                    int deletion = prev[j] + 1;
+                    int insertion = curr[j - 1] + 1;
+                    int best = substitution < deletion ? substitution : deletion;
+                    curr[j] = best < insertion ? best : insertion;
+                }
+                int* tmp = prev;
+                prev = curr;
+                curr = tmp;
+            }
+            wer = (float)prev[n_hyp] / (float)n_ref;
+        }
+        free(prev);
+        free(curr);
+    }
+
+    free(ref_words);
+    free(ref_storage);
+    free(hyp_words);
+    free(hyp_storage);
+    return wer;
+}
+
+// v1.2.0 ENHANCEMENT: On-device speed/accuracy calibration run for one model variant
+int whisper_bridge_calibrate_model(const char* model_path, const float* samples, int n_samples, const char* language,
+                                   const char* reference_text, int hugepage_mode, float* out_rtf, double* out_peak_memory_mb,
+                                   float* out_wer, int* out_ftype, double* out_hugepage_mb) {
+    if (!model_path || !samples || n_samples <= 0) {
+        printf("❌ Calibration: Invalid parameters\n");
+        return -1;
+    }
+
+    double baseline_bytes = bridge_resident_bytes();
+
+    double hugepage_mb = 0.0;
+    struct whisper_context* ctx = whisper_bridge_init_context_with_hugepages(model_path, hugepage_mode, NULL, &hugepage_mb);
+    if (!ctx) {
+        return -2;
+    }
+
+    // Model weights and the KV/compute buffers are all allocated during init,
+    // so sampling after init and after decode captures the peak of the run.
+    double peak_bytes = bridge_resident_bytes();
+
+    double decode_start = bridge_now_seconds();
+    char* text = whisper_bridge_transcribe_with_language(ctx, samples, n_samples, language);
+    double decode_seconds = bridge_now_seconds() - decode_start;
+
+    double after_decode_bytes = bridge_resident_bytes();
+    if (after_decode_bytes > peak_bytes) {
+        peak_bytes = after_decode_bytes;
+    }
+
+    float audio_seconds = (float)n_samples / (float)WHISPER_SAMPLE_RATE;
+    float rtf = (float)(decode_seconds / audio_seconds);
+    float wer = (reference_text && reference_text[0] != '\0') ? whisper_bridge_word_error_rate(reference_text, text) : -1.0f;
+    int ftype = whisper_bridge_get_model_ftype(ctx);
+
+    printf("📊 Calibration: %s (%s) RTF=%.3f peak=%.1fMB WER=%.3f hugepages=%.1fMB\n",
+           model_path, whisper_bridge_get_model_ftype_name(ctx), rtf,
+           (peak_bytes - baseline_bytes) / (1024.0 * 1024.0), wer, hugepage_mb);
+
+    if (out_rtf) *out_rtf = rtf;
+    if (out_peak_memory_mb) *out_peak_memory_mb = (peak_bytes - baseline_bytes) / (1024.0 * 1024.0);
+    if (out_wer) *out_wer = wer;
+    if (out_ftype) *out_ftype = ftype;
+    if (out_hugepage_mb) *out_hugepage_mb = hugepage_mb;
+
+    int status = text ? 0 : -3;
+    free(text);
+    whisper_bridge_free_context(ctx);
+    return status;
+}
+
+// v1.2.0 ENHANCEMENT: Decode throughput replay (huge pages on vs off)
+int whisper_bridge_replay_benchmark(const char* model_path, const float* samples, int n_samples, const char* language,
+                                    int hugepage_mode, int iterations, double* out_throughput, double* out_hugepage_mb) {
+    if (!model_path || !samples || n_samples <= 0 || iterations <= 0) {
+        printf("❌ Replay: Invalid parameters\n");
+        return -1;
+    }
+
+    double hugepage_mb = 0.0;
+    struct whisper_context* ctx = whisper_bridge_init_context_with_hugepages(model_path, hugepage_mode, NULL, &hugepage_mb);
+    if (!ctx) {
+        return -2;
+    }
+
+    // The first decode faults in the weights and sizes the compute buffers; only steady state counts
+    free(whisper_bridge_transcribe_with_language(ctx, samples, n_samples, language));
+
+    double start = bridge_now_seconds();
+    for (int i = 0; i < iterations; ++i) {
+        free(whisper_bridge_transcribe_with_language(ctx, samples, n_samples, language));
+    }
+    double elapsed = bridge_now_seconds() - start;
+
+    double audio_seconds = (double)n_samples / WHISPER_SAMPLE_RATE * iterations;
+    double throughput = elapsed > 0.0 ? audio_seconds / elapsed : 0.0;
+    printf("📊 Replay: %s hugepage_mode=%d %.2fx real time over %d decodes (hugepages=%.1fMB)\n",
+           model_path, hugepage_mode, throughput, iterations, hugepage_mb);
+
+    if (out_throughput) *out_throughput = throughput;
+    if (out_hugepage_mb) *out_hugepage_mb = hugepage_mb;
+
+    whisper_bridge_free_context(ctx);
+    return 0;
+}
+
+// v1.2.0 ENHANCEMENT: CPU topology detection
+#ifndef __APPLE__
+// Parses a sysfs CPU list such as "0-7,16-19" into a bit mask
+static unsigned long long bridge_parse_cpu_list(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return 0;
+    }
+
+    unsigned long long mask = 0;
+    int first = 0;
+    int last = 0;
+    char separator = 0;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        separator = (char)fgetc(file);
+        if (separator == '-') {
+            if (fscanf(file, "%d", &last) != 1) {
+                break;
+            }
+            separator = (char)fgetc(file);
+        }
+        for (int cpu = first; cpu <= last && cpu < 64; ++cpu) {
+            mask |= 1ULL << cpu;
+        }
+        if (separator != ',') {
+            break;
+        }
+    }
+
+    fclose(file);
+    return mask;
+}
+
+static long bridge_read_cpu_value(int cpu, const char* attribute) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/%s", cpu, attribute);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    long value = -1;
+    if (fscanf(file, "%ld", &value) != 1) {
+        value = -1;
+    }
+    fclose(file);
+    return value;
+}
+#endif
+
+int whisper_bridge_detect_cpu_topology(int* out_logical_cpus, int* out_performance_cpus, int* out_efficiency_cpus,
+                                       unsigned long long* out_performance_mask) {
+    int logical = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int performance = logical;
+    int efficiency = 0;
+    unsigned long long performance_mask = 0;
+
+#ifdef __APPLE__
+    // perflevel0 = performance cores, perflevel1 = efficiency cores (Apple Silicon)
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname("hw.perflevel0.logicalcpu", &value, &size, NULL, 0) == 0) {
+        performance = value;
+        size = sizeof(value);
+        efficiency = sysctlbyname("hw.perflevel1.logicalcpu", &value, &size, NULL, 0) == 0 ? value : 0;
+    }
+#else
+    // Intel hybrid parts publish separate PMUs for P-cores and E-cores
+    unsigned long long core_mask = bridge_parse_cpu_list("/sys/devices/cpu_core/cpus");
+    unsigned long long atom_mask = bridge_parse_cpu_list("/sys/devices/cpu_atom/cpus");
+
+    if (core_mask != 0) {
+        performance_mask = core_mask;
+    } else {
+        // ARM big.LITTLE and others: highest cpu_capacity (or max frequency) marks the performance cores
+        const char* attribute = bridge_read_cpu_value(0, "cpu_capacity") >= 0 ? "cpu_capacity" : "cpufreq/cpuinfo_max_freq";
+        long best = -1;
+        for (int cpu = 0; cpu < logical && cpu < 64; ++cpu) {
+            long value = bridge_read_cpu_value(cpu, attribute);
+            if (value > best) {
+                best = value;
+                performance_mask = 0;
+            }
+            if (value == best) {
+                performance_mask |= 1ULL << cpu;
+            }
+        }
+        if (best < 0) {
+            performance_mask = logical >= 64 ? ~0ULL : ((1ULL << logical) - 1);
+        }
+    }
+
+    performance = __builtin_popcountll(performance_mask);
+    efficiency = atom_mask != 0 ? __builtin_popcountll(atom_mask) : logical - performance;
+#endif
+
+    if (out_logical_cpus) *out_logical_cpus = logical;
+    if (out_performance_cpus) *out_performance_cpus = performance;
+    if (out_efficiency_cpus) *out_efficiency_cpus = efficiency;
+    if (out_performance_mask) *out_performance_mask = performance_mask;
+
+    printf("🧠 CPU topology: %d logical, %d performance, %d efficiency (mask 0x%llx)\n",
+           logical, performance, efficiency, performance_mask);
+    return 0;
+}
+
+// v1.2.0 ENHANCEMENT: Worker placement configuration
+void whisper_bridge_configure_workers(int n_threads, unsigned long long core_mask, int nice_level, int qos, int reserved_core) {
+    int performance = 0;
+    unsigned long long performance_mask = 0;
+    whisper_bridge_detect_cpu_topology(NULL, &performance, NULL, &performance_mask);
+
+    unsigned long long mask = core_mask != 0 ? core_mask : performance_mask;
+    if (reserved_core >= 0 && reserved_core < 64) {
+        mask &= ~(1ULL << reserved_core);
+    }
+
+    int available = mask != 0 ? __builtin_popcountll(mask) : performance - (reserved_core >= 0 ? 1 : 0);
+    if (n_threads <= 0) {
+        n_threads = available > 0 ? available : 4;
+    }
+
+    bridge_worker_config config = { 1, n_threads, mask, nice_level, qos, reserved_core };
+    pthread_mutex_lock(&g_worker_config_lock);
+    g_worker_config = config;
+    pthread_mutex_unlock(&g_worker_config_lock);
+
+    printf("🧵 Whisper workers: %d threads, mask 0x%llx, nice %d, qos %d, reserved core %d\n",
+           n_threads, mask, nice_level, qos, reserved_core);
+}
+
+int whisper_bridge_pin_current_thread_to_core(int core) {
+#ifdef __APPLE__
+    // Apple Silicon has no hard affinity; interactive QoS keeps the thread on performance cores
+    (void)core;
+    return pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+    if (core < 0 || core >= CPU_SETSIZE) {
+        return -1;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+static bridge_worker_config bridge_get_worker_config(void) {
+    pthread_mutex_lock(&g_worker_config_lock);
+    bridge_worker_config config = g_worker_config;
+    pthread_mutex_unlock(&g_worker_config_lock);
+    return config;
+}
+
+typedef struct {
+    bridge_worker_config config;
+    struct whisper_context* ctx;
+    struct whisper_full_params params;
+    const float* samples;
+    int n_samples;
+    int result;
+} bridge_decode_job;
+
+// Places the calling thread for good: it only lives for one decode, so nothing is restored
+// (an unprivileged thread could not lower its nice level again anyway)
+static void bridge_place_current_thread(const bridge_worker_config* config) {
+#ifdef __APPLE__
+    // QoS is set through the thread attributes when the decode thread is created
+    (void)config;
+#else
+    if (config->core_mask != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64; ++cpu) {
+            if (config->core_mask & (1ULL << cpu)) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            printf("⚠️ Whisper workers: could not set core mask 0x%llx\n", config->core_mask);
+        }
+    }
+    if (config->nice_level != 0 &&
+        setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), config->nice_level) != 0) {
+        printf("⚠️ Whisper workers: could not set nice level %d\n", config->nice_level);
+    }
+#endif
+}
+
+static void* bridge_decode_thread(void* arg) {
+    bridge_decode_job* job = (bridge_decode_job*)arg;
+    bridge_place_current_thread(&job->config);
+    job->result = whisper_full(job->ctx, job->params, job->samples, job->n_samples);
+    return NULL;
+}
+
+// Runs whisper_full on a short-lived thread that carries the worker placement. ggml spawns its
+// workers from that thread, so they inherit its affinity, nice level and QoS class, while the
+// caller's thread (a GCD worker shared with other queues) is never modified.
+static int bridge_whisper_full(struct whisper_context* ctx, struct whisper_full_params params, const float* samples, int n_samples) {
+    bridge_decode_job job;
+    job.config = bridge_get_worker_config();
+    job.ctx = ctx;
+    job.params = params;
+    job.params.n_threads = job.config.n_threads;
+    job.samples = samples;
+    job.n_samples = n_samples;
+    job.result = -1;
+
+    if (!job.config.configured) {
+        return whisper_full(ctx, job.params, samples, n_samples);
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+#ifdef __APPLE__
+    qos_class_t target = QOS_CLASS_UNSPECIFIED;
+    switch (job.config.qos) {
+        case WHISPER_BRIDGE_QOS_USER_INTERACTIVE: target = QOS_CLASS_USER_INTERACTIVE; break;
+        case WHISPER_BRIDGE_QOS_USER_INITIATED:   target = QOS_CLASS_USER_INITIATED; break;
+        case WHISPER_BRIDGE_QOS_UTILITY:          target = QOS_CLASS_UTILITY; break;
+        default: break;
+    }
+    if (target != QOS_CLASS_UNSPECIFIED) {
+        pthread_attr_set_qos_class_np(&attr, target, 0);
+    }
+#endif
+
+    pthread_t thread;
+    int created = pthread_create(&thread, &attr, bridge_decode_thread, &job) == 0;
+    pthread_attr_destroy(&attr);
+    if (!created) {
+        printf("⚠️ Whisper workers: could not start decode thread, decoding unplaced\n");
+        return whisper_full(ctx, job.params, samples, n_samples);
+    }
+    pthread_join(thread, NULL);
+    return job.result;
+}
+
+// v1.2.0 ENHANCEMENT: Huge-page backing
+// ggml owns the model, KV and compute allocations, so instead of replacing its allocator the
+// bridge diffs /proc/self/maps around whisper init and advises the new anonymous regions.
+#ifdef __APPLE__
+static void bridge_collect_anonymous_regions(bridge_region_list* list) {
+    list->items = NULL;
+    list->count = 0;
+}
+
+static void bridge_advise_hugepages(const bridge_region_list* before, int mode, double* out_advised_mb, double* out_hugepage_mb) {
+    // Apple Silicon uses fixed 16 KB pages and superpages cannot be applied to existing mappings
+    (void)before;
+    (void)mode;
+    *out_advised_mb = 0.0;
+    *out_hugepage_mb = 0.0;
+    printf("⚠️ Huge pages: not supported on this platform\n");
+}
+#else
+static const unsigned long BRIDGE_HUGEPAGE_SIZE = 2UL * 1024 * 1024;
+
+static void bridge_collect_anonymous_regions(bridge_region_list* list) {
+    list->items = NULL;
+    list->count = 0;
+
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return;
+    }
+
+    int capacity = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), maps)) {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        char perms[8] = { 0 };
+        unsigned long offset = 0;
+        unsigned long inode = 1;
+        char device[16] = { 0 };
+        if (sscanf(line, "%lx-%lx %7s %lx %15s %lu", &start, &end, perms, &offset, device, &inode) != 6) {
+            continue;
+        }
+        // Private, writable, not file backed
+        if (inode != 0 || perms[0] != 'r' || perms[1] != 'w' || perms[3] != 'p' || strchr(line, '[')) {
+            continue;
+        }
+        if (list->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            bridge_region* items = (bridge_region*)realloc(list->items, (size_t)capacity * sizeof(bridge_region));
+            if (!items) {
+                break;
+            }
+            list->items = items;
+        }
+        list->items[list->count].start = start;
+        list->items[list->count].end = end;
+        list->count++;
+    }
+
+    fclose(maps);
+}
+
+static int bridge_region_existed(const bridge_region_list* before, const bridge_region* region) {
+    for (int i = 0; i < before->count; ++i) {
+        if (before->items[i].start == region->start && before->items[i].end == region->end) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Sums AnonHugePages over the given regions from /proc/self/smaps
+static double bridge_hugepage_backed_bytes(const bridge_region_list* regions) {
+    FILE* smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) {
+        return 0.0;
+    }
+
+    double total = 0.0;
+    int counting = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), smaps)) {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2 && strchr(line, '-') < strchr(line, ' ')) {
+            counting = 0;
+            // madvise splits the original mapping, so match any VMA inside an advised region
+            for (int i = 0; i < regions->count; ++i) {
+                if (start >= regions->items[i].start && end <= regions->items[i].end) {
+                    counting = 1;
+                    break;
+                }
+            }
+            continue;
+        }
+        unsigned long kb = 0;
+        if (counting && sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+            total += (double)kb * 1024.0;
+        }
+    }
+
+    fclose(smaps);
+    return total;
+}
+
+static void bridge_advise_hugepages(const bridge_region_list* before, int mode, double* out_advised_mb, double* out_hugepage_mb) {
+    *out_advised_mb = 0.0;
+    *out_hugepage_mb = 0.0;
+
+    bridge_region_list after = { NULL, 0 };
+    bridge_collect_anonymous_regions(&after);
+
+    bridge_region_list advised = { NULL, 0 };
+    advised.items = (bridge_region*)malloc((size_t)(after.count > 0 ? after.count : 1) * sizeof(bridge_region));
+    if (!advised.items) {
+        free(after.items);
+        return;
+    }
+
+    double advised_bytes = 0.0;
+    int collapse_failures = 0;
+    for (int i = 0; i < after.count; ++i) {
+        const bridge_region* region = &after.items[i];
+        if (region->end - region->start < BRIDGE_HUGEPAGE_SIZE || bridge_region_existed(before, region)) {
+            continue;
+        }
+
+        // Only whole 2 MB extents inside the region can be promoted
+        unsigned long start = (region->start + BRIDGE_HUGEPAGE_SIZE - 1) & ~(BRIDGE_HUGEPAGE_SIZE - 1);
+        unsigned long end = region->end & ~(BRIDGE_HUGEPAGE_SIZE - 1);
+        if (end <= start) {
+            continue;
+        }
+
+        if (madvise((void*)start, end - start, MADV_HUGEPAGE) != 0) {
+            continue;
+        }
+        if (mode == WHISPER_BRIDGE_HUGEPAGES_COLLAPSE && madvise((void*)start, end - start, MADV_COLLAPSE) != 0) {
+            collapse_failures++;
+        }
+
+        advised.items[advised.count++] = *region;
+        advised_bytes += (double)(end - start);
+    }
+
+    double hugepage_bytes = bridge_hugepage_backed_bytes(&advised);
+    *out_advised_mb = advised_bytes / (1024.0 * 1024.0);
+    *out_hugepage_mb = hugepage_bytes / (1024.0 * 1024.0);
+
+    printf("🗺️ Huge pages: advised %.1fMB in %d regions, %.1fMB huge-page backed%s\n",
+           *out_advised_mb, advised.count, *out_hugepage_mb,
+           collapse_failures ? " (some collapses failed - check transparent_hugepage settings)" : "");
+
+    free(advised.items);
+    free(after.items);
+}
+#endif
+
+// v1.2.0 ENHANCEMENT: Adaptive chunk-length controller
+#define CHUNK_CONTROLLER_RTF_SMOOTHING 0.2f   // EWMA weight of the newest measurement
+#define CHUNK_CONTROLLER_HEADROOM 0.6f        // shrink only while RTF stays below 60% of target
+#define CHUNK_CONTROLLER_SHRINK 0.9f
+#define CHUNK_CONTROLLER_GROW 1.2f
+#define CHUNK_CONTROLLER_COOLDOWN 2           // measurements between two adjustments
+
+struct whisper_bridge_chunk_controller {
+    pthread_mutex_t mutex;
+    float min_chunk;
+    float max_chunk;
+    float min_overlap;
+    float max_overlap;
+    float target_rtf;
+
+    float rtf;                // smoothed decode time / audio time, including overlap
+    int measurements;
+    int since_adjustment;
+    atomic_int queue_depth;   // chunks queued but not yet decoded
+
+    _Atomic float chunk_seconds;
+    _Atomic float overlap_seconds;
+};
+
+static float bridge_clampf(float value, float low, float high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+struct whisper_bridge_chunk_controller* whisper_bridge_chunk_controller_create(float min_chunk_seconds, float max_chunk_seconds,
+                                                                               float initial_chunk_seconds, float min_overlap_seconds,
+                                                                               float max_overlap_seconds, float target_rtf) {
+    if (min_chunk_seconds <= 0.0f || max_chunk_seconds < min_chunk_seconds ||
+        min_overlap_seconds < 0.0f || max_overlap_seconds < min_overlap_seconds || target_rtf <= 0.0f) {
+        printf("❌ Chunk controller: Invalid bounds\n");
+        return NULL;
+    }
+
+    struct whisper_bridge_chunk_controller* controller =
+        (struct whisper_bridge_chunk_controller*)calloc(1, sizeof(struct whisper_bridge_chunk_controller));
+    if (!controller) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&controller->mutex, NULL);
+    controller->min_chunk = min_chunk_seconds;
+    controller->max_chunk = max_chunk_seconds;
+    controller->min_overlap = min_overlap_seconds;
+    controller->max_overlap = max_overlap_seconds;
+    controller->target_rtf = target_rtf;
+    atomic_init(&controller->queue_depth, 0);
+    atomic_init(&controller->chunk_seconds, bridge_clampf(initial_chunk_seconds, min_chunk_seconds, max_chunk_seconds));
+    atomic_init(&controller->overlap_seconds, min_overlap_seconds);
+    return controller;
+}
+
+void whisper_bridge_chunk_controller_free(struct whisper_bridge_chunk_controller* controller) {
+    if (controller) {
+        pthread_mutex_destroy(&controller->mutex);
+        free(controller);
+    }
+}
+
+void whisper_bridge_chunk_controller_chunk_queued(struct whisper_bridge_chunk_controller* controller) {
+    if (controller) {
+        atomic_fetch_add(&controller->queue_depth, 1);
+    }
+}
+
+// Takes one chunk off the queue count, never below zero. Returns the depth left behind.
+static int chunk_controller_dequeue(struct whisper_bridge_chunk_controller* controller) {
+    int depth = atomic_load(&controller->queue_depth);
+    while (depth > 0 && !atomic_compare_exchange_weak(&controller->queue_depth, &depth, depth - 1)) {
+    }
+    return depth > 0 ? depth - 1 : 0;
+}
+
+void whisper_bridge_chunk_controller_chunk_dropped(struct whisper_bridge_chunk_controller* controller) {
+    if (controller) {
+        chunk_controller_dequeue(controller);
+    }
+}
+
+void whisper_bridge_chunk_controller_record(struct whisper_bridge_chunk_controller* controller, float audio_seconds, float decode_seconds) {
+    if (!controller) {
+        return;
+    }
+
+    int depth = chunk_controller_dequeue(controller);
+    if (audio_seconds <= 0.0f) {
+        return;
+    }
+
+    pthread_mutex_lock(&controller->mutex);
+
+    float sample = decode_seconds / audio_seconds;
+    controller->rtf = controller->measurements == 0
+        ? sample
+        : controller->rtf + CHUNK_CONTROLLER_RTF_SMOOTHING * (sample - controller->rtf);
+    controller->measurements++;
+    controller->since_adjustment++;
+
+    float chunk = atomic_load(&controller->chunk_seconds);
+    float overlap = atomic_load(&controller->overlap_seconds);
+
+    // Real-time load: every chunk re-decodes its overlap, so effective cost per new second is
+    // rtf * chunk / (chunk - overlap). A growing queue means we already fell behind.
+    float advance = chunk - overlap > 0.1f ? chunk - overlap : 0.1f;
+    float load = controller->rtf * chunk / advance;
+
+    if (controller->since_adjustment >= CHUNK_CONTROLLER_COOLDOWN) {
+        if (depth > 1 || load > controller->target_rtf) {
+            chunk = bridge_clampf(chunk * CHUNK_CONTROLLER_GROW, controller->min_chunk, controller->max_chunk);
+            controller->since_adjustment = 0;
+        } else if (depth == 0 && load < controller->target_rtf * CHUNK_CONTROLLER_HEADROOM) {
+            chunk = bridge_clampf(chunk * CHUNK_CONTROLLER_SHRINK, controller->min_chunk, controller->max_chunk);
+            controller->since_adjustment = 0;
+        }
+    }
+
+    // Spend headroom on overlap (better word boundaries), never more than half the chunk
+    float headroom = bridge_clampf(1.0f - load / controller->target_rtf, 0.0f, 1.0f);
+    overlap = controller->min_overlap + (controller->max_overlap - controller->min_overlap) * headroom;
+    overlap = bridge_clampf(overlap, controller->min_overlap, chunk * 0.5f);
+
+    atomic_store(&controller->chunk_seconds, chunk);
+    atomic_store(&controller->overlap_seconds, overlap);
+
+    pthread_mutex_unlock(&controller->mutex);
+}
+
+float whisper_bridge_chunk_controller_chunk_seconds(struct whisper_bridge_chunk_controller* controller) {
+    return controller ? atomic_load(&controller->chunk_seconds) : 0.0f;
+}
+
+float whisper_bridge_chunk_controller_overlap_seconds(struct whisper_bridge_chunk_controller* controller) {
+    return controller ? atomic_load(&controller->overlap_seconds) : 0.0f;
+}
+
+float whisper_bridge_chunk_controller_rtf(struct whisper_bridge_chunk_controller* controller) {
+    if (!controller) {
+        return 0.0f;
+    }
+    pthread_mutex_lock(&controller->mutex);
+    float rtf = controller->rtf;
+    pthread_mutex_unlock(&controller->mutex);
+    return rtf;
+}
+
+int whisper_bridge_chunk_controller_queue_depth(struct whisper_bridge_chunk_controller* controller) {
+    return controller ? atomic_load(&controller->queue_depth) : 0;
+}
+
+// v1.2.0 ENHANCEMENT: LocalAgreement-n streaming stabilization
+#define STREAM_MAX_TOKENS 448        // whisper text context limit per window
+#define STREAM_MAX_AGREEMENT 8
+#define STREAM_HISTORY_TOKENS 64     // committed tail kept for alignment and as decoder prompt
+#define STREAM_MAX_OVERLAP_TOKENS 8  // re-decoded committed tokens stripped from a new hypothesis
+#define STREAM_OVERLAP_WINDOW_CS 100 // ...only while they sit in the first second of the window
+
+struct whisper_bridge_stream {
+    int agreement_n;
+    int max_window_samples;
+
+    float* audio;
+    int audio_len;
+    int audio_cap;
+
+    whisper_token history[STREAM_HISTORY_TOKENS];
+    int history_len;
+
+    // Previous N-1 hypotheses, already stripped of committed tokens
+    whisper_token hyps[STREAM_MAX_AGREEMENT - 1][STREAM_MAX_TOKENS];
+    int hyp_len[STREAM_MAX_AGREEMENT - 1];
+    int n_hyps;
+
+    whisper_token committed[2 * STREAM_MAX_TOKENS];
+    int committed_len;
+    whisper_token tentative[STREAM_MAX_TOKENS];
+    int tentative_len;
+};
+
+struct whisper_bridge_stream* whisper_bridge_stream_create(int agreement_n, float max_window_seconds) {
+    if (agreement_n < 1 || agreement_n > STREAM_MAX_AGREEMENT || max_window_seconds <= 1.0f || max_window_seconds > 30.0f) {
+        printf("❌ Stream: Invalid agreement (%d) or window (%.1fs)\n", agreement_n, max_window_seconds);
+        return NULL;
+    }
+
+    struct whisper_bridge_stream* stream = (struct whisper_bridge_stream*)calloc(1, sizeof(struct whisper_bridge_stream));
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->agreement_n = agreement_n;
+    stream->max_window_samples = (int)(max_window_seconds * WHISPER_SAMPLE_RATE);
+    stream->audio_cap = stream->max_window_samples + WHISPER_SAMPLE_RATE * 10;
+    stream->audio = (float*)malloc((size_t)stream->audio_cap * sizeof(float));
+    if (!stream->audio) {
+        free(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+void whisper_bridge_stream_free(struct whisper_bridge_stream* stream) {
+    if (stream) {
+        free(stream->audio);
+        free(stream);
+    }
+}
+
+void whisper_bridge_stream_reset(struct whisper_bridge_stream* stream) {
+    if (!stream) {
+        return;
+    }
+    stream->audio_len = 0;
+    stream->history_len = 0;
+    stream->n_hyps = 0;
+    stream->committed_len = 0;
+    stream->tentative_len = 0;
+}
+
+int whisper_bridge_stream_push_audio(struct whisper_bridge_stream* stream, const float* samples, int n_samples) {
+    if (!stream || !samples || n_samples <= 0) {
+        return -1;
+    }
+
+    if (stream->audio_len + n_samples > stream->audio_cap) {
+        // Decoding fell far behind; drop the oldest audio rather than grow without bound
+        int drop = stream->audio_len + n_samples - stream->audio_cap;
+        if (drop >= stream->audio_len) {
+            stream->audio_len = 0;
+            if (n_samples > stream->audio_cap) {
+                samples += n_samples - stream->audio_cap;
+                n_samples = stream->audio_cap;
+            }
+        } else {
+            memmove(stream->audio, stream->audio + drop, (size_t)(stream->audio_len - drop) * sizeof(float));
+            stream->audio_len -= drop;
+        }
+        stream->n_hyps = 0;
+        printf("⚠️ Stream: Window overflow, dropped %d samples\n", drop);
+    }
+
+    memcpy(stream->audio + stream->audio_len, samples, (size_t)n_samples * sizeof(float));
+    stream->audio_len += n_samples;
+    return 0;
+}
+
+float whisper_bridge_stream_window_seconds(struct whisper_bridge_stream* stream) {
+    return stream ? (float)stream->audio_len / (float)WHISPER_SAMPLE_RATE : 0.0f;
+}
+
+static char* bridge_tokens_to_text(struct whisper_context* ctx, const whisper_token* tokens, int n_tokens) {
+    size_t len = 0;
+    for (int i = 0; i < n_tokens; ++i) {
+        const char* piece = whisper_token_to_str(ctx, tokens[i]);
+        len += piece ? strlen(piece) : 0;
+    }
+
+    char* text = (char*)malloc(len + 1);
+    if (!text) {
+        return NULL;
+    }
+
+    size_t offset = 0;
+    for (int i = 0; i < n_tokens; ++i) {
+        const char* piece = whisper_token_to_str(ctx, tokens[i]);
+        if (piece) {
+            size_t piece_len = strlen(piece);
+            memcpy(text + offset, piece, piece_len);
+            offset += piece_len;
+        }
+    }
+    text[offset] = '\0';
+    return text;
+}
+
+// Byte-level BPE can split a UTF-8 character across tokens; never commit half of one
+static int bridge_utf8_complete(struct whisper_context* ctx, const whisper_token* tokens, int n_tokens) {
+    char* text = bridge_tokens_to_text(ctx, tokens, n_tokens);
+    if (!text) {
+        return 1;
+    }
+
+    size_t len = strlen(text);
+    int complete = 1;
+    for (size_t back = 1; back <= 4 && back <= len; ++back) {
+        unsigned char c = (unsigned char)text[len - back];
+        if ((c & 0xC0) == 0x80) {
+            continue; // continuation byte, keep looking for the lead byte
+        }
+        size_t expected = (c & 0x80) == 0 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : 4;
+        complete = back >= expected;
+        break;
+    }
+
+    free(text);
+    return complete;
+}
+
+static void bridge_stream_commit(struct whisper_bridge_stream* stream, const whisper_token* tokens, int n_tokens) {
+    for (int i = 0; i < n_tokens; ++i) {
+        if (stream->committed_len < 2 * STREAM_MAX_TOKENS) {
+            stream->committed[stream->committed_len++] = tokens[i];
+        }
+        if (stream->history_len == STREAM_HISTORY_TOKENS) {
+            memmove(stream->history, stream->history + 1, (STREAM_HISTORY_TOKENS - 1) * sizeof(whisper_token));
+            stream->history_len--;
+        }
+        stream->history[stream->history_len++] = tokens[i];
+    }
+}
+
+static void bridge_stream_trim_audio(struct whisper_bridge_stream* stream, int64_t end_cs) {
+    int trim = (int)(end_cs * (WHISPER_SAMPLE_RATE / 100));
+    if (trim <= 0) {
+        return;
+    }
+    if (trim >= stream->audio_len) {
+        stream->audio_len = 0;
+        return;
+    }
+    memmove(stream->audio, stream->audio + trim, (size_t)(stream->audio_len - trim) * sizeof(float));
+    stream->audio_len -= trim;
+}
+
+static void bridge_stream_output_text(struct whisper_context* ctx, const whisper_token* tokens, int n_tokens, char** out_text) {
+    if (out_text) {
+        *out_text = bridge_tokens_to_text(ctx, tokens, n_tokens);
+    }
+}
+
+int whisper_bridge_stream_decode(struct whisper_context* ctx, struct whisper_bridge_stream* stream, const char* language,
+                                 char** out_committed_text, char** out_tentative_text) {
+    if (out_committed_text) *out_committed_text = NULL;
+    if (out_tentative_text) *out_tentative_text = NULL;
+    if (!ctx || !stream) {
+        return -1;
+    }
+
+    stream->committed_len = 0;
+    if (stream->audio_len == 0) {
+        stream->tentative_len = 0;
+        return 0;
+    }
+
+    struct whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    wparams.language = language ? language : "en";
+    wparams.translate = false;
+    wparams.print_realtime = false;
+    wparams.print_progress = false;
+    wparams.print_timestamps = false;
+    wparams.print_special = false;
+    wparams.no_context = true;
+    wparams.single_segment = false;
+    wparams.suppress_blank = true;
+    wparams.token_timestamps = true;                 // token end times drive audio trimming
+    wparams.prompt_tokens = stream->history;         // committed tail keeps the decoder consistent
+    wparams.prompt_n_tokens = stream->history_len;
+
+    int transcription_result = bridge_whisper_full(ctx, wparams, stream->audio, stream->audio_len);
+
+    if (transcription_result != 0) {
+        printf("❌ Stream: Transcription failed with code %d\n", transcription_result);
+        return -2;
+    }
+
+    // Collect text tokens (everything from EOT upward is special or a timestamp)
+    whisper_token hyp[STREAM_MAX_TOKENS];
+    int64_t hyp_end[STREAM_MAX_TOKENS];
+    int n_hyp = 0;
+    whisper_token eot = whisper_token_eot(ctx);
+    int n_segments = whisper_full_n_segments(ctx);
+    for (int s = 0; s < n_segments && n_hyp < STREAM_MAX_TOKENS; ++s) {
+        int n_tokens = whisper_full_n_tokens(ctx, s);
+        for (int t = 0; t < n_tokens && n_hyp < STREAM_MAX_TOKENS; ++t) {
+            whisper_token_data data = whisper_full_get_token_data(ctx, s, t);
+            if (data.id >= eot) {
+                continue;
+            }
+            hyp[n_hyp] = data.id;
+            hyp_end[n_hyp] = data.t1;
+            n_hyp++;
+        }
+    }
+
+    // The window starts at the last commit boundary, so its first tokens may re-decode the
+    // committed tail. Strip the longest committed suffix that matches the hypothesis prefix.
+    int overlap = 0;
+    int max_overlap = stream->history_len < n_hyp ? stream->history_len : n_hyp;
+    if (max_overlap > STREAM_MAX_OVERLAP_TOKENS) max_overlap = STREAM_MAX_OVERLAP_TOKENS;
+    for (int k = max_overlap; k > 0; --k) {
+        if (hyp_end[k - 1] > STREAM_OVERLAP_WINDOW_CS) {
+            continue;
+        }
+        if (memcmp(stream->history + stream->history_len - k, hyp, (size_t)k * sizeof(whisper_token)) == 0) {
+            overlap = k;
+            break;
+        }
+    }
+    const whisper_token* current = hyp + overlap;
+    const int64_t* current_end = hyp_end + overlap;
+    int n_current = n_hyp - overlap;
+
+    // Longest prefix shared by the previous N-1 hypotheses and this one
+    int agreed = 0;
+    if (stream->n_hyps + 1 >= stream->agreement_n) {
+        agreed = n_current;
+        for (int h = stream->n_hyps - (stream->agreement_n - 1); h < stream->n_hyps; ++h) {
+            int lcp = 0;
+            while (lcp < agreed && lcp < stream->hyp_len[h] && stream->hyps[h][lcp] == current[lcp]) {
+                lcp++;
+            }
+            agreed = lcp;
+        }
+        while (agreed > 0 && !bridge_utf8_complete(ctx, current, agreed)) {
+            agreed--;
+        }
+    }
+
+    int force_commit = stream->audio_len >= stream->max_window_samples;
+    int n_commit = force_commit ? n_current : agreed;
+    if (force_commit && n_current > 0 && !bridge_utf8_complete(ctx, current, n_commit)) {
+        n_commit = agreed;
+    }
+
+    if (n_commit > 0) {
+        bridge_stream_commit(stream, current, n_commit);
+        bridge_stream_trim_audio(stream, current_end[n_commit - 1]);
+    } else if (force_commit) {
+        // Nothing decodable in a full window: keep only the most recent second
+        bridge_stream_trim_audio(stream, (int64_t)(stream->audio_len - WHISPER_SAMPLE_RATE) * 100 / WHISPER_SAMPLE_RATE);
+    }
+
+    // Previous hypotheses share the committed prefix by construction; drop it from each
+    for (int h = 0; h < stream->n_hyps; ++h) {
+        int drop = n_commit < stream->hyp_len[h] ? n_commit : stream->hyp_len[h];
+        memmove(stream->hyps[h], stream->hyps[h] + drop, (size_t)(stream->hyp_len[h] - drop) * sizeof(whisper_token));
+        stream->hyp_len[h] -= drop;
+    }
+
+    stream->tentative_len = n_current - n_commit;
+    memcpy(stream->tentative, current + n_commit, (size_t)stream->tentative_len * sizeof(whisper_token));
+
+    if (force_commit || stream->agreement_n == 1) {
+        stream->n_hyps = 0;
+    } else {
+        if (stream->n_hyps == stream->agreement_n - 1) {
+            memmove(stream->hyps[0], stream->hyps[1], (size_t)(stream->n_hyps - 1) * sizeof(stream->hyps[0]));
+            memmove(stream->hyp_len, stream->hyp_len + 1, (size_t)(stream->n_hyps - 1) * sizeof(int));
+            stream->n_hyps--;
+        }
+        memcpy(stream->hyps[stream->n_hyps], stream->tentative, (size_t)stream->tentative_len * sizeof(whisper_token));
+        stream->hyp_len[stream->n_hyps] = stream->tentative_len;
+        stream->n_hyps++;
+    }
+
+    bridge_stream_output_text(ctx, stream->committed, stream->committed_len, out_committed_text);
+    bridge_stream_output_text(ctx, stream->tentative, stream->tentative_len, out_tentative_text);
+    return stream->committed_len;
+}
+
+int whisper_bridge_stream_flush(struct whisper_context* ctx, struct whisper_bridge_stream* stream, char** out_committed_text) {
+    if (out_committed_text) *out_committed_text = NULL;
+    if (!ctx || !stream) {
+        return -1;
+    }
+
+    stream->committed_len = 0;
+    bridge_stream_commit(stream, stream->tentative, stream->tentative_len);
+    bridge_stream_output_text(ctx, stream->committed, stream->committed_len, out_committed_text);
+
+    stream->tentative_len = 0;
+    stream->n_hyps = 0;
+    stream->audio_len = 0;
+    return stream->committed_len;
+}
+
+int whisper_bridge_stream_get_committed_tokens(struct whisper_bridge_stream* stream, int* out_tokens, int max_tokens) {
+    if (!stream || !out_tokens || max_tokens <= 0) {
+        return 0;
+    }
+    int n = stream->committed_len < max_tokens ? stream->committed_len : max_tokens;
+    for (int i = 0; i < n; ++i) {
+        out_tokens[i] = stream->committed[i];
+    }
+    return n;
+}
+
+int whisper_bridge_stream_get_tentative_tokens(struct whisper_bridge_stream* stream, int* out_tokens, int max_tokens) {
+    if (!stream || !out_tokens || max_tokens <= 0) {
+        return 0;
+    }
+    int n = stream->tentative_len < max_tokens ? stream->tentative_len : max_tokens;
+    for (int i = 0; i < n; ++i) {
+        out_tokens[i] = stream->tentative[i];
+    }
+    return n;
+}
+
+void whisper_bridge_free_text(char* text) {
+    free(text);
+}
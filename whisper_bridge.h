@@ -17,8 +17,21 @@ typedef struct {
     float* segment_ends;
 } whisper_timestamped_result;
 
+// v1.2.0 ENHANCEMENT: Huge-page backing for model tensors, KV cache and compute buffers
+enum whisper_bridge_hugepage_mode {
+    WHISPER_BRIDGE_HUGEPAGES_OFF = 0,
+    WHISPER_BRIDGE_HUGEPAGES_TRANSPARENT = 1,  // madvise(MADV_HUGEPAGE), collapsed in the background by khugepaged
+    WHISPER_BRIDGE_HUGEPAGES_COLLAPSE = 2      // additionally MADV_COLLAPSE, backs the buffers synchronously at init
+};
+
 // Simple C interface for Swift to use - renamed to avoid conflicts
 struct whisper_context* whisper_bridge_init_context(const char* model_path);
+
+// Initializes a context and advises every buffer whisper allocated during init to use huge pages.
+// out_advised_mb receives the size of the advised regions, out_hugepage_mb how much of it is
+// actually huge-page backed (both 0 when the platform does not support it).
+struct whisper_context* whisper_bridge_init_context_with_hugepages(const char* model_path, int hugepage_mode,
+                                                                   double* out_advised_mb, double* out_hugepage_mb);
 void whisper_bridge_free_context(struct whisper_context* ctx);
 char* whisper_bridge_transcribe(struct whisper_context* ctx, const float* samples, int n_samples);
 char* whisper_bridge_transcribe_with_language(struct whisper_context* ctx, const float* samples, int n_samples, const char* language);
@@ -28,6 +41,107 @@ whisper_timestamped_result* whisper_bridge_transcribe_with_timestamps(struct whi
 void whisper_bridge_free_timestamped_result(whisper_timestamped_result* result);
 char* whisper_bridge_get_segment_text(struct whisper_context* ctx, int segment_index);
 
+// v1.2.0 ENHANCEMENT: Quantized model support (q5_0 / q5_1 / q8_0 ggml variants)
+// Returns the ggml file type of the loaded weights (0 = f32, 1 = f16, 7 = q8_0, 8 = q5_0, 9 = q5_1)
+int whisper_bridge_get_model_ftype(struct whisper_context* ctx);
+const char* whisper_bridge_get_model_ftype_name(struct whisper_context* ctx);
+
+// v1.2.0 ENHANCEMENT: On-device speed/accuracy calibration
+// Loads model_path into a fresh context, transcribes the clip once and reports
+// real-time factor (decode time / audio time), peak resident memory in MB and
+// word error rate against reference_text (-1 when no reference is given).
+// Returns 0 on success, non-zero if the model could not be loaded or decoded.
+// hugepage_mode selects the allocation mode (enum whisper_bridge_hugepage_mode) so the same clip
+// can be replayed with and without huge pages to compare decode throughput.
+int whisper_bridge_calibrate_model(const char* model_path, const float* samples, int n_samples, const char* language,
+                                   const char* reference_text, int hugepage_mode, float* out_rtf, double* out_peak_memory_mb,
+                                   float* out_wer, int* out_ftype, double* out_hugepage_mb);
+float whisper_bridge_word_error_rate(const char* reference_text, const char* hypothesis_text);
+
+// v1.2.0 ENHANCEMENT: Decode throughput replay for comparing huge-page modes
+// Loads model_path once with hugepage_mode, decodes the clip once to warm up, then `iterations`
+// more times. Reports decoded audio seconds per wall-clock second (higher is faster) and how
+// much of the advised memory ended up huge-page backed. Returns 0 on success.
+int whisper_bridge_replay_benchmark(const char* model_path, const float* samples, int n_samples, const char* language,
+                                    int hugepage_mode, int iterations, double* out_throughput, double* out_hugepage_mb);
+
+// v1.2.0 ENHANCEMENT: Inference worker placement (core affinity and priority)
+enum whisper_bridge_qos {
+    WHISPER_BRIDGE_QOS_UNCHANGED = 0,
+    WHISPER_BRIDGE_QOS_USER_INTERACTIVE = 1,
+    WHISPER_BRIDGE_QOS_USER_INITIATED = 2,
+    WHISPER_BRIDGE_QOS_UTILITY = 3
+};
+
+// Detected CPU topology. On Linux the performance core set is returned as a bit mask
+// (bit N = logical CPU N); macOS does not expose core IDs, so the mask is 0 there.
+int whisper_bridge_detect_cpu_topology(int* out_logical_cpus, int* out_performance_cpus, int* out_efficiency_cpus,
+                                       unsigned long long* out_performance_mask);
+
+// Worker configuration for every whisper_full call. Once configured, each decode runs on a
+// short-lived thread created with this placement; ggml spawns its workers from that thread, so
+// they inherit its affinity, nice level and QoS class. The calling thread is left untouched.
+// Safe to call while decodes are running; it applies from the next decode on.
+//   n_threads     0 = one per core in the mask (default 4 when nothing is configured)
+//   core_mask     0 = detected performance cores; bit N = logical CPU N (Linux only)
+//   nice_level    applied per decode thread with setpriority on Linux, 0 = unchanged
+//   qos           enum whisper_bridge_qos, macOS QoS class steering toward performance cores
+//   reserved_core logical CPU kept free for the audio capture thread (pin it there with
+//                 whisper_bridge_pin_current_thread_to_core), -1 = none. macOS cannot address
+//                 cores, so there it only takes one core out of the worker count.
+void whisper_bridge_configure_workers(int n_threads, unsigned long long core_mask, int nice_level, int qos, int reserved_core);
+
+// Pin the calling thread (e.g. the audio capture thread) to a single core. Returns 0 on success.
+int whisper_bridge_pin_current_thread_to_core(int core);
+
+// v1.2.0 ENHANCEMENT: Adaptive chunk-length controller driven by measured real-time factor
+// One controller per audio stream. Chunks shrink while decoding has headroom and grow when it
+// falls behind (longer chunks amortize Whisper's fixed per-call cost); overlap follows headroom.
+struct whisper_bridge_chunk_controller;
+
+struct whisper_bridge_chunk_controller* whisper_bridge_chunk_controller_create(float min_chunk_seconds, float max_chunk_seconds,
+                                                                               float initial_chunk_seconds, float min_overlap_seconds,
+                                                                               float max_overlap_seconds, float target_rtf);
+void whisper_bridge_chunk_controller_free(struct whisper_bridge_chunk_controller* controller);
+
+// Call when a chunk is queued for decoding, then record it once decoded, or report it dropped
+// if it never reaches the decoder. Every queued chunk needs one of the two. Thread safe.
+void whisper_bridge_chunk_controller_chunk_queued(struct whisper_bridge_chunk_controller* controller);
+void whisper_bridge_chunk_controller_chunk_dropped(struct whisper_bridge_chunk_controller* controller);
+void whisper_bridge_chunk_controller_record(struct whisper_bridge_chunk_controller* controller, float audio_seconds, float decode_seconds);
+
+float whisper_bridge_chunk_controller_chunk_seconds(struct whisper_bridge_chunk_controller* controller);
+float whisper_bridge_chunk_controller_overlap_seconds(struct whisper_bridge_chunk_controller* controller);
+float whisper_bridge_chunk_controller_rtf(struct whisper_bridge_chunk_controller* controller);
+int whisper_bridge_chunk_controller_queue_depth(struct whisper_bridge_chunk_controller* controller);
+
+// v1.2.0 ENHANCEMENT: LocalAgreement-n stabilization of streaming hypotheses
+// A stream owns the audio that has not been committed yet. Every decode re-transcribes that
+// window; a token prefix is committed once it agrees across N consecutive hypotheses, and the
+// audio up to the last committed token is dropped. Committed text is final and never revised.
+struct whisper_bridge_stream;
+
+struct whisper_bridge_stream* whisper_bridge_stream_create(int agreement_n, float max_window_seconds);
+void whisper_bridge_stream_free(struct whisper_bridge_stream* stream);
+void whisper_bridge_stream_reset(struct whisper_bridge_stream* stream);
+
+int whisper_bridge_stream_push_audio(struct whisper_bridge_stream* stream, const float* samples, int n_samples);
+float whisper_bridge_stream_window_seconds(struct whisper_bridge_stream* stream);
+
+// Decodes the current window. Returns the number of newly committed tokens (< 0 on error).
+// Text outputs are optional, malloc'd and must be released with whisper_bridge_free_text.
+int whisper_bridge_stream_decode(struct whisper_context* ctx, struct whisper_bridge_stream* stream, const char* language,
+                                 char** out_committed_text, char** out_tentative_text);
+
+// Commits whatever is tentative (e.g. at a pause) and clears the window.
+int whisper_bridge_stream_flush(struct whisper_context* ctx, struct whisper_bridge_stream* stream, char** out_committed_text);
+
+// Token IDs committed by the last decode/flush and the current tentative tail. Return the count copied.
+int whisper_bridge_stream_get_committed_tokens(struct whisper_bridge_stream* stream, int* out_tokens, int max_tokens);
+int whisper_bridge_stream_get_tentative_tokens(struct whisper_bridge_stream* stream, int* out_tokens, int max_tokens);
+
+void whisper_bridge_free_text(char* text);
+
 #ifdef __cplusplus
 }
 #endif